@@ -130,6 +130,22 @@ MEM_STATIC unsigned BIT_endOfDStream(const BIT_DStream_t* bitD);
 */
 
 
+/*********************************************
+*  bitStream decompression API (read forward)
+*********************************************/
+MEM_STATIC void     BIT_reverseBytes(void* buffer, size_t size);
+MEM_STATIC size_t   BIT_initForwardDStream(BIT_DStream_t* bitD, const void* srcBuffer, size_t srcSize);
+MEM_STATIC BIT_DStream_status BIT_reloadForwardDStream(BIT_DStream_t* bitD);
+
+/*
+* A bitStream whose bytes have been reversed, using BIT_reverseBytes(), can be read front to back.
+* It shares BIT_DStream_t and all read functions with the backward reader :
+* only initialization and reload differ. BIT_endOfDStream() works for both directions.
+* Bytes located before bitD->ptr are never read again,
+* which makes it possible to overwrite them while decoding (in-place decompression).
+*/
+
+
 /******************************************
 *  unsafe API
 ******************************************/
@@ -377,6 +393,330 @@ MEM_STATIC unsigned BIT_endOfDStream(const BIT_DStream_t* DStream)
     return ((DStream->ptr == DStream->start) && (DStream->bitsConsumed == sizeof(DStream->bitContainer)*8));
 }
 
+
+/**********************************************************
+* bitStream forward decoding
+**********************************************************/
+
+/*! BIT_reverseBytes
+*   Reverses byte order of `buffer`, so that a bitStream can be read front to back.
+*/
+MEM_STATIC void BIT_reverseBytes(void* buffer, size_t size)
+{
+    BYTE* start = (BYTE*)buffer;
+    BYTE* end = start + size;
+
+    while ((size_t)(end-start) >= 2*sizeof(size_t))
+    {
+        size_t head, tail;
+        end -= sizeof(size_t);
+        head = MEM_readLEST(start);
+        tail = MEM_readLEST(end);
+        MEM_writeLEST(start, MEM_swapST(tail));
+        MEM_writeLEST(end, MEM_swapST(head));
+        start += sizeof(size_t);
+    }
+    while (end-start >= 2)
+    {
+        BYTE tmp;
+        end--;
+        tmp = *start;
+        *start++ = *end;
+        *end = tmp;
+    }
+}
+
+/*!BIT_initForwardDStream
+*  Same as BIT_initDStream(), for a bitStream which bytes have been reversed.
+*  In this mode, bitD->start is the last position bitD->ptr can reach.
+*  @result : size of stream (== srcSize) or an errorCode if a problem is detected
+*/
+MEM_STATIC size_t BIT_initForwardDStream(BIT_DStream_t* bitD, const void* srcBuffer, size_t srcSize)
+{
+    U32 contain32;
+
+    if (srcSize < 1) return ERROR(srcSize_wrong);
+
+    contain32 = *(const BYTE*)srcBuffer;
+    if (contain32 == 0) return ERROR(GENERIC);   /* endMark not present */
+    bitD->ptr = (const char*)srcBuffer;
+    bitD->bitsConsumed = 8 - BIT_highbit32(contain32);
+
+    if (srcSize >= sizeof(size_t))   /* normal case */
+    {
+        bitD->start = bitD->ptr + srcSize - sizeof(size_t);
+        bitD->bitContainer = MEM_readBEST(bitD->ptr);
+    }
+    else
+    {
+        size_t n;
+        bitD->start = bitD->ptr;
+        bitD->bitContainer = 0;
+        for (n=0; n<srcSize; n++)
+            bitD->bitContainer = (bitD->bitContainer << 8) + ((const BYTE*)srcBuffer)[n];
+        bitD->bitsConsumed += (U32)(sizeof(size_t) - srcSize)*8;
+    }
+
+    return srcSize;
+}
+
+MEM_STATIC BIT_DStream_status BIT_reloadForwardDStream(BIT_DStream_t* bitD)
+{
+    if (bitD->bitsConsumed > (sizeof(bitD->bitContainer)*8))  /* should never happen */
+        return BIT_DStream_overflow;
+
+    if ((size_t)(bitD->start - bitD->ptr) >= sizeof(bitD->bitContainer))
+    {
+        bitD->ptr += bitD->bitsConsumed >> 3;
+        bitD->bitsConsumed &= 7;
+        bitD->bitContainer = MEM_readBEST(bitD->ptr);
+        return BIT_DStream_unfinished;
+    }
+    if (bitD->ptr == bitD->start)
+    {
+        if (bitD->bitsConsumed < sizeof(bitD->bitContainer)*8) return BIT_DStream_endOfBuffer;
+        return BIT_DStream_completed;
+    }
+    {
+        U32 nbBytes = bitD->bitsConsumed >> 3;
+        BIT_DStream_status result = BIT_DStream_unfinished;
+        if ((size_t)(bitD->start - bitD->ptr) < nbBytes)
+        {
+            nbBytes = (U32)(bitD->start - bitD->ptr);  /* ptr < start */
+            result = BIT_DStream_endOfBuffer;
+        }
+        bitD->ptr += nbBytes;
+        bitD->bitsConsumed -= nbBytes*8;
+        bitD->bitContainer = MEM_readBEST(bitD->ptr);
+        return result;
+    }
+}
+
+/**********************************************************
+* bitStream with 128-bits containers
+**********************************************************/
+/*
+* Where the compiler provides a 128-bits integer type (BIT_128BITS==1),
+* BIT_CStream128_t and BIT_DStream128_t are alternatives to BIT_CStream_t and BIT_DStream_t.
+* They produce and read the same bitStream format : a stream written with either container can be read with either one.
+* After a flush, up to 121 bits can be added (57 with size_t on 64-bits),
+* and a reload guarantees a minimum of 121 bits when its result is BIT_DStream_unfinished.
+* A single value still carries at most 57 bits (it is a size_t).
+* BIT_initCStream128() requires a buffer of at least 16 bytes.
+* Note : 128-bits shifts cost several instructions each on current 64-bits targets.
+* Within FSE and Huff0 hot loops, it outweighs the saved flushes and reloads, so they keep using size_t containers.
+*/
+#if defined(__SIZEOF_INT128__) && !defined(BIT_NO_128BITS)
+#  define BIT_128BITS 1
+
+__extension__ typedef unsigned __int128 BIT_U128;
+
+typedef struct
+{
+    BIT_U128 bitContainer;
+    int    bitPos;
+    char*  startPtr;
+    char*  ptr;
+    char*  endPtr;
+} BIT_CStream128_t;
+
+typedef struct
+{
+    BIT_U128 bitContainer;
+    unsigned bitsConsumed;
+    const char* ptr;
+    const char* start;
+} BIT_DStream128_t;
+
+MEM_STATIC BIT_U128 BIT_readLE128(const void* memPtr)
+{
+    return ((BIT_U128)MEM_readLE64((const BYTE*)memPtr + 8) << 64) + MEM_readLE64(memPtr);
+}
+
+MEM_STATIC void BIT_writeLE128(void* memPtr, BIT_U128 val)
+{
+    MEM_writeLE64(memPtr, (U64)val);
+    MEM_writeLE64((BYTE*)memPtr + 8, (U64)(val >> 64));
+}
+
+MEM_STATIC size_t BIT_initCStream128(BIT_CStream128_t* bitC, void* startPtr, size_t maxSize)
+{
+    if (maxSize < sizeof(bitC->bitContainer)) return ERROR(dstSize_tooSmall);
+    bitC->bitContainer = 0;
+    bitC->bitPos = 0;
+    bitC->startPtr = (char*)startPtr;
+    bitC->ptr = bitC->startPtr;
+    bitC->endPtr = bitC->startPtr + maxSize - sizeof(bitC->bitContainer);
+    return 0;
+}
+
+/*! BIT_addBits128
+ *  nbBits must be <= 57 */
+MEM_STATIC void BIT_addBits128(BIT_CStream128_t* bitC, size_t value, unsigned nbBits)
+{
+    bitC->bitContainer |= (BIT_U128)(value & ((((size_t)1) << nbBits) - 1)) << bitC->bitPos;
+    bitC->bitPos += nbBits;
+}
+
+/*! BIT_addBitsFast128
+ *  works only if `value` is _clean_, meaning all high bits above nbBits are 0 */
+MEM_STATIC void BIT_addBitsFast128(BIT_CStream128_t* bitC, size_t value, unsigned nbBits)
+{
+    bitC->bitContainer |= (BIT_U128)value << bitC->bitPos;
+    bitC->bitPos += nbBits;
+}
+
+/*! BIT_flushBitsFast128
+ *  unsafe version; does not check buffer overflow */
+MEM_STATIC void BIT_flushBitsFast128(BIT_CStream128_t* bitC)
+{
+    size_t nbBytes = bitC->bitPos >> 3;
+    BIT_writeLE128(bitC->ptr, bitC->bitContainer);
+    bitC->ptr += nbBytes;
+    bitC->bitPos &= 7;
+    bitC->bitContainer >>= nbBytes*8;
+}
+
+MEM_STATIC void BIT_flushBits128(BIT_CStream128_t* bitC)
+{
+    size_t nbBytes = bitC->bitPos >> 3;
+    BIT_writeLE128(bitC->ptr, bitC->bitContainer);
+    bitC->ptr += nbBytes;
+    if (bitC->ptr > bitC->endPtr) bitC->ptr = bitC->endPtr;
+    bitC->bitPos &= 7;
+    bitC->bitContainer >>= nbBytes*8;
+}
+
+/*! BIT_closeCStream128
+ *  @result : size of CStream, in bytes, or 0 if it cannot fit into dstBuffer */
+MEM_STATIC size_t BIT_closeCStream128(BIT_CStream128_t* bitC)
+{
+    char* endPtr;
+
+    BIT_addBitsFast128(bitC, 1, 1);   /* endMark */
+    BIT_flushBits128(bitC);
+
+    if (bitC->ptr >= bitC->endPtr) /* too close to buffer's end */
+        return 0;   /* not storable */
+
+    endPtr = bitC->ptr;
+    endPtr += bitC->bitPos > 0;    /* remaining bits (incomplete byte) */
+
+    return (endPtr - bitC->startPtr);
+}
+
+/*!BIT_initDStream128
+*  Same as BIT_initDStream(), using a 128-bits container.
+*  @result : size of stream (== srcSize) or an errorCode if a problem is detected
+*/
+MEM_STATIC size_t BIT_initDStream128(BIT_DStream128_t* bitD, const void* srcBuffer, size_t srcSize)
+{
+    U32 contain32;
+
+    bitD->start = (const char*)srcBuffer;
+    bitD->ptr = bitD->start;
+    bitD->bitContainer = 0;
+    if (srcSize < 1) return ERROR(srcSize_wrong);
+
+    contain32 = ((const BYTE*)srcBuffer)[srcSize-1];
+    if (contain32 == 0) return ERROR(GENERIC);   /* endMark not present */
+    bitD->bitsConsumed = 8 - BIT_highbit32(contain32);
+
+    if (srcSize >= sizeof(bitD->bitContainer))   /* normal case */
+    {
+        bitD->ptr = bitD->start + srcSize - sizeof(bitD->bitContainer);
+        bitD->bitContainer = BIT_readLE128(bitD->ptr);
+    }
+    else
+    {
+        size_t n;
+        for (n=0; n<srcSize; n++)
+            bitD->bitContainer += (BIT_U128)(((const BYTE*)srcBuffer)[n]) << (n*8);
+        bitD->bitsConsumed += (U32)(sizeof(bitD->bitContainer) - srcSize)*8;
+    }
+
+    return srcSize;
+}
+
+/*! BIT_lookBits128
+ *  nbBits must be <= 57 */
+MEM_STATIC size_t BIT_lookBits128(const BIT_DStream128_t* bitD, U32 nbBits)
+{
+    const U32 bitMask = sizeof(bitD->bitContainer)*8 - 1;
+    return (size_t)(((bitD->bitContainer << (bitD->bitsConsumed & bitMask)) >> 1) >> ((bitMask-nbBits) & bitMask));
+}
+
+/*! BIT_lookBitsFast128 :
+*   unsafe version; only works only if nbBits >= 1 */
+MEM_STATIC size_t BIT_lookBitsFast128(const BIT_DStream128_t* bitD, U32 nbBits)
+{
+    const U32 bitMask = sizeof(bitD->bitContainer)*8 - 1;
+    return (size_t)((bitD->bitContainer << (bitD->bitsConsumed & bitMask)) >> (((bitMask+1)-nbBits) & bitMask));
+}
+
+MEM_STATIC void BIT_skipBits128(BIT_DStream128_t* bitD, U32 nbBits)
+{
+    bitD->bitsConsumed += nbBits;
+}
+
+MEM_STATIC size_t BIT_readBits128(BIT_DStream128_t* bitD, U32 nbBits)
+{
+    size_t value = BIT_lookBits128(bitD, nbBits);
+    BIT_skipBits128(bitD, nbBits);
+    return value;
+}
+
+/*! BIT_readBitsFast128 :
+*   unsafe version; only works only if nbBits >= 1 */
+MEM_STATIC size_t BIT_readBitsFast128(BIT_DStream128_t* bitD, U32 nbBits)
+{
+    size_t value = BIT_lookBitsFast128(bitD, nbBits);
+    BIT_skipBits128(bitD, nbBits);
+    return value;
+}
+
+MEM_STATIC BIT_DStream_status BIT_reloadDStream128(BIT_DStream128_t* bitD)
+{
+    if (bitD->bitsConsumed > (sizeof(bitD->bitContainer)*8))  /* should never happen */
+        return BIT_DStream_overflow;
+
+    if (bitD->ptr >= bitD->start + sizeof(bitD->bitContainer))
+    {
+        bitD->ptr -= bitD->bitsConsumed >> 3;
+        bitD->bitsConsumed &= 7;
+        bitD->bitContainer = BIT_readLE128(bitD->ptr);
+        return BIT_DStream_unfinished;
+    }
+    if (bitD->ptr == bitD->start)
+    {
+        if (bitD->bitsConsumed < sizeof(bitD->bitContainer)*8) return BIT_DStream_endOfBuffer;
+        return BIT_DStream_completed;
+    }
+    {
+        U32 nbBytes = bitD->bitsConsumed >> 3;
+        BIT_DStream_status result = BIT_DStream_unfinished;
+        if (bitD->ptr - nbBytes < bitD->start)
+        {
+            nbBytes = (U32)(bitD->ptr - bitD->start);  /* ptr > start */
+            result = BIT_DStream_endOfBuffer;
+        }
+        bitD->ptr -= nbBytes;
+        bitD->bitsConsumed -= nbBytes*8;
+        bitD->bitContainer = BIT_readLE128(bitD->ptr);   /* reminder : srcSize >= sizeof(bitD->bitContainer) */
+        return result;
+    }
+}
+
+MEM_STATIC unsigned BIT_endOfDStream128(const BIT_DStream128_t* DStream)
+{
+    return ((DStream->ptr == DStream->start) && (DStream->bitsConsumed == sizeof(DStream->bitContainer)*8));
+}
+
+#else
+#  define BIT_128BITS 0
+#endif   /* __SIZEOF_INT128__ */
+
+
 #if defined (__cplusplus)
 }
 #endif
@@ -0,0 +1,170 @@
+/* ******************************************************************
+   cpu.h
+   runtime detection of CPU features
+   Copyright (C) 2013-2015, Yann Collet.
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    You can contact the author at :
+    - FSE source repository : https://github.com/Cyan4973/FiniteStateEntropy
+    - Public forum : https://groups.google.com/forum/#!forum/lz4c
+****************************************************************** */
+#ifndef CPU_H_MODULE
+#define CPU_H_MODULE
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/******************************************
+*  Includes
+******************************************/
+#include "mem.h"     /* MEM_STATIC, U32 */
+
+
+/******************************************
+*  Tuning parameter
+******************************************/
+/* CPU_DYNAMIC_BMI2 :
+*  1 : hot loops are also compiled for BMI2 (shrx, bzhi, lzcnt), selected at runtime when the cpu supports them.
+*  0 : portable code only.
+*  Default : 1 on x86-64 with gcc >= 5 or clang, unless the whole build already targets BMI2 (-mbmi2, -march=haswell). */
+#ifndef CPU_DYNAMIC_BMI2
+#  if defined(__x86_64__) && ((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__)) && !defined(__BMI2__)
+#    define CPU_DYNAMIC_BMI2 1
+#  else
+#    define CPU_DYNAMIC_BMI2 0
+#  endif
+#endif
+
+#if CPU_DYNAMIC_BMI2
+#  define CPU_TARGET_BMI2 __attribute__((__target__("bmi,bmi2,lzcnt")))
+#else
+#  define CPU_TARGET_BMI2
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  define CPU_X86 1
+#  include <cpuid.h>   /* __get_cpuid, __cpuid_count */
+#else
+#  define CPU_X86 0
+#endif
+
+
+/******************************************
+*  Features detection
+******************************************/
+#define CPU_SSE42   (1U << 0)
+#define CPU_BMI2    (1U << 1)   /* BMI1, BMI2 and LZCNT */
+#define CPU_AVX2    (1U << 2)   /* AVX and AVX2, ymm registers saved by the OS */
+#define CPU_AVX512  (1U << 3)   /* AVX-512 F and BW, zmm registers saved by the OS */
+#define CPU_DETECTED (1U << 31)   /* internal : marks CPU_features() cache as valid */
+
+/*! CPU_detectFeatures() :
+*   queries cpuid (and xgetbv for register states enabled by the OS).
+*   @return : set of CPU_* flags supported by the running cpu (always 0 on non-x86 targets). */
+MEM_STATIC U32 CPU_detectFeatures(void)
+{
+#if CPU_X86
+    unsigned eax, ebx, ecx, edx;
+    unsigned maxLeaf = __get_cpuid_max(0, NULL);
+    U32 features = 0;
+    U32 avxState = 0, avx512State = 0;
+
+    if (maxLeaf < 1) return 0;
+    __cpuid(1, eax, ebx, ecx, edx);
+    if ((ecx >> 20) & 1) features |= CPU_SSE42;
+    if (((ecx >> 27) & 1) && ((ecx >> 28) & 1))   /* OSXSAVE & AVX */
+    {
+        U32 xcr0, xcr0High;
+        __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
+        (void)xcr0High;
+        avxState = ((xcr0 & 0x06) == 0x06);   /* xmm, ymm */
+        avx512State = avxState && ((xcr0 & 0xE0) == 0xE0);   /* opmask, zmm */
+    }
+
+    if (maxLeaf >= 7)
+    {
+        U32 leaf7;
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        leaf7 = ebx;
+        if (avxState && ((leaf7 >> 5) & 1)) features |= CPU_AVX2;
+        if (avx512State && ((leaf7 >> 16) & 1) && ((leaf7 >> 30) & 1)) features |= CPU_AVX512;
+        if (((leaf7 >> 3) & 1) && ((leaf7 >> 8) & 1)   /* BMI1 & BMI2 */
+            && __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && ((ecx >> 5) & 1))   /* ABM (lzcnt) */
+            features |= CPU_BMI2;
+    }
+    return features;
+#else
+    return 0;
+#endif
+}
+
+/*! CPU_features() :
+*   same as CPU_detectFeatures(), but cpuid is queried only once : result is cached (per translation unit). */
+MEM_STATIC U32 CPU_features(void)
+{
+    static U32 cached = 0;   /* benign race : all threads store the same value */
+    if (!cached) cached = CPU_detectFeatures() | CPU_DETECTED;
+    return cached & ~CPU_DETECTED;
+}
+
+/*! CPU_hasBMI2() :
+*   @return : 1 if the cpu supports BMI1, BMI2 and LZCNT, 0 otherwise. */
+MEM_STATIC U32 CPU_hasBMI2(void)
+{
+    return (CPU_features() & CPU_BMI2) != 0;
+}
+
+
+/******************************************
+*  Dispatch
+******************************************/
+/* CPU_DISPATCH_BMI2() :
+*  defines function `fn`, of return type `ret` and parenthesized parameters `params`, from `fn##_body`,
+*  which receives the parenthesized argument list `args`. `fn##_body` should be FORCE_INLINE.
+*  With CPU_DYNAMIC_BMI2, body is compiled twice, and the BMI2 variant is selected at runtime when available.
+*  `fn` gets external linkage, unless it was previously declared static. */
+#if CPU_DYNAMIC_BMI2
+#  define CPU_DISPATCH_BMI2(ret, fn, params, args)                     \
+    static ret fn##_default params { return fn##_body args; }          \
+    static CPU_TARGET_BMI2 ret fn##_bmi2 params { return fn##_body args; } \
+    ret fn params                                                      \
+    {                                                                  \
+        if (CPU_hasBMI2()) return fn##_bmi2 args;                      \
+        return fn##_default args;                                      \
+    }
+#else
+#  define CPU_DISPATCH_BMI2(ret, fn, params, args)                     \
+    ret fn params { return fn##_body args; }
+#endif
+
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* CPU_H_MODULE */
@@ -65,6 +65,7 @@ extern "C" {
         ITEM(PREFIX(dstSize_tooSmall)) ITEM(PREFIX(srcSize_wrong)) \
         ITEM(PREFIX(corruption_detected)) \
         ITEM(PREFIX(tableLog_tooLarge)) ITEM(PREFIX(maxSymbolValue_tooLarge)) ITEM(PREFIX(maxSymbolValue_tooSmall)) \
+        ITEM(PREFIX(memory_allocation)) \
         ITEM(PREFIX(maxCode))
 
 #define ERROR_GENERATE_ENUM(ENUM) ENUM,
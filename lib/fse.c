@@ -50,6 +50,14 @@
 *  Required for proper stack allocation */
 #define FSE_MAX_SYMBOL_VALUE 255
 
+/* FSE_SAMPLING_MINSIZE :
+*  FSE_compress2_sampled() and HUF_compress2_sampled() sample blocks of this size or larger before counting,
+*  and give up early on blocks which look incompressible (typically already compressed data).
+*  Set to 0 to disable sampling */
+#ifndef FSE_SAMPLING_MINSIZE
+#  define FSE_SAMPLING_MINSIZE (4 * 1024)
+#endif
+
 
 /****************************************************************
 *  template functions type & suffix
@@ -95,6 +103,7 @@ typedef struct
 #include <string.h>     /* memcpy, memset */
 #include <stdio.h>      /* printf (debug) */
 #include "bitstream.h"
+#include "cpu.h"        /* CPU_DISPATCH_BMI2 */
 #include "fse_static.h"
 
 
@@ -131,6 +140,41 @@ typedef U32 CTable_max_t[FSE_CTABLE_SIZE_U32(FSE_MAX_TABLELOG, FSE_MAX_SYMBOL_VA
 typedef U32 DTable_max_t[FSE_DTABLE_SIZE_U32(FSE_MAX_TABLELOG)];
 
 
+/****************************************************************
+*  Memory allocation
+****************************************************************/
+static void* FSE_defaultAlloc(void* opaque, size_t size) { (void)opaque; return malloc(size); }
+static void  FSE_defaultFree(void* opaque, void* address) { (void)opaque; free(address); }
+
+/* each allocated table is preceded by the allocator which created it,
+   so that it can be released without the caller providing it again */
+typedef union { FSE_customMem customMem; U64 align; } FSE_allocHeader;
+
+static void* FSE_malloc(size_t size, FSE_customMem customMem)
+{
+    FSE_allocHeader* header;
+    if ((customMem.customAlloc == NULL) ^ (customMem.customFree == NULL)) return NULL;   /* both or none */
+    if (customMem.customAlloc == NULL)
+    {
+        customMem.customAlloc = FSE_defaultAlloc;
+        customMem.customFree = FSE_defaultFree;
+        customMem.opaque = NULL;
+    }
+    header = (FSE_allocHeader*)customMem.customAlloc(customMem.opaque, sizeof(FSE_allocHeader) + size);
+    if (header == NULL) return NULL;
+    header->customMem = customMem;
+    return header + 1;
+}
+
+static void FSE_free(void* ptr)
+{
+    FSE_allocHeader* header;
+    if (ptr == NULL) return;   /* support free on NULL */
+    header = (FSE_allocHeader*)ptr - 1;
+    header->customMem.customFree(header->customMem.opaque, header);
+}
+
+
 /****************************************************************
 *  Templates
 ****************************************************************/
@@ -155,29 +199,34 @@ typedef U32 DTable_max_t[FSE_DTABLE_SIZE_U32(FSE_MAX_TABLELOG)];
 
 
 /* Function templates */
-size_t FSE_FUNCTION_NAME(FSE_count_generic, FSE_FUNCTION_EXTENSION)
-(unsigned* count, unsigned* maxSymbolValuePtr, const FSE_FUNCTION_TYPE* source, size_t sourceSize, unsigned safe)
+
+/* FSE_count_wksp() :
+   same as FSE_count(), but counting tables are provided by caller, and no default is applied to *maxSymbolValuePtr.
+   workSpace must be able to hold 4*(maxSymbolValue+1) U32 (4*256 for unchecked byte counting, when safe==0) */
+size_t FSE_FUNCTION_NAME(FSE_count_wksp, FSE_FUNCTION_EXTENSION)
+(unsigned* count, unsigned* maxSymbolValuePtr, const FSE_FUNCTION_TYPE* source, size_t sourceSize, unsigned safe, U32* workSpace)
 {
     const FSE_FUNCTION_TYPE* ip = source;
     const FSE_FUNCTION_TYPE* const iend = ip+sourceSize;
     unsigned maxSymbolValue = *maxSymbolValuePtr;
+    const size_t tableSize = ((safe) || (sizeof(FSE_FUNCTION_TYPE)>1)) ? maxSymbolValue+1 : 256;
+    U32* const Counting1 = workSpace;
+    U32* const Counting2 = Counting1 + tableSize;
+    U32* const Counting3 = Counting2 + tableSize;
+    U32* const Counting4 = Counting3 + tableSize;
     unsigned max=0;
     int s;
 
-    U32 Counting1[FSE_MAX_SYMBOL_VALUE+1] = { 0 };
-    U32 Counting2[FSE_MAX_SYMBOL_VALUE+1] = { 0 };
-    U32 Counting3[FSE_MAX_SYMBOL_VALUE+1] = { 0 };
-    U32 Counting4[FSE_MAX_SYMBOL_VALUE+1] = { 0 };
-
     /* safety checks */
     if (!sourceSize)
     {
-        memset(count, 0, (maxSymbolValue + 1) * sizeof(FSE_FUNCTION_TYPE));
+        memset(count, 0, (maxSymbolValue + 1) * sizeof(*count));
         *maxSymbolValuePtr = 0;
         return 0;
     }
-    if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(GENERIC);   /* maxSymbolValue too large : unsupported */
-    if (!maxSymbolValue) maxSymbolValue = FSE_MAX_SYMBOL_VALUE;            /* 0 == default */
+
+    /* only the part of the tables actually in use is reset, which matters for large alphabets */
+    memset(workSpace, 0, 4 * tableSize * sizeof(U32));
 
     if ((safe) || (sizeof(FSE_FUNCTION_TYPE)>1))
     {
@@ -220,7 +269,7 @@ size_t FSE_FUNCTION_NAME(FSE_count_generic, FSE_FUNCTION_EXTENSION)
     }
 
     /* finish last symbols */
-    while (ip<iend) { if ((safe) && (*ip>maxSymbolValue)) return ERROR(GENERIC); Counting1[*ip++]++; }
+    while (ip<iend) { if (((safe) || (sizeof(FSE_FUNCTION_TYPE)>1)) && (*ip>maxSymbolValue)) return ERROR(GENERIC); Counting1[*ip++]++; }
 
     for (s=0; s<=(int)maxSymbolValue; s++)
     {
@@ -233,6 +282,17 @@ size_t FSE_FUNCTION_NAME(FSE_count_generic, FSE_FUNCTION_EXTENSION)
     return (size_t)max;
 }
 
+size_t FSE_FUNCTION_NAME(FSE_count_generic, FSE_FUNCTION_EXTENSION)
+(unsigned* count, unsigned* maxSymbolValuePtr, const FSE_FUNCTION_TYPE* source, size_t sourceSize, unsigned safe)
+{
+    U32 workSpace[4*(FSE_MAX_SYMBOL_VALUE+1)];
+    if (!sourceSize)
+        return FSE_FUNCTION_NAME(FSE_count_wksp, FSE_FUNCTION_EXTENSION) (count, maxSymbolValuePtr, source, sourceSize, safe, workSpace);
+    if (*maxSymbolValuePtr > FSE_MAX_SYMBOL_VALUE) return ERROR(GENERIC);   /* maxSymbolValue too large : unsupported */
+    if (!*maxSymbolValuePtr) *maxSymbolValuePtr = FSE_MAX_SYMBOL_VALUE;     /* 0 == default */
+    return FSE_FUNCTION_NAME(FSE_count_wksp, FSE_FUNCTION_EXTENSION) (count, maxSymbolValuePtr, source, sourceSize, safe, workSpace);
+}
+
 /* hidden fast variant (unsafe) */
 size_t FSE_FUNCTION_NAME(FSE_countFast, FSE_FUNCTION_EXTENSION)
 (unsigned* count, unsigned* maxSymbolValuePtr, const FSE_FUNCTION_TYPE* source, size_t sourceSize)
@@ -254,21 +314,30 @@ size_t FSE_FUNCTION_NAME(FSE_count, FSE_FUNCTION_EXTENSION)
 
 static U32 FSE_tableStep(U32 tableSize) { return (tableSize>>1) + (tableSize>>3) + 3; }
 
-size_t FSE_FUNCTION_NAME(FSE_buildCTable, FSE_FUNCTION_EXTENSION)
-(FSE_CTable* ct, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+/* FSE_buildCTable_wksp() :
+   same as FSE_buildCTable(), using a caller-provided workSpace,
+   which must be at least FSE_BUILD_CTABLE_WKSP_SIZE(tableLog, maxSymbolValue) bytes */
+#define FSE_BUILD_CTABLE_WKSP_SIZE(tableLog, maxSymbolValue) ( ((maxSymbolValue)+2) * sizeof(unsigned) + ((size_t)1 << (tableLog)) * sizeof(FSE_FUNCTION_TYPE) )
+
+size_t FSE_FUNCTION_NAME(FSE_buildCTable_wksp, FSE_FUNCTION_EXTENSION)
+(FSE_CTable* ct, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler, void* workSpace, size_t wkspSize)
 {
     const unsigned tableSize = 1 << tableLog;
     const unsigned tableMask = tableSize - 1;
     U16* tableU16 = ( (U16*) ct) + 2;
     FSE_symbolCompressionTransform* symbolTT = (FSE_symbolCompressionTransform*) (((U32*)ct) + 1 + (tableLog ? tableSize>>1 : 1) );
     const unsigned step = FSE_tableStep(tableSize);
-    unsigned cumul[FSE_MAX_SYMBOL_VALUE+2];
+    unsigned* const cumul = (unsigned*)workSpace;
+    FSE_FUNCTION_TYPE* const tableSymbol = (FSE_FUNCTION_TYPE*)(cumul + maxSymbolValue + 2); /* init isn't necessary, even if static analyzer complain about it */
     U32 position = 0;
-    FSE_FUNCTION_TYPE tableSymbol[FSE_MAX_TABLESIZE]; /* init isn't necessary, even if static analyzer complain about it */
     U32 highThreshold = tableSize-1;
     unsigned symbol;
     unsigned i;
 
+    /* Sanity Checks */
+    if (tableLog > FSE_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    if (wkspSize < FSE_BUILD_CTABLE_WKSP_SIZE(tableLog, maxSymbolValue)) return ERROR(GENERIC);
+
     /* header */
     tableU16[-2] = (U16) tableLog;
     tableU16[-1] = (U16) maxSymbolValue;
@@ -356,18 +425,32 @@ size_t FSE_FUNCTION_NAME(FSE_buildCTable, FSE_FUNCTION_EXTENSION)
     return 0;
 }
 
+size_t FSE_FUNCTION_NAME(FSE_buildCTable, FSE_FUNCTION_EXTENSION)
+(FSE_CTable* ct, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+{
+    unsigned workSpace[FSE_MAX_SYMBOL_VALUE + 2 + (FSE_MAX_TABLESIZE * sizeof(FSE_FUNCTION_TYPE) + sizeof(unsigned) - 1) / sizeof(unsigned)];
+    if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+    return FSE_FUNCTION_NAME(FSE_buildCTable_wksp, FSE_FUNCTION_EXTENSION) (ct, normalizedCounter, maxSymbolValue, tableLog, scrambler, workSpace, sizeof(workSpace));
+}
+
 
 #define FSE_DECODE_TYPE FSE_TYPE_NAME(FSE_decode_t, FSE_FUNCTION_EXTENSION)
 
-FSE_DTable* FSE_FUNCTION_NAME(FSE_createDTable, FSE_FUNCTION_EXTENSION) (unsigned tableLog)
+FSE_DTable* FSE_FUNCTION_NAME(FSE_createDTable_advanced, FSE_FUNCTION_EXTENSION) (unsigned tableLog, FSE_customMem customMem)
 {
     if (tableLog > FSE_TABLELOG_ABSOLUTE_MAX) tableLog = FSE_TABLELOG_ABSOLUTE_MAX;
-    return (FSE_DTable*)malloc( FSE_DTABLE_SIZE_U32(tableLog) * sizeof (U32) );
+    return (FSE_DTable*)FSE_malloc( FSE_DTABLE_SIZE_U32(tableLog) * sizeof (U32), customMem );
+}
+
+FSE_DTable* FSE_FUNCTION_NAME(FSE_createDTable, FSE_FUNCTION_EXTENSION) (unsigned tableLog)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return FSE_FUNCTION_NAME(FSE_createDTable_advanced, FSE_FUNCTION_EXTENSION) (tableLog, defaultMem);
 }
 
 void FSE_FUNCTION_NAME(FSE_freeDTable, FSE_FUNCTION_EXTENSION) (FSE_DTable* dt)
 {
-    free(dt);
+    FSE_free(dt);
 }
 
 typedef struct {
@@ -375,15 +458,17 @@ typedef struct {
     U16 fastMode;
 } FSE_DTableHeader;   /* sizeof U32 */
 
-size_t FSE_FUNCTION_NAME(FSE_buildDTable, FSE_FUNCTION_EXTENSION)
-(FSE_DTable* dt, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+/* FSE_buildDTable_wksp() :
+   same as FSE_buildDTable(), using a caller-provided workSpace of (maxSymbolValue+1) U16 */
+size_t FSE_FUNCTION_NAME(FSE_buildDTable_wksp, FSE_FUNCTION_EXTENSION)
+(FSE_DTable* dt, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler, void* workSpace, size_t wkspSize)
 {
     FSE_DTableHeader* const DTableH = (FSE_DTableHeader*)dt;
     FSE_DECODE_TYPE* const tableDecode = (FSE_DECODE_TYPE*) (dt+1);   /* because dt is unsigned, 32-bits aligned on 32-bits */
     const U32 tableSize = 1 << tableLog;
     const U32 tableMask = tableSize-1;
     const U32 step = FSE_tableStep(tableSize);
-    U16 symbolNext[FSE_MAX_SYMBOL_VALUE+1];
+    U16* const symbolNext = (U16*)workSpace;
     U32 position = 0;
     U32 highThreshold = tableSize-1;
     const S16 largeLimit= (S16)(1 << (tableLog-1));
@@ -391,7 +476,7 @@ size_t FSE_FUNCTION_NAME(FSE_buildDTable, FSE_FUNCTION_EXTENSION)
     U32 s;
 
     /* Sanity Checks */
-    if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+    if (wkspSize < (maxSymbolValue+1) * sizeof(U16)) return ERROR(GENERIC);
     if (tableLog > FSE_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
 
     /* Init, lay down lowprob symbols */
@@ -454,6 +539,14 @@ size_t FSE_FUNCTION_NAME(FSE_buildDTable, FSE_FUNCTION_EXTENSION)
     return 0;
 }
 
+size_t FSE_FUNCTION_NAME(FSE_buildDTable, FSE_FUNCTION_EXTENSION)
+(FSE_DTable* dt, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+{
+    U16 symbolNext[FSE_MAX_SYMBOL_VALUE+1];
+    if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+    return FSE_FUNCTION_NAME(FSE_buildDTable_wksp, FSE_FUNCTION_EXTENSION) (dt, normalizedCounter, maxSymbolValue, tableLog, scrambler, symbolNext, sizeof(symbolNext));
+}
+
 
 #ifndef FSE_COMMONDEFS_ONLY
 /******************************************
@@ -575,9 +668,10 @@ static size_t FSE_writeNCount_generic (void* header, size_t headerBufferSize,
 }
 
 
-size_t FSE_writeNCount (void* buffer, size_t bufferSize, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog)
+size_t FSE_writeNCount_withLimit (void* buffer, size_t bufferSize, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned tableLogLimit)
 {
-    if (tableLog > FSE_MAX_TABLELOG) return ERROR(GENERIC);   /* Unsupported */
+    if (tableLog > tableLogLimit) return ERROR(GENERIC);   /* Unsupported */
+    if (tableLog > FSE_TABLELOG_ABSOLUTE_MAX) return ERROR(GENERIC);   /* Unsupported */
     if (tableLog < FSE_MIN_TABLELOG) return ERROR(GENERIC);   /* Unsupported */
 
     if (bufferSize < FSE_NCountWriteBound(maxSymbolValue, tableLog))
@@ -586,6 +680,11 @@ size_t FSE_writeNCount (void* buffer, size_t bufferSize, const short* normalized
     return FSE_writeNCount_generic(buffer, bufferSize, normalizedCounter, maxSymbolValue, tableLog, 1);
 }
 
+size_t FSE_writeNCount (void* buffer, size_t bufferSize, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog)
+{
+    return FSE_writeNCount_withLimit(buffer, bufferSize, normalizedCounter, maxSymbolValue, tableLog, FSE_MAX_TABLELOG);
+}
+
 
 size_t FSE_readNCount (short* normalizedCounter, unsigned* maxSVPtr, unsigned* tableLogPtr,
                  const void* headerBuffer, size_t hbSize)
@@ -721,17 +820,23 @@ size_t FSE_sizeof_CTable (unsigned maxSymbolValue, unsigned tableLog)
     return size;
 }
 
-FSE_CTable* FSE_createCTable (unsigned maxSymbolValue, unsigned tableLog)
+FSE_CTable* FSE_createCTable_advanced (unsigned tableLog, unsigned maxSymbolValue, FSE_customMem customMem)
 {
     size_t size;
     if (tableLog > FSE_TABLELOG_ABSOLUTE_MAX) tableLog = FSE_TABLELOG_ABSOLUTE_MAX;
     size = FSE_CTABLE_SIZE_U32 (tableLog, maxSymbolValue) * sizeof(U32);
-    return (FSE_CTable*)malloc(size);
+    return (FSE_CTable*)FSE_malloc(size, customMem);
+}
+
+FSE_CTable* FSE_createCTable (unsigned tableLog, unsigned maxSymbolValue)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return FSE_createCTable_advanced(tableLog, maxSymbolValue, defaultMem);
 }
 
 void  FSE_freeCTable (FSE_CTable* ct)
 {
-    free(ct);
+    FSE_free(ct);
 }
 
 
@@ -744,7 +849,7 @@ static unsigned FSE_minTableLog(size_t srcSize, unsigned maxSymbolValue)
 	return minBits;
 }
 
-unsigned FSE_optimalTableLog(unsigned maxTableLog, size_t srcSize, unsigned maxSymbolValue)
+unsigned FSE_optimalTableLog_withLimit(unsigned maxTableLog, size_t srcSize, unsigned maxSymbolValue, unsigned tableLogLimit)
 {
 	U32 maxBitsSrc = BIT_highbit32((U32)(srcSize - 1)) - 2;
     U32 tableLog = maxTableLog;
@@ -753,10 +858,16 @@ unsigned FSE_optimalTableLog(unsigned maxTableLog, size_t srcSize, unsigned maxS
 	if (maxBitsSrc < tableLog) tableLog = maxBitsSrc;   /* Accuracy can be reduced */
 	if (minBits > tableLog) tableLog = minBits;   /* Need a minimum to safely represent all symbol values */
     if (tableLog < FSE_MIN_TABLELOG) tableLog = FSE_MIN_TABLELOG;
-    if (tableLog > FSE_MAX_TABLELOG) tableLog = FSE_MAX_TABLELOG;
+    if (tableLog > tableLogLimit) tableLog = tableLogLimit;
+    if (tableLog > FSE_TABLELOG_ABSOLUTE_MAX) tableLog = FSE_TABLELOG_ABSOLUTE_MAX;
     return tableLog;
 }
 
+unsigned FSE_optimalTableLog(unsigned maxTableLog, size_t srcSize, unsigned maxSymbolValue)
+{
+    return FSE_optimalTableLog_withLimit(maxTableLog, srcSize, maxSymbolValue, FSE_MAX_TABLELOG);
+}
+
 
 /* Secondary normalization method.
    To be used when primary method fails. */
@@ -825,6 +936,15 @@ static size_t FSE_normalizeM2(short* norm, U32 tableLog, const unsigned* count,
         return 0;
     }
 
+    if (total == 0)
+    {
+        /* all used symbols were low enough for lowThreshold or lowOne :
+           spread remaining points over them, round-robin */
+        for (s=0; ToDistribute > 0; s = (s+1) % (maxSymbolValue+1))
+            if (norm[s] > 0) ToDistribute--, norm[s]++;
+        return 0;
+    }
+
     {
         U64 const vStepLog = 62 - tableLog;
         U64 const mid = (1ULL << (vStepLog-1)) - 1;
@@ -850,14 +970,15 @@ static size_t FSE_normalizeM2(short* norm, U32 tableLog, const unsigned* count,
 }
 
 
-size_t FSE_normalizeCount (short* normalizedCounter, unsigned tableLog,
+size_t FSE_normalizeCount_withLimit (short* normalizedCounter, unsigned tableLog,
                            const unsigned* count, size_t total,
-                           unsigned maxSymbolValue)
+                           unsigned maxSymbolValue, unsigned tableLogLimit)
 {
     /* Sanity checks */
     if (tableLog==0) tableLog = FSE_DEFAULT_TABLELOG;
     if (tableLog < FSE_MIN_TABLELOG) return ERROR(GENERIC);   /* Unsupported size */
-    if (tableLog > FSE_MAX_TABLELOG) return ERROR(GENERIC);   /* Unsupported size */
+    if (tableLog > tableLogLimit) return ERROR(GENERIC);   /* Unsupported size */
+    if (tableLog > FSE_TABLELOG_ABSOLUTE_MAX) return ERROR(GENERIC);   /* Unsupported size */
     if (tableLog < FSE_minTableLog(total, maxSymbolValue)) return ERROR(GENERIC);   /* Too small tableLog, compression potentially impossible */
 
     {
@@ -927,6 +1048,13 @@ size_t FSE_normalizeCount (short* normalizedCounter, unsigned tableLog,
     return tableLog;
 }
 
+size_t FSE_normalizeCount (short* normalizedCounter, unsigned tableLog,
+                           const unsigned* count, size_t total,
+                           unsigned maxSymbolValue)
+{
+    return FSE_normalizeCount_withLimit(normalizedCounter, tableLog, count, total, maxSymbolValue, FSE_MAX_TABLELOG);
+}
+
 
 /* fake FSE_CTable, for raw (uncompressed) input */
 size_t FSE_buildCTable_raw (FSE_CTable* ct, unsigned nbBits)
@@ -1085,7 +1213,43 @@ size_t FSE_compress_usingCTable (void* dst, size_t dstSize,
 
 size_t FSE_compressBound(size_t size) { return FSE_COMPRESSBOUND(size); }
 
-size_t FSE_compress2(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+
+/****************************************************************
+*  Compressibility estimation
+****************************************************************/
+#define FSE_SAMPLING_NB 2048        /* minimum nb of sampled bytes */
+#define FSE_SAMPLING_ALPHABET 248   /* incompressible if sampled bytes look like drawn uniformly from >= 248 values (>= 7.95 bits/byte) */
+
+/* FSE_isIncompressible() :
+   counts bytes at an odd stride (less likely to resonate with periodic structures),
+   and estimates collision probability sum(p^2) as sum(c*(c-1)) / (n*(n-1)), which is unbiased.
+   Since order-0 entropy >= -log2(sum(p^2)), a small collision probability means no entropy coder can save much */
+unsigned FSE_isIncompressible(const void* src, size_t srcSize)
+{
+#if (FSE_SAMPLING_MINSIZE == 0)
+    (void)src; (void)srcSize;
+    return 0;   /* sampling disabled */
+#else
+    const BYTE* const istart = (const BYTE*) src;
+    U32 count[256];
+    size_t stride, pos, nbSamples = 0;
+    U64 collisions = 0;
+    U32 s;
+
+    if (srcSize < FSE_SAMPLING_MINSIZE) return 0;
+    memset(count, 0, sizeof(count));
+    stride = (srcSize / FSE_SAMPLING_NB) | 1;
+    for (pos=0; pos<srcSize; pos+=stride) { count[istart[pos]]++; nbSamples++; }
+    for (s=0; s<256; s++)
+        if (count[s]) collisions += (U64)count[s] * (count[s]-1);
+
+    return (collisions * FSE_SAMPLING_ALPHABET) <= ((U64)nbSamples * (nbSamples-1));
+#endif
+}
+
+
+static size_t FSE_compress2_internal(void* dst, size_t dstSize, const void* src, size_t srcSize,
+                                     unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler, unsigned sampling)
 {
     const BYTE* const istart = (const BYTE*) src;
     const BYTE* ip = istart;
@@ -1103,6 +1267,7 @@ size_t FSE_compress2(void* dst, size_t dstSize, const void* src, size_t srcSize,
     if (srcSize <= 1) return 0;  /* Uncompressible */
     if (!maxSymbolValue) maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
     if (!tableLog) tableLog = FSE_DEFAULT_TABLELOG;
+    if (sampling && (maxSymbolValue == FSE_MAX_SYMBOL_VALUE) && FSE_isIncompressible(src, srcSize)) return 0;   /* sampled : not worth counting */
 
     /* Scan input and build symbol stats */
     errorCode = FSE_count (count, &maxSymbolValue, ip, srcSize);
@@ -1134,6 +1299,16 @@ size_t FSE_compress2(void* dst, size_t dstSize, const void* src, size_t srcSize,
     return op-ostart;
 }
 
+size_t FSE_compress2(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+{
+    return FSE_compress2_internal(dst, dstSize, src, srcSize, maxSymbolValue, tableLog, scrambler, 0);
+}
+
+size_t FSE_compress2_sampled(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+{
+    return FSE_compress2_internal(dst, dstSize, src, srcSize, maxSymbolValue, tableLog, scrambler, 1);
+}
+
 size_t FSE_compress (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned scrambler)
 {
 	return FSE_compress2(dst, dstSize, src, (U32)srcSize, FSE_MAX_SYMBOL_VALUE, FSE_DEFAULT_TABLELOG, scrambler);
@@ -1220,10 +1395,11 @@ unsigned FSE_endOfDState(const FSE_DState_t* DStatePtr)
 }
 
 
+/* inPlace : cSrc bytes are reversed, and read forward; op must never overtake bitD.ptr */
 FORCE_INLINE size_t FSE_decompress_usingDTable_generic(
           void* dst, size_t maxDstSize,
     const void* cSrc, size_t cSrcSize,
-    const FSE_DTable* dt, const unsigned fast)
+    const FSE_DTable* dt, const unsigned fast, const unsigned inPlace)
 {
     BYTE* const ostart = (BYTE*) dst;
     BYTE* op = ostart;
@@ -1236,31 +1412,51 @@ FORCE_INLINE size_t FSE_decompress_usingDTable_generic(
     size_t errorCode;
 
     /* Init */
-    errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);   /* replaced last arg by maxCompressed Size */
+    if (inPlace)
+        errorCode = BIT_initForwardDStream(&bitD, cSrc, cSrcSize);
+    else
+        errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);   /* replaced last arg by maxCompressed Size */
     if (FSE_isError(errorCode)) return errorCode;
 
-    FSE_initDState(&state1, &bitD, dt);
-    FSE_initDState(&state2, &bitD, dt);
+#define FSE_RELOAD(bitDPtr) (inPlace ? BIT_reloadForwardDStream(bitDPtr) : BIT_reloadDStream(bitDPtr))
+#define FSE_OVERTAKE(n) (inPlace && (bitD.ptr != bitD.start) && (op+(n) > (const BYTE*)bitD.ptr))   /* bytes from bitD.ptr onward may still be read */
+
+    if (inPlace)
+    {
+        /* same as FSE_initDState(), with forward reload */
+        const U32 tableLog = ((const FSE_DTableHeader*)dt)->tableLog;
+        state1.state = BIT_readBits(&bitD, tableLog);
+        FSE_RELOAD(&bitD);
+        state1.table = dt + 1;
+        state2.state = BIT_readBits(&bitD, tableLog);
+        FSE_RELOAD(&bitD);
+        state2.table = dt + 1;
+    }
+    else
+    {
+        FSE_initDState(&state1, &bitD, dt);
+        FSE_initDState(&state2, &bitD, dt);
+    }
 
 #define FSE_GETSYMBOL(statePtr) fast ? FSE_decodeSymbolFast(statePtr, &bitD) : FSE_decodeSymbol(statePtr, &bitD)
 
     /* 4 symbols per loop */
-    for ( ; (BIT_reloadDStream(&bitD)==BIT_DStream_unfinished) && (op<olimit) ; op+=4)
+    for ( ; (FSE_RELOAD(&bitD)==BIT_DStream_unfinished) && (op<olimit) && !FSE_OVERTAKE(4) ; op+=4)
     {
         op[0] = FSE_GETSYMBOL(&state1);
 
         if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
-            BIT_reloadDStream(&bitD);
+            FSE_RELOAD(&bitD);
 
         op[1] = FSE_GETSYMBOL(&state2);
 
         if (FSE_MAX_TABLELOG*4+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
-            { if (BIT_reloadDStream(&bitD) > BIT_DStream_unfinished) { op+=2; break; } }
+            { if (FSE_RELOAD(&bitD) > BIT_DStream_unfinished) { op+=2; break; } }
 
         op[2] = FSE_GETSYMBOL(&state1);
 
         if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
-            BIT_reloadDStream(&bitD);
+            FSE_RELOAD(&bitD);
 
         op[3] = FSE_GETSYMBOL(&state2);
     }
@@ -1269,12 +1465,12 @@ FORCE_INLINE size_t FSE_decompress_usingDTable_generic(
     /* note : BIT_reloadDStream(&bitD) >= FSE_DStream_partiallyFilled; Ends at exactly BIT_DStream_completed */
     while (1)
     {
-        if ( (BIT_reloadDStream(&bitD)>BIT_DStream_completed) || (op==omax) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state1))) )
+        if ( (FSE_RELOAD(&bitD)>BIT_DStream_completed) || (op==omax) || FSE_OVERTAKE(1) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state1))) )
             break;
 
         *op++ = FSE_GETSYMBOL(&state1);
 
-        if ( (BIT_reloadDStream(&bitD)>BIT_DStream_completed) || (op==omax) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state2))) )
+        if ( (FSE_RELOAD(&bitD)>BIT_DStream_completed) || (op==omax) || FSE_OVERTAKE(1) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state2))) )
             break;
 
         *op++ = FSE_GETSYMBOL(&state2);
@@ -1285,23 +1481,43 @@ FORCE_INLINE size_t FSE_decompress_usingDTable_generic(
         return op-ostart;
 
     if (op==omax) return ERROR(dstSize_tooSmall);   /* dst buffer is full, but cSrc unfinished */
+    if (FSE_OVERTAKE(1)) return ERROR(dstSize_tooSmall);   /* in-place margin too small */
 
     return ERROR(corruption_detected);
 }
 
 
-size_t FSE_decompress_usingDTable(void* dst, size_t originalSize,
-                            const void* cSrc, size_t cSrcSize,
-                            const FSE_DTable* dt)
+FORCE_INLINE size_t FSE_decompress_usingDTable_internal(
+          void* dst, size_t maxDstSize,
+    const void* cSrc, size_t cSrcSize,
+    const FSE_DTable* dt, const unsigned inPlace)
 {
     const FSE_DTableHeader* DTableH = (const FSE_DTableHeader*)dt;
-    const U32 fastMode = DTableH->fastMode;
 
     /* select fast mode (static) */
-    if (fastMode) return FSE_decompress_usingDTable_generic(dst, originalSize, cSrc, cSrcSize, dt, 1);
-    return FSE_decompress_usingDTable_generic(dst, originalSize, cSrc, cSrcSize, dt, 0);
+    if (DTableH->fastMode) return FSE_decompress_usingDTable_generic(dst, maxDstSize, cSrc, cSrcSize, dt, 1, inPlace);
+    return FSE_decompress_usingDTable_generic(dst, maxDstSize, cSrc, cSrcSize, dt, 0, inPlace);
 }
 
+FORCE_INLINE size_t FSE_decompress_usingDTable_body(void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt)
+{
+    return FSE_decompress_usingDTable_internal(dst, maxDstSize, cSrc, cSrcSize, dt, 0);
+}
+
+FORCE_INLINE size_t FSE_decompressInPlace_usingDTable_body(void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt)
+{
+    return FSE_decompress_usingDTable_internal(dst, maxDstSize, cSrc, cSrcSize, dt, 1);
+}
+
+CPU_DISPATCH_BMI2(size_t, FSE_decompress_usingDTable,
+                  (void* dst, size_t originalSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt),
+                  (dst, originalSize, cSrc, cSrcSize, dt))
+
+static size_t FSE_decompressInPlace_usingDTable(void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt);
+CPU_DISPATCH_BMI2(size_t, FSE_decompressInPlace_usingDTable,
+                  (void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt),
+                  (dst, maxDstSize, cSrc, cSrcSize, dt))
+
 
 size_t FSE_decompress(void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
@@ -1330,5 +1546,237 @@ size_t FSE_decompress(void* dst, size_t maxDstSize, const void* cSrc, size_t cSr
 }
 
 
+size_t FSE_inPlaceMargin(size_t size) { return FSE_INPLACE_MARGIN(size); }
+
+size_t FSE_decompress_inPlace(void* buffer, size_t bufferSize, size_t cSrcSize, unsigned scrambler)
+{
+    BYTE* const bstart = (BYTE*)buffer;
+    BYTE* ip;
+    short counting[FSE_MAX_SYMBOL_VALUE+1];
+    DTable_max_t dt;
+    unsigned tableLog;
+    unsigned maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
+    size_t errorCode;
+
+    if (cSrcSize<2) return ERROR(srcSize_wrong);   /* too small input size */
+    if (cSrcSize > bufferSize) return ERROR(srcSize_wrong);
+    ip = bstart + bufferSize - cSrcSize;
+
+    /* header and table are fully read before anything is written into buffer */
+    errorCode = FSE_readNCount (counting, &maxSymbolValue, &tableLog, ip, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);   /* too small input size */
+    ip += errorCode;
+    cSrcSize -= errorCode;
+
+    errorCode = FSE_buildDTable (dt, counting, maxSymbolValue, tableLog, scrambler);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    /* bitStream is read forward, so that output never overwrites input still to be read */
+    BIT_reverseBytes(ip, cSrcSize);
+    return FSE_decompressInPlace_usingDTable(bstart, bufferSize, ip, cSrcSize, dt);
+}
+
+
+
+/****************************************************************
+*  Forward streams
+****************************************************************/
+size_t FSE_reverseStream(void* cSrc, size_t cSrcSize)
+{
+    BYTE* const istart = (BYTE*)cSrc;
+    short counting[FSE_MAX_SYMBOL_VALUE+1];
+    unsigned tableLog;
+    unsigned maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
+    size_t hSize;
+
+    if (cSrcSize<2) return cSrcSize;   /* not compressed, or RLE : no bitStream */
+    hSize = FSE_readNCount (counting, &maxSymbolValue, &tableLog, istart, cSrcSize);
+    if (FSE_isError(hSize)) return hSize;
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);   /* too small input size */
+    BIT_reverseBytes(istart + hSize, cSrcSize - hSize);
+    return cSrcSize;
+}
+
+typedef enum { FSE_fwd_header, FSE_fwd_statesInit, FSE_fwd_stream, FSE_fwd_done } FSE_fwdStage;
+
+struct FSE_ForwardDCtx_s
+{
+    DTable_max_t dt;
+    BIT_DStream_t bitD;
+    FSE_DState_t state1;
+    FSE_DState_t state2;
+    BYTE* dst;
+    size_t maxDstSize;
+    size_t cSrcSize;
+    size_t hSize;
+    size_t decoded;   /* dst[0..decoded-1] is regenerated */
+    U32 scrambler;
+    FSE_fwdStage stage;
+};
+
+FSE_ForwardDCtx* FSE_createForwardDCtx_advanced(FSE_customMem customMem)
+{
+    FSE_ForwardDCtx* const fctx = (FSE_ForwardDCtx*)FSE_malloc(sizeof(FSE_ForwardDCtx), customMem);
+    if (fctx) fctx->stage = FSE_fwd_done;
+    return fctx;
+}
+
+FSE_ForwardDCtx* FSE_createForwardDCtx(void)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return FSE_createForwardDCtx_advanced(defaultMem);
+}
+
+size_t FSE_freeForwardDCtx(FSE_ForwardDCtx* fctx) { FSE_free(fctx); return 0; }
+
+size_t FSE_initForwardDecoding(FSE_ForwardDCtx* fctx, void* dst, size_t maxDstSize, size_t cSrcSize, unsigned scrambler)
+{
+    fctx->stage = FSE_fwd_done;
+    if (cSrcSize<2) return ERROR(srcSize_wrong);   /* too small input size */
+    fctx->dst = (BYTE*)dst;
+    fctx->maxDstSize = maxDstSize;
+    fctx->cSrcSize = cSrcSize;
+    fctx->decoded = 0;
+    fctx->scrambler = scrambler;
+    fctx->stage = FSE_fwd_header;
+    return 0;
+}
+
+/* same loops as FSE_decompress_usingDTable_generic(), reading forward.
+   While stream is incomplete, the main loop stops before any reload could read beyond iLimit;
+   it only stops between 4-symbols rounds, so that state1 and state2 keep alternating properly */
+FORCE_INLINE size_t FSE_decodeForward_generic(FSE_ForwardDCtx* fctx, const BYTE* const iLimit, const unsigned complete, const unsigned fast)
+{
+    BYTE* const ostart = fctx->dst;
+    BYTE* op = ostart + fctx->decoded;
+    BYTE* const omax = ostart + fctx->maxDstSize;
+    BYTE* const olimit = omax-3;
+    BIT_DStream_t bitD = fctx->bitD;   /* local copies : stay in registers */
+    FSE_DState_t state1 = fctx->state1;
+    FSE_DState_t state2 = fctx->state2;
+
+    /* 4 symbols per loop : up to 4 reloads, each one reading one container */
+    for ( ; (complete || ((const BYTE*)bitD.ptr + 5*sizeof(bitD.bitContainer) <= iLimit))
+          && (BIT_reloadForwardDStream(&bitD)==BIT_DStream_unfinished) && (op<olimit) ; op+=4)
+    {
+        op[0] = FSE_GETSYMBOL(&state1);
+
+        if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            BIT_reloadForwardDStream(&bitD);
+
+        op[1] = FSE_GETSYMBOL(&state2);
+
+        if (FSE_MAX_TABLELOG*4+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            { if (BIT_reloadForwardDStream(&bitD) > BIT_DStream_unfinished) { op+=2; break; } }
+
+        op[2] = FSE_GETSYMBOL(&state1);
+
+        if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            BIT_reloadForwardDStream(&bitD);
+
+        op[3] = FSE_GETSYMBOL(&state2);
+    }
+
+    if (!complete)
+    {
+        fctx->bitD = bitD;
+        fctx->state1 = state1;
+        fctx->state2 = state2;
+        fctx->decoded = (size_t)(op-ostart);
+        return fctx->decoded;
+    }
+
+    /* tail */
+    while (1)
+    {
+        if ( (BIT_reloadForwardDStream(&bitD)>BIT_DStream_completed) || (op==omax) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state1))) )
+            break;
+
+        *op++ = FSE_GETSYMBOL(&state1);
+
+        if ( (BIT_reloadForwardDStream(&bitD)>BIT_DStream_completed) || (op==omax) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(&state2))) )
+            break;
+
+        *op++ = FSE_GETSYMBOL(&state2);
+    }
+
+    /* end ? */
+    fctx->stage = FSE_fwd_done;
+    fctx->decoded = (size_t)(op-ostart);
+    if (BIT_endOfDStream(&bitD) && FSE_endOfDState(&state1) && FSE_endOfDState(&state2))
+        return fctx->decoded;
+
+    if (op==omax) return ERROR(dstSize_tooSmall);   /* dst buffer is full, but cSrc unfinished */
+
+    return ERROR(corruption_detected);
+}
+
+FORCE_INLINE size_t FSE_decodeForward_body(FSE_ForwardDCtx* fctx, const BYTE* iLimit, unsigned complete)
+{
+    const FSE_DTable* const dt = fctx->dt;
+
+    /* select fast mode (static) */
+    if (((const FSE_DTableHeader*)dt)->fastMode) return FSE_decodeForward_generic(fctx, iLimit, complete, 1);
+    return FSE_decodeForward_generic(fctx, iLimit, complete, 0);
+}
+
+static size_t FSE_decodeForward(FSE_ForwardDCtx* fctx, const BYTE* iLimit, unsigned complete);
+CPU_DISPATCH_BMI2(size_t, FSE_decodeForward,
+                  (FSE_ForwardDCtx* fctx, const BYTE* iLimit, unsigned complete),
+                  (fctx, iLimit, complete))
+
+size_t FSE_decompressForward_continue(FSE_ForwardDCtx* fctx, const void* cSrc, size_t availableSize)
+{
+    const BYTE* const istart = (const BYTE*)cSrc;
+    const unsigned complete = (availableSize == fctx->cSrcSize);
+    const FSE_DTable* const dt = fctx->dt;
+    const FSE_DTableHeader* const DTableH = (const FSE_DTableHeader*)dt;
+
+    if (availableSize > fctx->cSrcSize) return ERROR(srcSize_wrong);
+    if (fctx->stage == FSE_fwd_done) return fctx->decoded;
+
+    if (fctx->stage == FSE_fwd_header)
+    {
+        short counting[FSE_MAX_SYMBOL_VALUE+1];
+        unsigned tableLog;
+        unsigned maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
+        size_t errorCode;
+
+        errorCode = FSE_readNCount (counting, &maxSymbolValue, &tableLog, istart, availableSize);
+        if (FSE_isError(errorCode))
+        {
+            if (!complete && (availableSize < FSE_NCOUNTBOUND)) return 0;   /* header may not be fully received yet */
+            return errorCode;
+        }
+        if (errorCode >= fctx->cSrcSize) return ERROR(srcSize_wrong);   /* too small input size */
+        fctx->hSize = errorCode;
+
+        errorCode = FSE_buildDTable (fctx->dt, counting, maxSymbolValue, tableLog, fctx->scrambler);
+        if (FSE_isError(errorCode)) return errorCode;
+        fctx->stage = FSE_fwd_statesInit;
+    }
+
+    if (fctx->stage == FSE_fwd_statesInit)
+    {
+        /* same as FSE_initDState(), with forward reload : 2 reloads, hence 3 containers */
+        const U32 tableLog = DTableH->tableLog;
+        size_t errorCode;
+
+        if (!complete && (availableSize < fctx->hSize + 3*sizeof(fctx->bitD.bitContainer))) return 0;
+        errorCode = BIT_initForwardDStream(&fctx->bitD, istart + fctx->hSize, fctx->cSrcSize - fctx->hSize);
+        if (FSE_isError(errorCode)) return errorCode;
+        fctx->state1.state = BIT_readBits(&fctx->bitD, tableLog);
+        BIT_reloadForwardDStream(&fctx->bitD);
+        fctx->state1.table = dt + 1;
+        fctx->state2.state = BIT_readBits(&fctx->bitD, tableLog);
+        BIT_reloadForwardDStream(&fctx->bitD);
+        fctx->state2.table = dt + 1;
+        fctx->stage = FSE_fwd_stream;
+    }
+
+    return FSE_decodeForward(fctx, istart + availableSize, complete);
+}
+
 
 #endif   /* FSE_COMMONDEFS_ONLY */
@@ -77,6 +77,7 @@ FSE_decompress():
 *  Tool functions
 ******************************************/
 size_t FSE_compressBound(size_t size);       /* maximum compressed size */
+size_t FSE_inPlaceMargin(size_t size);       /* extra buffer space required by FSE_decompress_inPlace() */
 
 /* Error Management */
 unsigned    FSE_isError(size_t code);        /* tells if a return value is an error code */
@@ -97,6 +98,27 @@ FSE_compress2():
 */
 size_t FSE_compress2 (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
 
+/*
+FSE_compress2_sampled():
+    Same as FSE_compress2(), but blocks >= 4 KB using the full byte range are sampled first,
+    and return 0 (not compressible) without counting when they look incompressible (typically already compressed data).
+    Much faster on such blocks; when the sample looks compressible, result is identical to FSE_compress2().
+*/
+size_t FSE_compress2_sampled (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+
+/*
+FSE_decompress_inPlace():
+    Same as FSE_decompress(), but regenerated data overwrites its own compressed source.
+    Compressed data must be placed at the end of 'buffer', in its last 'cSrcSize' bytes.
+    Regenerated data is written from the beginning of 'buffer'.
+    Success is guaranteed if bufferSize >= originalSize + FSE_inPlaceMargin(originalSize).
+    Compressed data is destroyed in the process, even if decoding fails.
+    return : size of regenerated data (<= bufferSize)
+             or an error code, which can be tested using FSE_isError()
+             (dstSize_tooSmall if decoding would overwrite compressed data not yet read)
+*/
+size_t FSE_decompress_inPlace(void* buffer, size_t bufferSize, size_t cSrcSize, unsigned scrambler);
+
 
 /******************************************
 *  FSE detailed API
@@ -160,11 +182,22 @@ FSE_writeNCount():
 size_t FSE_writeNCount (void* buffer, size_t bufferSize, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog);
 
 
+/*
+FSE_customMem :
+   Optional user-provided allocator, used by the *_advanced() constructors below.
+   customAlloc() must return memory suitably aligned for any type (like malloc()).
+   Set both functions to NULL to use the default malloc() / free().
+   A table created with a custom allocator is released with the same one by its regular destructor. */
+typedef void* (*FSE_allocFunction) (void* opaque, size_t size);
+typedef void  (*FSE_freeFunction) (void* opaque, void* address);
+typedef struct { FSE_allocFunction customAlloc; FSE_freeFunction customFree; void* opaque; } FSE_customMem;
+
 /*
 Constructor and Destructor of type FSE_CTable
     Note that its size depends on 'tableLog' and 'maxSymbolValue' */
 typedef unsigned FSE_CTable;   /* don't allocate that. It's just a way to be more restrictive than void* */
 FSE_CTable* FSE_createCTable (unsigned tableLog, unsigned maxSymbolValue);
+FSE_CTable* FSE_createCTable_advanced (unsigned tableLog, unsigned maxSymbolValue, FSE_customMem customMem);
 void        FSE_freeCTable (FSE_CTable* ct);
 
 /*
@@ -241,6 +274,7 @@ Constructor and Destructor of type FSE_DTable
     Note that its size depends on 'tableLog' */
 typedef unsigned FSE_DTable;   /* don't allocate that. It's just a way to be more restrictive than void* */
 FSE_DTable* FSE_createDTable(unsigned tableLog);
+FSE_DTable* FSE_createDTable_advanced(unsigned tableLog, FSE_customMem customMem);
 void        FSE_freeDTable(FSE_DTable* dt);
 
 /*
@@ -0,0 +1,600 @@
+/* ******************************************************************
+   FSED : log-bucket integer coder, part of New Generation Entropy library
+   Copyright (C) 2013-2015, Yann Collet.
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+    You can contact the author at :
+    - FSE+Huff0 source repository : https://github.com/Cyan4973/FiniteStateEntropy
+    - Public forum : https://groups.google.com/forum/#!forum/lz4c
+****************************************************************** */
+
+/****************************************************************
+*  Compiler specifics
+****************************************************************/
+#if defined (__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */)
+/* inline is defined */
+#elif defined(_MSC_VER)
+#  define inline __inline
+#else
+#  define inline /* disable inline */
+#endif
+
+
+#ifdef _MSC_VER    /* Visual Studio */
+#  define FORCE_INLINE static __forceinline
+#  pragma warning(disable : 4127)        /* disable: C4127: conditional expression is constant */
+#else
+#  ifdef __GNUC__
+#    define GCC_VERSION (__GNUC__ * 100 + __GNUC_MINOR__)
+#    define FORCE_INLINE static inline __attribute__((always_inline))
+#  else
+#    define FORCE_INLINE static inline
+#  endif
+#endif
+
+
+/****************************************************************
+*  Includes
+****************************************************************/
+#include <string.h>     /* memset, memcpy */
+#include "fseDist.h"
+#include "bitstream.h"
+#include "fse_static.h"  /* FSE_CState_t, FSE_DState_t, FSE_encodeSymbol, FSE_decodeSymbol */
+
+
+/****************************************************************
+*  Constants
+****************************************************************/
+#define FSED_BLOCK_RAW     0   /* values stored little-endian */
+#define FSED_BLOCK_SINGLE  1   /* all values share the same bucket : only extra bits are stored */
+#define FSED_BLOCK_FSE     2   /* buckets FSE-compressed, interleaved with extra bits */
+
+#define FSED_MAX_SYMBOL_VALUE 255
+
+/* Block header (1 byte) : bits 0-1 : block type; bits 2-4 : LN; bits 5-7 : reserved (0) */
+
+
+/****************************************************************
+*  Buckets
+****************************************************************/
+/* A value is split into nbExtra = highbit(value | 2^LN) - LN low bits, stored raw,
+   and a bucket symbol = (nbExtra << LN) + (value >> nbExtra), entropy-coded.
+   Values < 2^(LN+1) are their own bucket, without extra bits.
+   Both operations are branchless, so bucketisation runs at the speed of a bit scan. */
+FORCE_INLINE U32 FSED_nbExtraBits(U32 value, U32 LN) { return BIT_highbit32(value | (1U<<LN)) - LN; }
+
+FORCE_INLINE U32 FSED_bucket(U32 value, U32 LN, U32 nbExtra) { return (nbExtra << LN) + (value >> nbExtra); }
+
+FORCE_INLINE U32 FSED_bucketNbExtraBits(U32 symbol, U32 LN) { return (symbol < (2U<<LN)) ? 0 : (symbol>>LN) - 1; }
+
+static U32 FSED_maxSymbolValue(U32 valueSize, U32 LN)
+{
+    const U32 maxExtra = (valueSize*8 - 1) - LN;
+    return (maxExtra << LN) + (2U << LN) - 1;
+}
+
+static U32 FSED_maxLN(U32 valueSize) { return valueSize==2 ? FSED_LN_MAX_U16 : FSED_LN_MAX_U32; }
+
+/* decoding side : for each bucket symbol, base value and nb of extra bits */
+static void FSED_buildValueTables(U32* baseValue, BYTE* nbExtraBits, U32 maxSymbolValue, U32 LN)
+{
+    U32 s;
+    for (s=0; s<=maxSymbolValue; s++)
+    {
+        const U32 nbExtra = FSED_bucketNbExtraBits(s, LN);
+        nbExtraBits[s] = (BYTE)nbExtra;
+        baseValue[s] = (s - (nbExtra<<LN)) << nbExtra;
+    }
+}
+
+FORCE_INLINE U32 FSED_readValue(const void* src, size_t n, const U32 valueSize)
+{
+    return (valueSize==2) ? ((const U16*)src)[n] : ((const U32*)src)[n];
+}
+
+FORCE_INLINE void FSED_writeValue(void* dst, size_t n, U32 value, const U32 valueSize)
+{
+    if (valueSize==2) ((U16*)dst)[n] = (U16)value;
+    else ((U32*)dst)[n] = value;
+}
+
+
+/****************************************************************
+*  Compression
+****************************************************************/
+/* FSED_count_generic() :
+   histogram of bucket symbols, into 'count' (FSED_MAX_SYMBOL_VALUE+1 cells).
+   @return : count of the most frequent bucket. maxSymbolValuePtr is updated to the largest bucket present */
+FORCE_INLINE size_t FSED_count_generic(unsigned* count, unsigned* maxSymbolValuePtr,
+                                 const void* src, size_t srcSize, const U32 LN, const U32 valueSize)
+{
+    U32 Counting1[FSED_MAX_SYMBOL_VALUE+1];
+    U32 Counting2[FSED_MAX_SYMBOL_VALUE+1];
+    U32 Counting3[FSED_MAX_SYMBOL_VALUE+1];
+    U32 Counting4[FSED_MAX_SYMBOL_VALUE+1];
+    const U32 maxSymbolValue = FSED_maxSymbolValue(valueSize, LN);
+    size_t n = 0;
+    U32 s, max = 0;
+
+    memset(Counting1, 0, (maxSymbolValue+1) * sizeof(U32));
+    memset(Counting2, 0, (maxSymbolValue+1) * sizeof(U32));
+    memset(Counting3, 0, (maxSymbolValue+1) * sizeof(U32));
+    memset(Counting4, 0, (maxSymbolValue+1) * sizeof(U32));
+
+    /* 4 independent histograms : consecutive values rarely collide on the same cell */
+    for ( ; n+3 < srcSize; n+=4)
+    {
+        const U32 v0 = FSED_readValue(src, n+0, valueSize);
+        const U32 v1 = FSED_readValue(src, n+1, valueSize);
+        const U32 v2 = FSED_readValue(src, n+2, valueSize);
+        const U32 v3 = FSED_readValue(src, n+3, valueSize);
+        Counting1[FSED_bucket(v0, LN, FSED_nbExtraBits(v0, LN))]++;
+        Counting2[FSED_bucket(v1, LN, FSED_nbExtraBits(v1, LN))]++;
+        Counting3[FSED_bucket(v2, LN, FSED_nbExtraBits(v2, LN))]++;
+        Counting4[FSED_bucket(v3, LN, FSED_nbExtraBits(v3, LN))]++;
+    }
+    for ( ; n < srcSize; n++)
+    {
+        const U32 v = FSED_readValue(src, n, valueSize);
+        Counting1[FSED_bucket(v, LN, FSED_nbExtraBits(v, LN))]++;
+    }
+
+    for (s=0; s<=maxSymbolValue; s++)
+    {
+        count[s] = Counting1[s] + Counting2[s] + Counting3[s] + Counting4[s];
+        if (count[s] > max) max = count[s];
+    }
+
+    s = maxSymbolValue;
+    while (!count[s]) s--;
+    *maxSymbolValuePtr = s;
+    return (size_t)max;
+}
+
+/* FSED_log2_8() : log2(x), in 1/256th of bits, with a linear approximation of the fractional part */
+static U32 FSED_log2_8(U32 x)
+{
+    const U32 hb = BIT_highbit32(x);
+    const U32 mantissa = (hb >= 8) ? (x >> (hb-8)) : (x << (8-hb));
+    return (hb << 8) + (mantissa & 255);
+}
+
+/* FSED_mergeCount() :
+   derives the histogram at precision LN from a histogram at precision fineLN >= LN,
+   since all values of a fine bucket belong to the same coarse bucket.
+   @return : count of the most frequent bucket */
+static size_t FSED_mergeCount(unsigned* count, unsigned* maxSymbolValuePtr,
+                        const unsigned* fineCount, unsigned fineMaxSymbolValue, U32 fineLN, U32 LN)
+{
+    unsigned s, max = 0;
+    memset(count, 0, (FSED_MAX_SYMBOL_VALUE+1) * sizeof(*count));
+    *maxSymbolValuePtr = 0;
+    for (s=0; s<=fineMaxSymbolValue; s++)
+    {
+        const U32 nbExtra = FSED_bucketNbExtraBits(s, fineLN);
+        const U32 baseValue = (s - (nbExtra<<fineLN)) << nbExtra;
+        const U32 symbol = FSED_bucket(baseValue, LN, FSED_nbExtraBits(baseValue, LN));
+        if (!fineCount[s]) continue;
+        count[symbol] += fineCount[s];
+        if (count[symbol] > max) max = count[symbol];
+        *maxSymbolValuePtr = symbol;   /* buckets are monotonic */
+    }
+    return (size_t)max;
+}
+
+/* FSED_estimateCost() :
+   estimated block size, in 1/256th of bits : order-0 entropy of buckets + extra bits + header.
+   Header is roughly accounted as tableLog bits per present bucket. */
+static U64 FSED_estimateCost(const unsigned* count, unsigned maxSymbolValue, size_t total, U32 LN, U32 tableLog)
+{
+    const U32 logTotal = FSED_log2_8((U32)total);
+    U64 cost = 0;
+    unsigned s;
+    for (s=0; s<=maxSymbolValue; s++)
+    {
+        if (!count[s]) continue;
+        cost += (U64)count[s] * (logTotal - FSED_log2_8(count[s]) + (FSED_bucketNbExtraBits(s, LN) << 8));
+        cost += tableLog << 8;
+    }
+    return cost;
+}
+
+/* FSED_selectLN() :
+   picks the mantissa precision minimizing estimated cost, using a single histogram
+   collected at maximum precision 'maxLN'. Smallest LN wins ties (smaller tables). */
+static U32 FSED_selectLN(const unsigned* fineCount, unsigned fineMaxSymbolValue, size_t total, U32 maxLN, U32 tableLog)
+{
+    unsigned count[FSED_MAX_SYMBOL_VALUE+1];
+    U64 bestCost = (U64)-1;
+    U32 bestLN = maxLN;
+    U32 LN;
+
+    for (LN=0; LN<=maxLN; LN++)
+    {
+        unsigned maxSymbolValue;
+        U64 cost;
+        FSED_mergeCount(count, &maxSymbolValue, fineCount, fineMaxSymbolValue, maxLN, LN);
+        cost = FSED_estimateCost(count, maxSymbolValue, total, LN, tableLog);
+        if (cost < bestCost) { bestCost = cost; bestLN = LN; }
+    }
+    return bestLN;
+}
+
+/* extra bits first : decoder reads them after the FSE state update */
+FORCE_INLINE void FSED_encodeValue(BIT_CStream_t* bitC, FSE_CState_t* statePtr, U32 value, const U32 LN)
+{
+    const U32 nbExtra = FSED_nbExtraBits(value, LN);
+    const U32 extra = value & ((1U << nbExtra) - 1);   /* nbExtra <= 31 */
+    if (MEM_32bits())   /* static test */
+    {
+        if (nbExtra > 16)
+        {
+            BIT_addBitsFast(bitC, extra & 0xFFFF, 16);
+            BIT_flushBits(bitC);
+            BIT_addBitsFast(bitC, extra >> 16, nbExtra-16);
+        }
+        else
+            BIT_addBitsFast(bitC, extra, nbExtra);
+        BIT_flushBits(bitC);
+    }
+    else
+        BIT_addBitsFast(bitC, extra, nbExtra);
+    FSE_encodeSymbol(bitC, statePtr, FSED_bucket(value, LN, nbExtra));
+}
+
+/* 2 interleaved states, so that decoder can run 2 independent decoding chains.
+   Bit budget per value : tableLog (<= 12) + extra bits (<= 15 for U16, <= 31 for U32) */
+FORCE_INLINE size_t FSED_compress_usingCTable_generic(void* dst, size_t maxDstSize,
+                                                const void* src, size_t srcSize,
+                                                const FSE_CTable* ct, const U32 LN, const U32 valueSize)
+{
+    BIT_CStream_t bitC;
+    FSE_CState_t CState1, CState2;
+    size_t n = srcSize;
+    size_t errorCode;
+
+    errorCode = BIT_initCStream(&bitC, dst, maxDstSize);
+    if (FSE_isError(errorCode)) return 0;
+    FSE_initCState(&CState1, ct);
+    FSE_initCState(&CState2, ct);
+
+    if (n & 1)
+    {
+        FSED_encodeValue(&bitC, &CState1, FSED_readValue(src, --n, valueSize), LN);
+        BIT_flushBits(&bitC);
+    }
+
+    while (n)
+    {
+        FSED_encodeValue(&bitC, &CState2, FSED_readValue(src, --n, valueSize), LN);
+        if ((valueSize==4) || MEM_32bits())   /* static test : 2 values don't fit */
+            BIT_flushBits(&bitC);
+        FSED_encodeValue(&bitC, &CState1, FSED_readValue(src, --n, valueSize), LN);
+        BIT_flushBits(&bitC);
+    }
+
+    FSE_flushCState(&bitC, &CState2);
+    FSE_flushCState(&bitC, &CState1);
+    return BIT_closeCStream(&bitC);
+}
+
+static size_t FSED_writeRaw(void* dst, size_t maxDstSize, const void* src, size_t srcSize, const U32 valueSize)
+{
+    BYTE* op = (BYTE*)dst;
+    size_t n;
+    if (maxDstSize < FSED_COMPRESSBOUND(srcSize, valueSize)) return ERROR(dstSize_tooSmall);
+    *op++ = FSED_BLOCK_RAW;
+    for (n=0; n<srcSize; n++, op+=valueSize)
+    {
+        if (valueSize==2) MEM_writeLE16(op, (U16)FSED_readValue(src, n, valueSize));
+        else MEM_writeLE32(op, FSED_readValue(src, n, valueSize));
+    }
+    return op - (BYTE*)dst;
+}
+
+/* all values share the same bucket : store it once, followed by extra bits only */
+static size_t FSED_writeSingle(void* dst, size_t maxDstSize, const void* src, size_t srcSize, const U32 LN, const U32 valueSize)
+{
+    BYTE* const ostart = (BYTE*)dst;
+    const U32 v0 = FSED_readValue(src, 0, valueSize);
+    const U32 nbExtra = FSED_nbExtraBits(v0, LN);
+    BIT_CStream_t bitC;
+    size_t n = srcSize;
+    size_t errorCode;
+
+    if (maxDstSize < 2) return 0;
+    ostart[0] = (BYTE)(FSED_BLOCK_SINGLE + (LN<<2));
+    ostart[1] = (BYTE)FSED_bucket(v0, LN, nbExtra);
+    if (nbExtra == 0) return 2;   /* all values identical */
+
+    if (maxDstSize < 2 + sizeof(bitC.bitContainer)) return 0;
+    BIT_initCStream(&bitC, ostart+2, maxDstSize-2);
+    while (n)
+    {
+        const U32 extra = FSED_readValue(src, --n, valueSize) & ((1U << nbExtra) - 1);
+        if (MEM_32bits() && (nbExtra > 16))
+        {
+            BIT_addBitsFast(&bitC, extra & 0xFFFF, 16);
+            BIT_flushBits(&bitC);
+            BIT_addBitsFast(&bitC, extra >> 16, nbExtra-16);
+        }
+        else
+            BIT_addBitsFast(&bitC, extra, nbExtra);
+        BIT_flushBits(&bitC);
+    }
+    errorCode = BIT_closeCStream(&bitC);
+    if (errorCode == 0) return 0;
+    return 2 + errorCode;
+}
+
+FORCE_INLINE size_t FSED_compress_generic(void* dst, size_t maxDstSize,
+                                    const void* src, size_t srcSize,
+                                    unsigned tableLog, U32 LN, const U32 valueSize)
+{
+    BYTE* const ostart = (BYTE*) dst;
+    BYTE* op = ostart;
+    BYTE* const oend = ostart + maxDstSize;
+    const size_t rawSize = FSED_COMPRESSBOUND(srcSize, valueSize);
+    unsigned count[FSED_MAX_SYMBOL_VALUE+1];
+    short norm[FSED_MAX_SYMBOL_VALUE+1];
+    U32 ct[FSE_CTABLE_SIZE_U32(FSED_MAX_TABLELOG, FSED_MAX_SYMBOL_VALUE)];
+    unsigned maxSymbolValue;
+    size_t errorCode;
+
+    /* Sanity checks */
+    if ((LN > FSED_maxLN(valueSize)) && (LN != FSED_LN_AUTO)) return ERROR(GENERIC);
+    if (!tableLog) tableLog = FSED_DEFAULT_TABLELOG;
+    if (tableLog > FSED_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    if (srcSize <= 1) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);
+
+    /* Scan for stats */
+    if (LN == FSED_LN_AUTO)
+    {
+        const U32 maxLN = FSED_maxLN(valueSize);
+        unsigned fineCount[FSED_MAX_SYMBOL_VALUE+1];
+        unsigned fineMaxSymbolValue;
+        errorCode = FSED_count_generic(fineCount, &fineMaxSymbolValue, src, srcSize, maxLN, valueSize);
+        LN = FSED_selectLN(fineCount, fineMaxSymbolValue, srcSize, maxLN, tableLog);
+        if (LN == maxLN)
+        {
+            memcpy(count, fineCount, sizeof(count));
+            maxSymbolValue = fineMaxSymbolValue;
+        }
+        else
+            errorCode = FSED_mergeCount(count, &maxSymbolValue, fineCount, fineMaxSymbolValue, maxLN, LN);
+    }
+    else
+        errorCode = FSED_count_generic(count, &maxSymbolValue, src, srcSize, LN, valueSize);
+    if (errorCode == srcSize)
+    {
+        errorCode = FSED_writeSingle(dst, maxDstSize, src, srcSize, LN, valueSize);
+        if ((errorCode == 0) || (errorCode >= rawSize)) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);
+        return errorCode;
+    }
+
+    /* Normalize */
+    tableLog = FSE_optimalTableLog(tableLog, srcSize, maxSymbolValue);
+    errorCode = FSE_normalizeCount(norm, tableLog, count, srcSize, maxSymbolValue);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    /* Header */
+    if (maxDstSize < 2) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);
+    *op++ = (BYTE)(FSED_BLOCK_FSE + (LN<<2));
+    errorCode = FSE_writeNCount(op, oend-op, norm, maxSymbolValue, tableLog);
+    if (FSE_isError(errorCode)) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);
+    op += errorCode;
+
+    /* Compress */
+    errorCode = FSE_buildCTable(ct, norm, maxSymbolValue, tableLog, 0);
+    if (FSE_isError(errorCode)) return errorCode;
+    errorCode = FSED_compress_usingCTable_generic(op, oend-op, src, srcSize, ct, LN, valueSize);
+    if (errorCode == 0) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);   /* not enough space */
+    op += errorCode;
+
+    /* check compressibility */
+    if ((size_t)(op-ostart) >= rawSize) return FSED_writeRaw(dst, maxDstSize, src, srcSize, valueSize);
+
+    return op-ostart;
+}
+
+size_t FSED_compressU16_advanced(void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, unsigned tableLog, unsigned LN)
+{
+    return FSED_compress_generic(dst, maxDstSize, src, srcSize, tableLog, LN, 2);
+}
+
+size_t FSED_compressU16(void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, unsigned tableLog)
+{
+    return FSED_compressU16_advanced(dst, maxDstSize, src, srcSize, tableLog, FSED_LN_AUTO);
+}
+
+size_t FSED_compressU32_advanced(void* dst, size_t maxDstSize, const unsigned* src, size_t srcSize, unsigned tableLog, unsigned LN)
+{
+    return FSED_compress_generic(dst, maxDstSize, src, srcSize, tableLog, LN, 4);
+}
+
+size_t FSED_compressU32(void* dst, size_t maxDstSize, const unsigned* src, size_t srcSize, unsigned tableLog)
+{
+    return FSED_compressU32_advanced(dst, maxDstSize, src, srcSize, tableLog, FSED_LN_AUTO);
+}
+
+
+/****************************************************************
+*  Decompression
+****************************************************************/
+FORCE_INLINE U32 FSED_readExtraBits(BIT_DStream_t* bitD, U32 nbExtra)
+{
+    if (MEM_32bits())   /* static test */
+    {
+        BIT_reloadDStream(bitD);
+        if (nbExtra > 16)
+        {
+            const U32 high = (U32)BIT_readBits(bitD, nbExtra-16);
+            BIT_reloadDStream(bitD);
+            return (high << 16) + (U32)BIT_readBits(bitD, 16);
+        }
+    }
+    return (U32)BIT_readBits(bitD, nbExtra);
+}
+
+FORCE_INLINE U32 FSED_decodeValue(FSE_DState_t* statePtr, BIT_DStream_t* bitD, const U32* baseValue, const BYTE* nbExtraBits)
+{
+    const U32 symbol = FSE_decodeSymbol(statePtr, bitD);
+    return baseValue[symbol] + FSED_readExtraBits(bitD, nbExtraBits[symbol]);
+}
+
+FORCE_INLINE size_t FSED_decompress_usingDTable_generic(void* dst, size_t originalSize,
+                                                  const void* cSrc, size_t cSrcSize,
+                                                  const FSE_DTable* dt, const U32* baseValue, const BYTE* nbExtraBits,
+                                                  const U32 valueSize)
+{
+    BIT_DStream_t bitD;
+    FSE_DState_t state1, state2;
+    size_t n = 0;
+    size_t errorCode;
+
+    errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    FSE_initDState(&state1, &bitD, dt);
+    FSE_initDState(&state2, &bitD, dt);
+
+    /* 2 values per loop */
+    for ( ; n+1 < originalSize; n+=2)
+    {
+        FSED_writeValue(dst, n, FSED_decodeValue(&state1, &bitD, baseValue, nbExtraBits), valueSize);
+        if ((valueSize==4) || MEM_32bits())   /* static test */
+            BIT_reloadDStream(&bitD);
+        FSED_writeValue(dst, n+1, FSED_decodeValue(&state2, &bitD, baseValue, nbExtraBits), valueSize);
+        if (BIT_reloadDStream(&bitD) > BIT_DStream_completed) return ERROR(corruption_detected);
+    }
+    if (n < originalSize)
+    {
+        FSED_writeValue(dst, n, FSED_decodeValue(&state1, &bitD, baseValue, nbExtraBits), valueSize);
+        BIT_reloadDStream(&bitD);
+    }
+
+    /* end ? */
+    if (!BIT_endOfDStream(&bitD) || !FSE_endOfDState(&state1) || !FSE_endOfDState(&state2))
+        return ERROR(corruption_detected);
+    return originalSize;
+}
+
+static size_t FSED_readSingle(void* dst, size_t originalSize, const BYTE* ip, size_t cSrcSize, const U32 LN, const U32 valueSize)
+{
+    const U32 symbol = ip[1];
+    const U32 nbExtra = FSED_bucketNbExtraBits(symbol, LN);
+    const U32 base = (symbol - (nbExtra<<LN)) << nbExtra;
+    BIT_DStream_t bitD;
+    size_t n;
+    size_t errorCode;
+
+    if (symbol > FSED_maxSymbolValue(valueSize, LN)) return ERROR(corruption_detected);
+    if (nbExtra == 0)
+    {
+        if (cSrcSize != 2) return ERROR(srcSize_wrong);
+        for (n=0; n<originalSize; n++) FSED_writeValue(dst, n, base, valueSize);
+        return originalSize;
+    }
+
+    if (cSrcSize < 3) return ERROR(srcSize_wrong);
+    memset(&bitD, 0, sizeof(bitD));   /* BIT_initDStream() leaves some fields unset on error paths */
+    errorCode = BIT_initDStream(&bitD, ip+2, cSrcSize-2);
+    if (FSE_isError(errorCode)) return errorCode;
+    for (n=0; n<originalSize; n++)
+    {
+        FSED_writeValue(dst, n, base + FSED_readExtraBits(&bitD, nbExtra), valueSize);
+        if (BIT_reloadDStream(&bitD) > BIT_DStream_completed) return ERROR(corruption_detected);
+    }
+    if (!BIT_endOfDStream(&bitD)) return ERROR(corruption_detected);
+    return originalSize;
+}
+
+FORCE_INLINE size_t FSED_decompress_generic(void* dst, size_t originalSize,
+                                      const void* cSrc, size_t cSrcSize, const U32 valueSize)
+{
+    const BYTE* const istart = (const BYTE*) cSrc;
+    const BYTE* ip = istart;
+    U32 blockType, LN;
+
+    if (cSrcSize < 1) return ERROR(srcSize_wrong);
+    blockType = istart[0] & 3;
+    LN = (istart[0] >> 2) & 7;
+    if ((istart[0] >> 5) || (LN > FSED_maxLN(valueSize))) return ERROR(corruption_detected);
+
+    switch(blockType)
+    {
+    case FSED_BLOCK_RAW:
+        {
+            size_t n;
+            if (cSrcSize != FSED_COMPRESSBOUND(originalSize, valueSize)) return ERROR(srcSize_wrong);
+            for (n=0, ip++; n<originalSize; n++, ip+=valueSize)
+                FSED_writeValue(dst, n, (valueSize==2) ? MEM_readLE16(ip) : MEM_readLE32(ip), valueSize);
+            return originalSize;
+        }
+
+    case FSED_BLOCK_SINGLE:
+        if (cSrcSize < 2) return ERROR(srcSize_wrong);
+        return FSED_readSingle(dst, originalSize, istart, cSrcSize, LN, valueSize);
+
+    case FSED_BLOCK_FSE:
+        {
+            short norm[FSED_MAX_SYMBOL_VALUE+1];
+            U32 dt[FSE_DTABLE_SIZE_U32(FSED_MAX_TABLELOG)];
+            U32 baseValue[FSED_MAX_SYMBOL_VALUE+1];
+            BYTE nbExtraBits[FSED_MAX_SYMBOL_VALUE+1];
+            unsigned maxSymbolValue = FSED_maxSymbolValue(valueSize, LN);
+            unsigned tableLog;
+            size_t errorCode;
+
+            ip++; cSrcSize--;
+            errorCode = FSE_readNCount(norm, &maxSymbolValue, &tableLog, ip, cSrcSize);
+            if (FSE_isError(errorCode)) return errorCode;
+            if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);
+            if (tableLog > FSED_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+            ip += errorCode;
+            cSrcSize -= errorCode;
+
+            errorCode = FSE_buildDTable(dt, norm, maxSymbolValue, tableLog, 0);
+            if (FSE_isError(errorCode)) return errorCode;
+            FSED_buildValueTables(baseValue, nbExtraBits, maxSymbolValue, LN);
+
+            return FSED_decompress_usingDTable_generic(dst, originalSize, ip, cSrcSize, dt, baseValue, nbExtraBits, valueSize);
+        }
+
+    default:
+        return ERROR(corruption_detected);
+    }
+}
+
+size_t FSED_decompressU16(unsigned short* dst, size_t originalSize, const void* cSrc, size_t cSrcSize)
+{
+    return FSED_decompress_generic(dst, originalSize, cSrc, cSrcSize, 2);
+}
+
+size_t FSED_decompressU32(unsigned* dst, size_t originalSize, const void* cSrc, size_t cSrcSize)
+{
+    return FSED_decompress_generic(dst, originalSize, cSrc, cSrcSize, 4);
+}
@@ -0,0 +1,99 @@
+/* ******************************************************************
+   FSED : log-bucket integer coder, part of New Generation Entropy library
+   header file
+   Copyright (C) 2013-2015, Yann Collet.
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+   You can contact the author at :
+   - Source repository : https://github.com/Cyan4973/FiniteStateEntropy
+   - Public forum : https://groups.google.com/forum/#!forum/lz4c
+****************************************************************** */
+#pragma once
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+
+/* *****************************************
+*  Includes
+******************************************/
+#include <stddef.h>    /* size_t */
+
+
+/* *****************************************
+*  FSED simple functions
+******************************************/
+/*
+FSED codes integer values (distances, lengths, timestamps...) in 2 parts :
+   - a bucket, which is the position of the highest bit, refined by LN bits of mantissa, entropy-coded with FSE
+   - extra bits, the remaining low bits of the value, stored raw.
+Values of any size are accepted, including 0.
+Compressed blocks are self-contained : they can be raw, single-bucket or FSE-compressed,
+and must be decoded with the exact number of values originally compressed.
+
+FSED_compressU16(), FSED_compressU32() :
+    'tableLog' == 0 means default (FSED_DEFAULT_TABLELOG)
+    Bucket precision is selected automatically, for each block.
+    return : size of compressed block (<= maxDstSize),
+             or an error code, which can be tested using FSE_isError().
+    Note : if maxDstSize >= FSED_COMPRESSBOUND(srcSize, sizeof(*src)), compression always succeeds.
+
+FSED_decompressU16(), FSED_decompressU32() :
+    'originalSize' is the exact number of values to regenerate into 'dst'.
+    return : originalSize,
+             or an error code, which can be tested using FSE_isError(). */
+size_t FSED_compressU16(void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, unsigned tableLog);
+size_t FSED_decompressU16(unsigned short* dst, size_t originalSize, const void* cSrc, size_t cSrcSize);
+
+size_t FSED_compressU32(void* dst, size_t maxDstSize, const unsigned* src, size_t srcSize, unsigned tableLog);
+size_t FSED_decompressU32(unsigned* dst, size_t originalSize, const void* cSrc, size_t cSrcSize);
+
+#define FSED_COMPRESSBOUND(nbValues, valueSize)  (1 + (size_t)(nbValues) * (valueSize))   /* worst case : raw block */
+
+
+/* *****************************************
+*  FSED advanced functions
+******************************************/
+#define FSED_DEFAULT_TABLELOG 11
+#define FSED_MAX_TABLELOG     12
+#define FSED_LN_AUTO     0xFF
+#define FSED_LN_MAX_U16  4    /* bucket symbols must fit into a byte */
+#define FSED_LN_MAX_U32  3
+
+/* FSED_compressU16_advanced(), FSED_compressU32_advanced() :
+    same as above, with an explicit nb of mantissa bits per bucket ('LN').
+    Larger LN makes buckets more precise, at the cost of a larger alphabet.
+    LN == FSED_LN_AUTO selects the LN minimizing estimated compressed size, using a single scan.
+    LN is stored within block header : decoder doesn't need it. */
+size_t FSED_compressU16_advanced(void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, unsigned tableLog, unsigned LN);
+size_t FSED_compressU32_advanced(void* dst, size_t maxDstSize, const unsigned* src, size_t srcSize, unsigned tableLog, unsigned LN);
+
+
+#if defined (__cplusplus)
+}
+#endif
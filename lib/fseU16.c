@@ -39,9 +39,12 @@
 *  Memory usage formula : N->2^N Bytes (examples : 10 -> 1KB; 12 -> 4KB ; 16 -> 64KB; 20 -> 1MB; etc.)
 *  Increasing memory usage improves compression ratio
 *  Reduced memory usage can improve speed, due to cache effect
-*  Recommended max value is 14, for 16KB, which nicely fits into Intel x86 L1 cache */
-#define FSE_MAX_MEMORY_USAGE 14
+*  Recommended max value is 14, for 16KB, which nicely fits into Intel x86 L1 cache
+*  U16 tables can reach 16 (tableLog 14), since large alphabets need more states to be represented accurately.
+*  Only FSE_U16ctx tables use this size : one-shot functions allocate on stack, and stay within FSE_U16_STACK_TABLELOG */
+#define FSE_MAX_MEMORY_USAGE 16
 #define FSE_DEFAULT_MEMORY_USAGE 13
+#define FSE_U16_STACK_TABLELOG 12
 
 
 /****************************************************************
@@ -86,6 +89,10 @@ typedef struct
 #define FSE_FUNCTION_EXTENSION U16
 #include "fse.c"   /* FSE_countU16, FSE_buildCTableU16, FSE_buildDTableU16 */
 
+typedef U32 CTableU16_stack_t[FSE_CTABLE_SIZE_U32(FSE_U16_STACK_TABLELOG, FSE_MAX_SYMBOL_VALUE)];
+typedef U32 DTableU16_stack_t[FSE_DTABLE_SIZE_U32(FSE_U16_STACK_TABLELOG)];
+typedef U32 CTableU16_stack_wksp_t[(FSE_BUILD_CTABLE_WKSP_SIZE(FSE_U16_STACK_TABLELOG, FSE_MAX_SYMBOL_VALUE) + sizeof(U32) - 1) / sizeof(U32)];
+
 
 /*********************************************************
 *  U16 Compression functions
@@ -101,10 +108,12 @@ size_t FSE_compressU16_usingCTable (void* dst, size_t maxDstSize,
     BYTE* op = (BYTE*) dst;
     BIT_CStream_t bitC;
     FSE_CState_t CState;
+    size_t errorCode;
 
 
     /* init */
-    BIT_initCStream(&bitC, op, maxDstSize);
+    errorCode = BIT_initCStream(&bitC, op, maxDstSize);
+    if (FSE_isError(errorCode)) return 0;
     FSE_initCState(&CState, ct);
 
     ip=iend;
@@ -120,6 +129,8 @@ size_t FSE_compressU16_usingCTable (void* dst, size_t maxDstSize,
     if (srcSize & 2)
     {
         FSE_encodeSymbol(&bitC, &CState, *--ip);
+        if (sizeof(size_t)*8 < FSE_MAX_TABLELOG*2+7 )   /* This test must be static */
+            BIT_flushBits(&bitC);
         FSE_encodeSymbol(&bitC, &CState, *--ip);
         BIT_flushBits(&bitC);
     }
@@ -150,7 +161,7 @@ size_t FSE_compressU16_usingCTable (void* dst, size_t maxDstSize,
 
 size_t FSE_compressU16(void* dst, size_t maxDstSize,
        const unsigned short* src, size_t srcSize,
-       unsigned maxSymbolValue, unsigned tableLog)
+       unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
 {
     const U16* const istart = src;
     const U16* ip = istart;
@@ -161,7 +172,8 @@ size_t FSE_compressU16(void* dst, size_t maxDstSize,
 
     U32   counting[FSE_MAX_SYMBOL_VALUE+1] = {0};
     S16   norm[FSE_MAX_SYMBOL_VALUE+1];
-    CTable_max_t ct;
+    CTableU16_stack_t ct;
+    CTableU16_stack_wksp_t wksp;
 
     size_t   errorCode;
 
@@ -171,7 +183,7 @@ size_t FSE_compressU16(void* dst, size_t maxDstSize,
     if (!maxSymbolValue) maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
     if (!tableLog) tableLog = FSE_DEFAULT_TABLELOG;
     if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
-    if (tableLog > FSE_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    if (tableLog > FSE_U16_STACK_TABLELOG) return ERROR(tableLog_tooLarge);
 
     /* Scan for stats */
     errorCode = FSE_countU16 (counting, &maxSymbolValue, ip, srcSize);
@@ -189,9 +201,118 @@ size_t FSE_compressU16(void* dst, size_t maxDstSize,
     op += errorCode;
 
     /* Compress */
-    errorCode = FSE_buildCTableU16 (ct, norm, maxSymbolValue, tableLog, 1);
+    errorCode = FSE_buildCTable_wkspU16 (ct, norm, maxSymbolValue, tableLog, scrambler, wksp, sizeof(wksp));
+    if (FSE_isError(errorCode)) return errorCode;
+    errorCode = FSE_compressU16_usingCTable (op, omax - op, ip, srcSize, ct);
+    if (errorCode == 0) return 0;   /* not enough space for compressed data */
+    op += errorCode;
+
+    /* check compressibility */
+    if ( (size_t)(op-ostart) >= (size_t)(srcSize-1)*(sizeof(U16)) )
+        return 0;   /* no compression */
+
+    return op-ostart;
+}
+
+
+/* X4 : 4 interleaved states within a single bitstream.
+   Symbol n is encoded with state (n & 3), so the decoder can keep 4 independent decoding chains in flight */
+size_t FSE_compressU16X4_usingCTable (void* dst, size_t maxDstSize,
+                              const U16*  src, size_t srcSize,
+                              const FSE_CTable* ct)
+{
+    const U16* const istart = src;
+    const U16* ip = istart + srcSize;
+    BIT_CStream_t bitC;
+    FSE_CState_t CState0, CState1, CState2, CState3;
+    size_t errorCode;
+
+    /* init */
+    errorCode = BIT_initCStream(&bitC, dst, maxDstSize);
+    if (FSE_isError(errorCode)) return 0;
+    FSE_initCState(&CState0, ct);
+    FSE_initCState(&CState1, ct);
+    FSE_initCState(&CState2, ct);
+    FSE_initCState(&CState3, ct);
+
+    /* join to mod 4 */
+    if ((srcSize & 3) >= 3) { FSE_encodeSymbol(&bitC, &CState2, *--ip); BIT_flushBits(&bitC); }
+    if ((srcSize & 3) >= 2) { FSE_encodeSymbol(&bitC, &CState1, *--ip); BIT_flushBits(&bitC); }
+    if ((srcSize & 3) >= 1) { FSE_encodeSymbol(&bitC, &CState0, *--ip); BIT_flushBits(&bitC); }
+
+    /* 4 symbols per loop */
+    while (ip>istart)
+    {
+        FSE_encodeSymbol(&bitC, &CState3, *--ip);
+
+        if (sizeof(size_t)*8 < FSE_MAX_TABLELOG*2+7 )   /* This test must be static */
+            BIT_flushBits(&bitC);
+
+        FSE_encodeSymbol(&bitC, &CState2, *--ip);
+
+        if (sizeof(size_t)*8 < FSE_MAX_TABLELOG*4+7 )   /* This test must be static */
+            BIT_flushBits(&bitC);
+
+        FSE_encodeSymbol(&bitC, &CState1, *--ip);
+
+        if (sizeof(size_t)*8 < FSE_MAX_TABLELOG*2+7 )   /* This test must be static */
+            BIT_flushBits(&bitC);
+
+        FSE_encodeSymbol(&bitC, &CState0, *--ip);
+        BIT_flushBits(&bitC);
+    }
+
+    /* last flushed state is first read */
+    FSE_flushCState(&bitC, &CState3);
+    FSE_flushCState(&bitC, &CState2);
+    FSE_flushCState(&bitC, &CState1);
+    FSE_flushCState(&bitC, &CState0);
+    return BIT_closeCStream(&bitC);
+}
+
+
+size_t FSE_compressU16X4(void* dst, size_t maxDstSize,
+       const unsigned short* src, size_t srcSize,
+       unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler)
+{
+    BYTE* const ostart = (BYTE*) dst;
+    BYTE* op = ostart;
+    BYTE* const omax = ostart + maxDstSize;
+
+    U32   counting[FSE_MAX_SYMBOL_VALUE+1];
+    S16   norm[FSE_MAX_SYMBOL_VALUE+1];
+    CTableU16_stack_t ct;
+    CTableU16_stack_wksp_t wksp;
+    size_t errorCode;
+
+    /* early out */
+    if (srcSize <= 1) return srcSize;
+    if (!maxSymbolValue) maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
+    if (!tableLog) tableLog = FSE_DEFAULT_TABLELOG;
+    if (maxSymbolValue > FSE_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+    if (tableLog > FSE_U16_STACK_TABLELOG) return ERROR(tableLog_tooLarge);
+
+    /* Scan for stats */
+    errorCode = FSE_countU16 (counting, &maxSymbolValue, src, srcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    if (errorCode == srcSize) return 1;   /* Input data is one constant element x srcSize times. Use RLE compression. */
+
+    /* Normalize */
+    tableLog = FSE_optimalTableLog(tableLog, srcSize, maxSymbolValue);
+    errorCode = FSE_normalizeCount (norm, tableLog, counting, srcSize, maxSymbolValue);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    /* Write table description header */
+    errorCode = FSE_writeNCount (op, omax-op, norm, maxSymbolValue, tableLog);
+    if (FSE_isError(errorCode)) return errorCode;
+    op += errorCode;
+
+    /* Compress */
+    errorCode = FSE_buildCTable_wkspU16 (ct, norm, maxSymbolValue, tableLog, scrambler, wksp, sizeof(wksp));
     if (FSE_isError(errorCode)) return errorCode;
-    op += FSE_compressU16_usingCTable (op, omax - op, ip, srcSize, ct);
+    errorCode = FSE_compressU16X4_usingCTable (op, omax - op, src, srcSize, ct);
+    if (errorCode == 0) return 0;   /* not enough space for compressed data */
+    op += errorCode;
 
     /* check compressibility */
     if ( (size_t)(op-ostart) >= (size_t)(srcSize-1)*(sizeof(U16)) )
@@ -230,29 +351,127 @@ size_t FSE_decompressU16_usingDTable (U16* dst, size_t maxDstSize,
     BIT_DStream_t bitD;
     FSE_DState_t state;
 
+    size_t errorCode;
+
     /* Init */
-    memset(&bitD, 0, sizeof(bitD));
-    BIT_initDStream(&bitD, cSrc, cSrcSize);
+    errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
     FSE_initDState(&state, &bitD, dt);
 
-    while((BIT_reloadDStream(&bitD) < 2) && (op<oend))
+    /* last symbols may not consume any bit : stream ends when state is back to its initial value */
+    while (op<oend)
     {
+        const unsigned status = BIT_reloadDStream(&bitD);
+        if (status > BIT_DStream_completed) break;
+        if ((status == BIT_DStream_completed) && FSE_endOfDState(&state)) break;
         *op++ = FSE_decodeSymbolU16(&state, &bitD);
     }
 
-    if (!BIT_endOfDStream(&bitD)) return ERROR(GENERIC);
+    /* end ? */
+    if (BIT_endOfDStream(&bitD) && FSE_endOfDState(&state))
+        return op-ostart;
 
-    return op-ostart;
+    if (op==oend) return ERROR(dstSize_tooSmall);   /* dst buffer is full, but cSrc unfinished */
+
+    return ERROR(corruption_detected);
+}
+
+
+U16 FSE_decodeSymbolFastU16(FSE_DState_t* DStatePtr, BIT_DStream_t* bitD)
+{
+    const FSE_decode_tU16 DInfo = ((const FSE_decode_tU16*)(DStatePtr->table))[DStatePtr->state];
+    const U32 nbBits = DInfo.nbBits;
+    const U16 symbol = (U16)(DInfo.symbol);
+    const size_t lowBits = BIT_readBitsFast(bitD, nbBits);
+    DStatePtr->state = DInfo.newState + lowBits;
+    return symbol;
+}
+
+FORCE_INLINE size_t FSE_decompressU16X4_usingDTable_generic(
+          U16* dst, size_t maxDstSize,
+    const void* cSrc, size_t cSrcSize,
+    const FSE_DTable* dt, const unsigned fast)
+{
+    U16* const ostart = dst;
+    U16* op = ostart;
+    U16* const oend = ostart + maxDstSize;
+    U16* const olimit = oend-3;
+    BIT_DStream_t bitD;
+    FSE_DState_t state0, state1, state2, state3;
+    size_t errorCode;
+
+    /* Init */
+    errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    FSE_initDState(&state0, &bitD, dt);
+    FSE_initDState(&state1, &bitD, dt);
+    FSE_initDState(&state2, &bitD, dt);
+    FSE_initDState(&state3, &bitD, dt);
+
+#define FSE_GETSYMBOLU16(statePtr) fast ? FSE_decodeSymbolFastU16(statePtr, &bitD) : FSE_decodeSymbolU16(statePtr, &bitD)
+
+    /* 4 symbols per loop */
+    for ( ; (BIT_reloadDStream(&bitD)==BIT_DStream_unfinished) && (op<olimit) ; op+=4)
+    {
+        op[0] = FSE_GETSYMBOLU16(&state0);
+
+        if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            BIT_reloadDStream(&bitD);
+
+        op[1] = FSE_GETSYMBOLU16(&state1);
+
+        if (FSE_MAX_TABLELOG*4+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            BIT_reloadDStream(&bitD);
+
+        op[2] = FSE_GETSYMBOLU16(&state2);
+
+        if (FSE_MAX_TABLELOG*2+7 > sizeof(bitD.bitContainer)*8)    /* This test must be static */
+            BIT_reloadDStream(&bitD);
+
+        op[3] = FSE_GETSYMBOLU16(&state3);
+    }
+
+    /* tail : states keep their round-robin order; stream ends when the next state to use is back to its initial value */
+#define FSE_TAILU16(statePtr) \
+    if ( (BIT_reloadDStream(&bitD)>BIT_DStream_completed) || (op==oend) || (BIT_endOfDStream(&bitD) && (fast || FSE_endOfDState(statePtr))) ) \
+        break; \
+    *op++ = FSE_GETSYMBOLU16(statePtr)
+
+    while (1)
+    {
+        FSE_TAILU16(&state0);
+        FSE_TAILU16(&state1);
+        FSE_TAILU16(&state2);
+        FSE_TAILU16(&state3);
+    }
+
+    /* end ? */
+    if (BIT_endOfDStream(&bitD) && FSE_endOfDState(&state0) && FSE_endOfDState(&state1)
+        && FSE_endOfDState(&state2) && FSE_endOfDState(&state3))
+        return op-ostart;
+
+    if (op==oend) return ERROR(dstSize_tooSmall);   /* dst buffer is full, but cSrc unfinished */
+
+    return ERROR(corruption_detected);
+}
+
+size_t FSE_decompressU16X4_usingDTable (U16* dst, size_t maxDstSize,
+                               const void* cSrc, size_t cSrcSize,
+                               const FSE_DTable* dt)
+{
+    const FSE_DTableHeader* DTableH = (const FSE_DTableHeader*)dt;
+    if (DTableH->fastMode) return FSE_decompressU16X4_usingDTable_generic(dst, maxDstSize, cSrc, cSrcSize, dt, 1);
+    return FSE_decompressU16X4_usingDTable_generic(dst, maxDstSize, cSrc, cSrcSize, dt, 0);
 }
 
 
 size_t FSE_decompressU16(U16* dst, size_t maxDstSize,
-                  const void* cSrc, size_t cSrcSize)
+                  const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     const BYTE* const istart = (const BYTE*) cSrc;
     const BYTE* ip = istart;
     short   counting[FSE_MAX_SYMBOL_VALUE+1];
-    DTable_max_t dt;
+    DTableU16_stack_t dt;
     unsigned maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
     unsigned tableLog;
     size_t errorCode;
@@ -263,11 +482,214 @@ size_t FSE_decompressU16(U16* dst, size_t maxDstSize,
     /* normal FSE decoding mode */
     errorCode = FSE_readNCount (counting, &maxSymbolValue, &tableLog, istart, cSrcSize);
     if (FSE_isError(errorCode)) return errorCode;
+    if (tableLog > FSE_U16_STACK_TABLELOG) return ERROR(tableLog_tooLarge);
     ip += errorCode;
     cSrcSize -= errorCode;
-	unsigned scrambler = 1;
     errorCode = FSE_buildDTableU16 (dt, counting, maxSymbolValue, tableLog, scrambler);
     if (FSE_isError(errorCode)) return errorCode;
 
     return FSE_decompressU16_usingDTable (dst, maxDstSize, ip, cSrcSize, dt);
 }
+
+
+size_t FSE_decompressU16X4(U16* dst, size_t maxDstSize,
+                  const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    const BYTE* const istart = (const BYTE*) cSrc;
+    const BYTE* ip = istart;
+    short   counting[FSE_MAX_SYMBOL_VALUE+1];
+    DTableU16_stack_t dt;
+    unsigned maxSymbolValue = FSE_MAX_SYMBOL_VALUE;
+    unsigned tableLog;
+    size_t errorCode;
+
+    /* Sanity check */
+    if (cSrcSize<2) return ERROR(srcSize_wrong);   /* specific corner cases (uncompressed & rle) */
+
+    /* normal FSE decoding mode */
+    errorCode = FSE_readNCount (counting, &maxSymbolValue, &tableLog, istart, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);   /* too small input size */
+    if (tableLog > FSE_U16_STACK_TABLELOG) return ERROR(tableLog_tooLarge);
+    ip += errorCode;
+    cSrcSize -= errorCode;
+    errorCode = FSE_buildDTableU16 (dt, counting, maxSymbolValue, tableLog, scrambler);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    return FSE_decompressU16X4_usingDTable (dst, maxDstSize, ip, cSrcSize, dt);
+}
+
+
+/*********************************************************
+*  U16 context : runtime-sized alphabets
+*********************************************************/
+struct FSE_U16ctx_s
+{
+    unsigned maxSymbolValue;
+    unsigned maxTableLog;
+    U32* count;
+    U32* denseCount;   /* count of present symbols only */
+    U16* symbols;      /* present symbol values, in increasing order */
+    S16* norm;
+    S16* denseNorm;
+    FSE_CTable* ct;
+    FSE_DTable* dt;
+    U32* workSpace;
+    size_t wkspSize;
+};
+
+#define FSE_U16CTX_ALIGN32(n) (((n) + sizeof(U32) - 1) / sizeof(U32))   /* size in U32 */
+
+FSE_U16ctx* FSE_createU16ctx_advanced(unsigned maxSymbolValue, unsigned maxTableLog, FSE_customMem customMem)
+{
+    FSE_U16ctx* ctx;
+    U32* ptr;
+    size_t nbSymbols, wkspSize, totalSize;
+
+    FSE_STATIC_ASSERT(FSE_U16_TABLELOG_LIMIT == FSE_MAX_TABLELOG);
+    FSE_STATIC_ASSERT(FSE_U16_SYMBOL_VALUE_LIMIT < (1 << 12));   /* FSE_decode_tU16.symbol is 12 bits */
+    if (maxSymbolValue > FSE_U16_SYMBOL_VALUE_LIMIT) return NULL;
+    if (maxTableLog == 0) maxTableLog = FSE_U16_TABLELOG_LIMIT;
+    if (maxTableLog > FSE_U16_TABLELOG_LIMIT) return NULL;
+    if (maxTableLog < FSE_MIN_TABLELOG) maxTableLog = FSE_MIN_TABLELOG;
+    nbSymbols = maxSymbolValue + 1;
+
+    /* workSpace is shared by counting, CTable and DTable building */
+    wkspSize = 4 * nbSymbols * sizeof(U32);
+    if (FSE_BUILD_CTABLE_WKSP_SIZE(maxTableLog, maxSymbolValue) > wkspSize) wkspSize = FSE_BUILD_CTABLE_WKSP_SIZE(maxTableLog, maxSymbolValue);
+    wkspSize = FSE_U16CTX_ALIGN32(wkspSize) * sizeof(U32);
+
+    totalSize = FSE_U16CTX_ALIGN32(sizeof(FSE_U16ctx))
+              + 2 * nbSymbols                                  /* count, denseCount */
+              + 3 * FSE_U16CTX_ALIGN32(nbSymbols * sizeof(U16)) /* symbols, norm, denseNorm */
+              + FSE_CTABLE_SIZE_U32(maxTableLog, maxSymbolValue)
+              + FSE_DTABLE_SIZE_U32(maxTableLog);
+    totalSize = totalSize * sizeof(U32) + wkspSize;
+
+    ctx = (FSE_U16ctx*)FSE_malloc(totalSize, customMem);
+    if (ctx == NULL) return NULL;
+    ptr = (U32*)ctx + FSE_U16CTX_ALIGN32(sizeof(FSE_U16ctx));
+
+    ctx->maxSymbolValue = maxSymbolValue;
+    ctx->maxTableLog = maxTableLog;
+    ctx->count = ptr;       ptr += nbSymbols;
+    ctx->denseCount = ptr;  ptr += nbSymbols;
+    ctx->symbols = (U16*)ptr;   ptr += FSE_U16CTX_ALIGN32(nbSymbols * sizeof(U16));
+    ctx->norm = (S16*)ptr;      ptr += FSE_U16CTX_ALIGN32(nbSymbols * sizeof(U16));
+    ctx->denseNorm = (S16*)ptr; ptr += FSE_U16CTX_ALIGN32(nbSymbols * sizeof(U16));
+    ctx->ct = (FSE_CTable*)ptr; ptr += FSE_CTABLE_SIZE_U32(maxTableLog, maxSymbolValue);
+    ctx->dt = (FSE_DTable*)ptr; ptr += FSE_DTABLE_SIZE_U32(maxTableLog);
+    ctx->workSpace = ptr;
+    ctx->wkspSize = wkspSize;
+    return ctx;
+}
+
+FSE_U16ctx* FSE_createU16ctx(unsigned maxSymbolValue, unsigned maxTableLog)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return FSE_createU16ctx_advanced(maxSymbolValue, maxTableLog, defaultMem);
+}
+
+void FSE_freeU16ctx(FSE_U16ctx* ctx)
+{
+    FSE_free(ctx);
+}
+
+
+/* FSE_normalizeSparseU16() :
+   normalizes ctx->count over present symbols only, then spreads the result into ctx->norm.
+   The number of present symbols, instead of maxSymbolValue, sets the minimum tableLog,
+   and normalization cost no longer depends on alphabet size.
+   @return : selected tableLog, or an error code */
+static size_t FSE_normalizeSparseU16(FSE_U16ctx* ctx, unsigned tableLog, size_t total, unsigned maxSymbolValue)
+{
+    U32 nbSymbols = 0;
+    U32 s;
+    size_t errorCode;
+
+    for (s=0; s<=maxSymbolValue; s++)
+    {
+        if (ctx->count[s] == 0) continue;
+        ctx->symbols[nbSymbols] = (U16)s;
+        ctx->denseCount[nbSymbols++] = ctx->count[s];
+    }
+
+    tableLog = FSE_optimalTableLog_withLimit(tableLog, total, nbSymbols-1, FSE_U16_TABLELOG_LIMIT);
+    if (tableLog > ctx->maxTableLog) return ERROR(tableLog_tooLarge);   /* too many present symbols for this context */
+    errorCode = FSE_normalizeCount_withLimit(ctx->denseNorm, tableLog, ctx->denseCount, total, nbSymbols-1, ctx->maxTableLog);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    memset(ctx->norm, 0, (maxSymbolValue+1) * sizeof(S16));
+    for (s=0; s<nbSymbols; s++)
+        ctx->norm[ctx->symbols[s]] = ctx->denseNorm[s];
+
+    return tableLog;
+}
+
+size_t FSE_compressU16_usingCtx(FSE_U16ctx* ctx, void* dst, size_t maxDstSize,
+                          const unsigned short* src, size_t srcSize, unsigned tableLog, unsigned scrambler)
+{
+    BYTE* const ostart = (BYTE*) dst;
+    BYTE* op = ostart;
+    BYTE* const omax = ostart + maxDstSize;
+    unsigned maxSymbolValue = ctx->maxSymbolValue;
+    size_t errorCode;
+
+    /* early out */
+    if (srcSize <= 1) return srcSize;
+    if (!tableLog) tableLog = FSE_DEFAULT_TABLELOG;
+    if (tableLog > ctx->maxTableLog) return ERROR(tableLog_tooLarge);
+
+    /* Scan for stats */
+    errorCode = FSE_count_wkspU16 (ctx->count, &maxSymbolValue, src, srcSize, 1, ctx->workSpace);
+    if (FSE_isError(errorCode)) return errorCode;
+    if (errorCode == srcSize) return 1;   /* Input data is one constant element x srcSize times. Use RLE compression. */
+
+    /* Normalize */
+    errorCode = FSE_normalizeSparseU16 (ctx, tableLog, srcSize, maxSymbolValue);
+    if (FSE_isError(errorCode)) return errorCode;
+    tableLog = (unsigned)errorCode;
+
+    /* Write table description header */
+    errorCode = FSE_writeNCount_withLimit (op, omax-op, ctx->norm, maxSymbolValue, tableLog, ctx->maxTableLog);
+    if (FSE_isError(errorCode)) return errorCode;
+    op += errorCode;
+
+    /* Compress */
+    errorCode = FSE_buildCTable_wkspU16 (ctx->ct, ctx->norm, maxSymbolValue, tableLog, scrambler, ctx->workSpace, ctx->wkspSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    errorCode = FSE_compressU16X4_usingCTable (op, omax - op, src, srcSize, ctx->ct);
+    if (errorCode == 0) return 0;   /* not enough space for compressed data */
+    op += errorCode;
+
+    /* check compressibility */
+    if ( (size_t)(op-ostart) >= (size_t)(srcSize-1)*(sizeof(U16)) )
+        return 0;   /* no compression */
+
+    return op-ostart;
+}
+
+size_t FSE_decompressU16_usingCtx(FSE_U16ctx* ctx, unsigned short* dst, size_t maxDstSize,
+                            const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    const BYTE* const istart = (const BYTE*) cSrc;
+    const BYTE* ip = istart;
+    unsigned maxSymbolValue = ctx->maxSymbolValue;
+    unsigned tableLog;
+    size_t errorCode;
+
+    /* Sanity check */
+    if (cSrcSize<2) return ERROR(srcSize_wrong);   /* specific corner cases (uncompressed & rle) */
+
+    /* normal FSE decoding mode */
+    errorCode = FSE_readNCount (ctx->norm, &maxSymbolValue, &tableLog, istart, cSrcSize);
+    if (FSE_isError(errorCode)) return errorCode;
+    if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);   /* too small input size */
+    if (tableLog > ctx->maxTableLog) return ERROR(tableLog_tooLarge);
+    ip += errorCode;
+    cSrcSize -= errorCode;
+    errorCode = FSE_buildDTable_wkspU16 (ctx->dt, ctx->norm, maxSymbolValue, tableLog, scrambler, ctx->workSpace, ctx->wkspSize);
+    if (FSE_isError(errorCode)) return errorCode;
+
+    return FSE_decompressU16X4_usingDTable (dst, maxDstSize, ip, cSrcSize, ctx->dt);
+}
@@ -52,6 +52,7 @@ extern "C" {
 *  Includes
 ******************************************/
 #include <stddef.h>    /* size_t, ptrdiff_t */
+#include "fse.h"       /* FSE_CTable, FSE_DTable, FSE_isError, NCount functions */
 
 
 /******************************************
@@ -63,14 +64,97 @@ extern "C" {
    which is useful for alphabet size > 256.
    Important ! All symbol values within input table must be <= 'maxSymbolValue'.
    Maximum allowed 'maxSymbolValue' is controlled by constant FSE_MAX_SYMBOL_VALUE
+   'scrambler' has the same meaning as for FSE_compress() : it must be identical on both sides (0 == no scrambling).
    Special values : if result == 0, data is not compressible => Nothing is stored within cSrc !!
                     if result == 1, data is one constant element x srcSize times. Use RLE compression.
                     if FSE_isError(result), it's an error code.*/
 size_t FSE_compressU16(void* dst, size_t maxDstSize,
        const unsigned short* src, size_t srcSize,
-       unsigned maxSymbolValue, unsigned tableLog);
+       unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
 
-size_t FSE_decompressU16(unsigned short* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize);
+size_t FSE_decompressU16(unsigned short* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+
+/* FSE_compressU16X4, FSE_decompressU16X4 :
+   same as above, but the bitstream interleaves 4 FSE states instead of 1,
+   so that the decoder can overlap 4 independent decoding chains.
+   Faster to decode, for a compressed size within a few bytes of FSE_compressU16().
+   Note : this is a different format, data must be decoded with the matching function. */
+size_t FSE_compressU16X4(void* dst, size_t maxDstSize,
+       const unsigned short* src, size_t srcSize,
+       unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+
+size_t FSE_decompressU16X4(unsigned short* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+
+
+/******************************************
+*  FSE U16 advanced functions
+******************************************/
+/* Same workflow as FSE advanced functions (see fse.h tutorial) :
+   tables are built once, then re-used for any number of blocks sharing the same statistics.
+   FSE_normalizeCount(), FSE_optimalTableLog(), FSE_writeNCount() and FSE_readNCount() are shared with the byte version,
+   hence limited to byte tables : larger tables use their _withLimit() variants (see fse_static.h).
+   Restrictions : maxSymbolValue <= FSE_MAX_SYMBOL_VALUE, tableLog <= FSE_U16_TABLELOG_LIMIT */
+
+/* FSE_countU16() :
+   same as FSE_count(), for a table of unsigned short. 'maxSymbolValuePtr[0] == 0' means FSE_MAX_SYMBOL_VALUE */
+size_t FSE_countU16(unsigned* count, unsigned* maxSymbolValuePtr, const unsigned short* src, size_t srcSize);
+
+/* FSE_buildCTableU16() :
+   'ct' is allocated with FSE_createCTable(tableLog, maxSymbolValue), which is common to both versions.
+   return : 0, or an errorCode, which can be tested using FSE_isError() */
+size_t FSE_buildCTableU16(FSE_CTable* ct, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+
+/* FSE_compressU16_usingCTable(), FSE_compressU16X4_usingCTable() :
+   compress 'src' with 'ct', without header, using respectively the 1-state and the 4-states format.
+   return : size of compressed data (<= maxDstSize)
+            or 0 if compressed data could not fit into 'dst' */
+size_t FSE_compressU16_usingCTable  (void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, const FSE_CTable* ct);
+size_t FSE_compressU16X4_usingCTable(void* dst, size_t maxDstSize, const unsigned short* src, size_t srcSize, const FSE_CTable* ct);
+
+/* FSE_createDTableU16(), FSE_buildDTableU16() :
+   U16 decoding tables have their own layout : they must be created with FSE_createDTableU16(),
+   and released with FSE_freeDTableU16().
+   return : 0, or an errorCode, which can be tested using FSE_isError() */
+FSE_DTable* FSE_createDTableU16(unsigned tableLog);
+void        FSE_freeDTableU16(FSE_DTable* dt);
+size_t FSE_buildDTableU16(FSE_DTable* dt, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+
+/* FSE_decompressU16_usingDTable(), FSE_decompressU16X4_usingDTable() :
+   'cSrcSize' must be exact. Format must match the one used for compression.
+   return : nb of symbols regenerated (<= maxDstSize), or an errorCode */
+size_t FSE_decompressU16_usingDTable  (unsigned short* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt);
+size_t FSE_decompressU16X4_usingDTable(unsigned short* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const FSE_DTable* dt);
+
+
+/******************************************
+*  FSE U16 context : large alphabets
+******************************************/
+#define FSE_U16_SYMBOL_VALUE_LIMIT 4095   /* symbol values are stored on 12 bits within decoding tables */
+#define FSE_U16_TABLELOG_LIMIT 14
+
+typedef struct FSE_U16ctx_s FSE_U16ctx;
+
+/* FSE_createU16ctx() :
+   Creates a context for symbol values within [0-maxSymbolValue], and tables up to 2^maxTableLog cells.
+   Contrary to functions above, maxSymbolValue is a runtime parameter : all tables are sized from it, and allocated on heap.
+   maxSymbolValue <= FSE_U16_SYMBOL_VALUE_LIMIT; maxTableLog <= FSE_U16_TABLELOG_LIMIT (0 means FSE_U16_TABLELOG_LIMIT).
+   A context can be re-used for any number of blocks, to compress or decompress.
+   FSE_createU16ctx_advanced() allocates it with customMem instead; FSE_freeU16ctx() releases it with the same allocator.
+   @return : NULL if parameters are out of range, or allocation failed */
+FSE_U16ctx* FSE_createU16ctx(unsigned maxSymbolValue, unsigned maxTableLog);
+FSE_U16ctx* FSE_createU16ctx_advanced(unsigned maxSymbolValue, unsigned maxTableLog, FSE_customMem customMem);
+void        FSE_freeU16ctx(FSE_U16ctx* ctx);
+
+/* FSE_compressU16_usingCtx() :
+   Same result codes as FSE_compressU16(). tableLog==0 means default.
+   Statistics are normalized over present symbols only, so sparse large alphabets remain cheap to describe,
+   and only the number of present symbols (not maxSymbolValue) may require a larger tableLog.
+   Output uses FSE_compressU16X4() format : FSE_decompressU16X4() can decode it when maxSymbolValue <= FSE_MAX_SYMBOL_VALUE and tableLog <= 12. */
+size_t FSE_compressU16_usingCtx(FSE_U16ctx* ctx, void* dst, size_t maxDstSize,
+                          const unsigned short* src, size_t srcSize, unsigned tableLog, unsigned scrambler);
+
+size_t FSE_decompressU16_usingCtx(FSE_U16ctx* ctx, unsigned short* dst, size_t maxDstSize,
+                            const void* cSrc, size_t cSrcSize, unsigned scrambler);
 
 
 
@@ -54,6 +54,10 @@ extern "C" {
 #define FSE_BLOCKBOUND(size) (size + (size>>7))
 #define FSE_COMPRESSBOUND(size) (FSE_NCOUNTBOUND + FSE_BLOCKBOUND(size))   /* Macro version, useful for static allocation */
 
+/* FSE_decompress_inPlace() : the compressed tail of a block can be larger than the data it regenerates by up to 1/3 of the block,
+   since a symbol costs at most 12 bits, and the whole block is smaller than its source */
+#define FSE_INPLACE_MARGIN(size) (((size) / 3) + 16)
+
 /* You can statically allocate FSE CTable/DTable as a table of unsigned using below macro */
 #define FSE_CTABLE_SIZE_U32(maxTableLog, maxSymbolValue)   (1 + (1<<(maxTableLog-1)) + ((maxSymbolValue+1)*2))
 #define FSE_DTABLE_SIZE_U32(maxTableLog)                   (1 + (1<<maxTableLog))
@@ -65,6 +69,17 @@ extern "C" {
 size_t FSE_countFast(unsigned* count, unsigned* maxSymbolValuePtr, const unsigned char* src, size_t srcSize);
 /* same as FSE_count(), but blindly trust that all values within src are <= maxSymbolValuePtr[0] */
 
+unsigned FSE_isIncompressible(const void* src, size_t srcSize);
+/* sampling pre-pass, much faster than FSE_count() : 1 if bytes within src look too evenly distributed to be worth compressing.
+   Always 0 for srcSize < FSE_SAMPLING_MINSIZE (4 KB by default, 0 disables sampling).
+   Used by FSE_compress2_sampled() and HUF_compress2_sampled() */
+
+unsigned FSE_optimalTableLog_withLimit(unsigned tableLog, size_t srcSize, unsigned maxSymbolValue, unsigned tableLogLimit);
+size_t FSE_normalizeCount_withLimit(short* normalizedCounter, unsigned tableLog, const unsigned* count, size_t total, unsigned maxSymbolValue, unsigned tableLogLimit);
+size_t FSE_writeNCount_withLimit(void* buffer, size_t bufferSize, const short* normalizedCounter, unsigned maxSymbolValue, unsigned tableLog, unsigned tableLogLimit);
+/* same as FSE_optimalTableLog(), FSE_normalizeCount() and FSE_writeNCount(), which stay within byte tables (tableLog <= FSE_MAX_TABLELOG, 12 by default),
+   but accept any tableLog up to tableLogLimit (<= 15). Meant for codecs using larger tables, such as FSE_U16ctx */
+
 size_t FSE_buildCTable_raw (FSE_CTable* ct, unsigned nbBits);
 /* build a fake FSE_CTable, designed to not compress an input, where each symbol uses nbBits */
 
@@ -212,6 +227,31 @@ Check also the states. There might be some symbols left there, if some high prob
 */
 
 
+/******************************************
+*  FSE forward streams
+******************************************/
+/*
+By default, the bitStream is read backward : decoding can only start once a block is fully received.
+FSE_reverseStream() converts a compressed block (as produced by FSE_compress*()) so that its bitStream is read forward.
+Converting again restores the original block. Special values 0 and 1 (not compressed, RLE) are left as is.
+return : cSrcSize, or an error code
+
+A forward block can then be decoded incrementally, while it's being received :
+FSE_initForwardDecoding() : starts a new block, of compressed size cSrcSize, regenerating up to maxDstSize bytes into dst
+FSE_decompressForward_continue() : availableSize is the nb of bytes of cSrc received so far (always the same cSrc pointer).
+    return : nb of bytes regenerated so far, at the beginning of dst (final size once availableSize == cSrcSize)
+             or an error code; after an error, block must be started again with FSE_initForwardDecoding()
+*/
+typedef struct FSE_ForwardDCtx_s FSE_ForwardDCtx;   /* incomplete type */
+
+size_t FSE_reverseStream(void* cSrc, size_t cSrcSize);
+FSE_ForwardDCtx* FSE_createForwardDCtx(void);
+FSE_ForwardDCtx* FSE_createForwardDCtx_advanced(FSE_customMem customMem);   /* released by FSE_freeForwardDCtx() with the same allocator */
+size_t FSE_freeForwardDCtx(FSE_ForwardDCtx* fctx);
+size_t FSE_initForwardDecoding(FSE_ForwardDCtx* fctx, void* dst, size_t maxDstSize, size_t cSrcSize, unsigned scrambler);
+size_t FSE_decompressForward_continue(FSE_ForwardDCtx* fctx, const void* cSrc, size_t availableSize);
+
+
 /******************************************
 *  FSE unsafe API
 ******************************************/
@@ -63,9 +63,11 @@
 #include <stdlib.h>     /* malloc, free, qsort */
 #include <string.h>     /* memcpy, memset */
 #include <stdio.h>      /* printf (debug) */
+#include <time.h>       /* clock_t, clock, CLOCKS_PER_SEC (decoder calibration) */
 #include "huff0_static.h"
 #include "bitstream.h"
-#include "fse.h"        /* header compression */
+#include "cpu.h"        /* CPU_DISPATCH_BMI2 */
+#include "fse_static.h" /* header compression, FSE_isIncompressible */
 
 
 /****************************************************************
@@ -89,14 +91,27 @@ const char* HUF_getErrorName(size_t code) { return ERR_getErrorName(code); }
 #define HUF_MAX_TABLELOG  12           /* max configured tableLog (for static allocation); can be modified up to HUF_ABSOLUTEMAX_TABLELOG */
 #define HUF_DEFAULT_TABLELOG  HUF_MAX_TABLELOG   /* tableLog by default, when not specified */
 #define HUF_MAX_SYMBOL_VALUE 255
+#define HUF_MAX_NB_STREAMS  8
+#define HUF_PAIRS_MINSIZE  (8 * 1024)   /* smaller blocks always encode one symbol at a time */
+#define HUF_PAIRS_COSTRATIO 8           /* pair table is used if nbPresentSymbols^2 <= srcSize / HUF_PAIRS_COSTRATIO */
+#define HUF_NB_STREAMS(size) ((size) >= HUF_8STREAMS_MINSIZE ? 8 : (size) >= HUF_4STREAMS_MINSIZE ? 4 : 1)   /* layout selected by compressor, from block size */
+#define HUF_JUMP_SIZE(size) ((size) > HUF_SMALLBLOCK_MAX ? 4 : 2)   /* bytes per jump table entry : large blocks store 32-bit segment sizes */
+#define HUF_JUMPTABLE_SIZE(nbStreams, jumpSize) (((nbStreams)-1) * (jumpSize))
+#define HUF_STREAMBOUND(size) ((size)*HUF_MAX_TABLELOG/8 + 8)   /* worst case bitStream size : all symbols at max code length */
+#define HUF_REPEAT_HEADER 241   /* header byte : same table as previous block (never generated by HUF_writeCTable()) */
+#define HUF_1STREAM_HEADER  0   /* layout byte, before table header : body is a single stream (never generated by HUF_writeCTable()) */
+#define HUF_8STREAMS_HEADER 1   /* layout byte, before table header : body made of 8 streams (never generated by HUF_writeCTable()) */
 #if (HUF_MAX_TABLELOG > HUF_ABSOLUTEMAX_TABLELOG)
 #  error "HUF_MAX_TABLELOG is too large !"
 #endif
+#if (HUF_BLOCKSIZE_MAX >= (1U<<30))
+#  error "HUF_BLOCKSIZE_MAX is too large : tree node counts must stay below 1<<30"
+#endif
 
-typedef struct HUF_CElt_s {
+struct HUF_CElt_s {
   U16  val;
   BYTE nbBits;
-} HUF_CElt ;
+};   /* typedef'd to HUF_CElt within huff0_static.h */
 
 typedef struct nodeElt_s {
     U32 count;
@@ -105,6 +120,28 @@ typedef struct nodeElt_s {
     BYTE nbBits;
 } nodeElt;
 
+/* HUF_keyedOrder() :
+   order in which symbols of a same code length receive their codes.
+   scrambler==0 : symbol order (canonical codes); otherwise a permutation derived from scrambler.
+   Encoder (HUF_scrambleCTable()) and decoding tables iterate symbols in this order,
+   so keyed codes cost nothing at decoding time */
+static void HUF_keyedOrder(BYTE* order, unsigned scrambler)
+{
+    U32 rand = scrambler;
+    U32 n;
+    for (n=0; n<=HUF_MAX_SYMBOL_VALUE; n++) order[n] = (BYTE)n;
+    if (scrambler == 0) return;
+    for (n=HUF_MAX_SYMBOL_VALUE; n>0; n--)   /* Fisher-Yates, driven by xorshift32 */
+    {
+        const BYTE tmp = order[n];
+        U32 j;
+        rand ^= rand << 13; rand ^= rand >> 17; rand ^= rand << 5;
+        j = (U32)(((U64)rand * (n+1)) >> 32);
+        order[n] = order[j];
+        order[j] = tmp;
+    }
+}
+
 /*! HUF_writeCTable() :
     @dst : destination buffer
     @CTable : huffman tree to save, using huff0 representation
@@ -185,18 +222,21 @@ static U32 HUF_setMaxHeight(nodeElt* huffNode, U32 lastNonNull, U32 maxNbBits)
 
     // now we have a few too large elements (at least >= 2)
     {
-        const U32 baseCost = 1 << (largestBits - maxNbBits);
+        /* large blocks (> HUF_SMALLBLOCK_MAX) allow trees deeper than maxNbBits + 31 : cost is accumulated on 64 bits */
+        const U32 depthExcess = largestBits - maxNbBits;
+        const U64 baseCost = (U64)1 << depthExcess;
+        U64 excessCost = 0;
         U32 n = lastNonNull;
 
         while (huffNode[n].nbBits > maxNbBits)
         {
-            totalCost += baseCost - (1 << (largestBits - huffNode[n].nbBits));
+            excessCost += baseCost - ((U64)1 << (largestBits - huffNode[n].nbBits));
             huffNode[n].nbBits = (BYTE)maxNbBits;
             n --;
         }
 
         /* renorm totalCost */
-        totalCost >>= (largestBits - maxNbBits);  /* note : totalCost necessarily multiple of baseCost */
+        totalCost = (int)(excessCost >> depthExcess);  /* note : excessCost necessarily multiple of baseCost; result < nb of symbols */
 
         // repay cost
         while (huffNode[n].nbBits == maxNbBits) n--;   // n at last of rank (maxNbBits-1)
@@ -206,9 +246,10 @@ static U32 HUF_setMaxHeight(nodeElt* huffNode, U32 lastNonNull, U32 maxNbBits)
             // Get pos of last (smallest) symbol per rank
             U32 rankLast[HUF_MAX_TABLELOG];
             U32 currentNbBits = maxNbBits;
+            const U32 smallestBits = huffNode[0].nbBits;
             int pos;
 			memset(rankLast, 0xF0, sizeof(rankLast));
-            for (pos=n ; pos >= 0; pos--)
+            for (pos=n ; (pos >= 0) && (currentNbBits > smallestBits); pos--)   /* nbBits grow with pos : stop at smallest rank */
             {
                 if (huffNode[pos].nbBits >= currentNbBits) continue;
                 currentNbBits = huffNode[pos].nbBits;
@@ -267,32 +308,60 @@ static U32 HUF_setMaxHeight(nodeElt* huffNode, U32 lastNonNull, U32 maxNbBits)
 }
 
 
-typedef struct {
-    U32 base;
-    U32 current;
-} rankPos;
+/* HUF_sort() :
+   sorts symbols by decreasing count, equal counts keeping symbol order.
+   Counting sort into 2*HUF_SORT_EXACT buckets : one per count below HUF_SORT_EXACT (already sorted),
+   then HUF_SORT_EXACT buckets for larger counts, each the finest of 16 per power of 2 or equal width up to max count.
+   An insertion pass finishes the job, only moving elements within these few large buckets.
+   Fills count and byte; parent and nbBits are reset */
+#define HUF_SORT_EXACT_LOG 7
+#define HUF_SORT_EXACT (1 << HUF_SORT_EXACT_LOG)
 
 static void HUF_sort(nodeElt* huffNode, const U32* count, U32 maxSymbolValue)
 {
-    rankPos rank[32];
-    U32 n;
+    U32 bucketPos[2*HUF_SORT_EXACT];
+    BYTE bucket[HUF_MAX_SYMBOL_VALUE+1];
+    U32 n, nbLarge, maxCount = 0, shift = 0, total = 0;
+
+    for (n=0; n<=maxSymbolValue; n++) if (count[n] > maxCount) maxCount = count[n];
+    if (maxCount >= 2*HUF_SORT_EXACT) shift = BIT_highbit32(maxCount - HUF_SORT_EXACT) + 1 - HUF_SORT_EXACT_LOG;   /* (maxCount - HUF_SORT_EXACT) >> shift < HUF_SORT_EXACT */
 
-    memset(rank, 0, sizeof(rank));
+    memset(bucketPos, 0, sizeof(bucketPos));
     for (n=0; n<=maxSymbolValue; n++)
     {
-        U32 r = BIT_highbit32(count[n] + 1);
-        rank[r].base ++;
+        const U32 c = count[n];
+        if (c < HUF_SORT_EXACT) bucket[n] = (BYTE)c;
+        else
+        {
+            const U32 highBit = BIT_highbit32(c);   /* >= HUF_SORT_EXACT_LOG */
+            const U32 logBucket = ((highBit - HUF_SORT_EXACT_LOG) << 4) + ((c >> (highBit-4)) & 15);
+            U32 largeBucket = (c - HUF_SORT_EXACT) >> shift;
+            if (logBucket > largeBucket) largeBucket = logBucket;   /* both grow with c */
+            if (largeBucket > HUF_SORT_EXACT-1) largeBucket = HUF_SORT_EXACT-1;
+            bucket[n] = (BYTE)(HUF_SORT_EXACT + largeBucket);
+        }
+        bucketPos[bucket[n]]++;
     }
-    for (n=30; n>0; n--) rank[n-1].base += rank[n].base;
-    for (n=0; n<32; n++) rank[n].current = rank[n].base;
+    for (n=2*HUF_SORT_EXACT; n>HUF_SORT_EXACT; n--) { const U32 b = bucketPos[n-1]; bucketPos[n-1] = total; total += b; }
+    nbLarge = total;
+    for ( ; n>0; n--) { const U32 b = bucketPos[n-1]; bucketPos[n-1] = total; total += b; }
+
     for (n=0; n<=maxSymbolValue; n++)
     {
-        U32 c = count[n];
-        U32 r = BIT_highbit32(c+1) + 1;
-        U32 pos = rank[r].current++;
-        while ((pos > rank[r].base) && (c > huffNode[pos-1].count)) huffNode[pos]=huffNode[pos-1], pos--;
-        huffNode[pos].count = c;
-        huffNode[pos].byte  = (BYTE)n;
+        nodeElt* const node = huffNode + bucketPos[bucket[n]]++;
+        node->count = count[n];
+        node->parent = 0;
+        node->byte = (BYTE)n;
+        node->nbBits = 0;
+    }
+
+    /* large counts : order within buckets */
+    for (n=1; n<nbLarge; n++)
+    {
+        const nodeElt current = huffNode[n];
+        U32 pos = n;
+        while ((pos > 0) && (current.count > huffNode[pos-1].count)) { huffNode[pos] = huffNode[pos-1]; pos--; }
+        huffNode[pos] = current;
     }
 }
 
@@ -310,9 +379,8 @@ size_t HUF_buildCTable (HUF_CElt* tree, const U32* count, U32 maxSymbolValue, U3
     /* safety checks */
     if (maxNbBits == 0) maxNbBits = HUF_DEFAULT_TABLELOG;
     if (maxSymbolValue > HUF_MAX_SYMBOL_VALUE) return ERROR(GENERIC);
-	memset(huffNode0, 0, sizeof(huffNode0));
 
-    // sort, decreasing order
+    // sort, decreasing order (initializes leaves)
     HUF_sort(huffNode, count, maxSymbolValue);
 
     // init for parents
@@ -371,11 +439,96 @@ size_t HUF_buildCTable (HUF_CElt* tree, const U32* count, U32 maxSymbolValue, U3
     return maxNbBits;
 }
 
+size_t HUF_scrambleCTable (HUF_CElt* CTable, unsigned maxSymbolValue, unsigned scrambler)
+{
+    BYTE order[HUF_MAX_SYMBOL_VALUE+1];
+    U16 valPerRank[HUF_MAX_TABLELOG+1];
+    U32 n;
+
+    if (maxSymbolValue > HUF_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+
+    /* starting value within each rank : smallest value in use */
+    for (n=0; n<=HUF_MAX_TABLELOG; n++) valPerRank[n] = 0xFFFF;
+    for (n=0; n<=maxSymbolValue; n++)
+    {
+        const U32 nbBits = CTable[n].nbBits;
+        if (nbBits > HUF_MAX_TABLELOG) return ERROR(GENERIC);
+        if (CTable[n].val < valPerRank[nbBits]) valPerRank[nbBits] = CTable[n].val;
+    }
+
+    /* re-assign values within each rank, in keyed order */
+    HUF_keyedOrder(order, scrambler);
+    for (n=0; n<=HUF_MAX_SYMBOL_VALUE; n++)
+    {
+        const U32 s = order[n];
+        if (s > maxSymbolValue) continue;
+        if (CTable[s].nbBits == 0) continue;
+        CTable[s].val = valPerRank[CTable[s].nbBits]++;
+    }
+    return 0;
+}
+
 static void HUF_encodeSymbol(BIT_CStream_t* bitCPtr, U32 symbol, const HUF_CElt* CTable)
 {
     BIT_addBitsFast(bitCPtr, CTable[symbol].val, CTable[symbol].nbBits);
 }
 
+/* Pair table :
+   present symbols are ranked (rank[symbol] < HUF_PAIRS_MAXSYMBOLS), and table holds one entry per pair of ranks,
+   at (rank[second] << HUF_PAIRS_RANKLOG) + rank[first], first being the byte before second in src.
+   Entries store both codes concatenated in emission order (second byte first, since streams are written backward),
+   as (val << 8) + nbBits. Codes are <= HUF_MAX_TABLELOG bits, so a pair always fits into 32 bits.
+   Table size only depends on HUF_PAIRS_RANKLOG (16 KB), so it lives on stack. */
+#define HUF_PAIRS_RANKLOG 6
+#define HUF_PAIRS_MAXSYMBOLS (1 << HUF_PAIRS_RANKLOG)
+#define HUF_PAIRTABLE_SIZE (1 << (2*HUF_PAIRS_RANKLOG))
+#define HUF_PAIRS_ENABLED (HUF_MAX_TABLELOG*2 + 8 <= 32)
+
+typedef struct {
+    BYTE rank[HUF_MAX_SYMBOL_VALUE+1];
+    U32 table[HUF_PAIRTABLE_SIZE];
+} HUF_PairTable;
+
+/* HUF_buildPairTable() :
+   only ranks present symbols (count[] != 0) and fills entries of their pairs; other entries are left uninitialized.
+   Caller must ensure nbPresent <= HUF_PAIRS_MAXSYMBOLS (see HUF_usePairTable()) */
+static void HUF_buildPairTable(HUF_PairTable* pairTable, const HUF_CElt* CTable, const U32* count, U32 maxSymbolValue)
+{
+    BYTE present[HUF_PAIRS_MAXSYMBOLS];
+    U32 nbPresent = 0, s, i, j;
+    for (s=0; s<=maxSymbolValue; s++)
+        if (count[s]) { pairTable->rank[s] = (BYTE)nbPresent; present[nbPresent++] = (BYTE)s; }
+    for (j=0; j<nbPresent; j++)
+    {
+        const U32 second = present[j];
+        U32* const row = pairTable->table + (j << HUF_PAIRS_RANKLOG);
+        for (i=0; i<nbPresent; i++)
+        {
+            const U32 first = present[i];
+            row[i] = (((U32)CTable[first].val << CTable[second].nbBits) + CTable[second].val) << 8
+                   | (U32)(CTable[first].nbBits + CTable[second].nbBits);
+        }
+    }
+}
+
+/* HUF_usePairTable() :
+   building cost is nbPresent^2 entries : only worth it when amortized over enough symbols */
+static unsigned HUF_usePairTable(const U32* count, U32 maxSymbolValue, size_t srcSize)
+{
+    U32 nbPresent = 0, s;
+    if (!HUF_PAIRS_ENABLED) return 0;
+    if (srcSize < HUF_PAIRS_MINSIZE) return 0;
+    for (s=0; s<=maxSymbolValue; s++) nbPresent += (count[s]!=0);
+    if (nbPresent > HUF_PAIRS_MAXSYMBOLS) return 0;
+    return (nbPresent * nbPresent <= srcSize / HUF_PAIRS_COSTRATIO);
+}
+
+static void HUF_encodePair(BIT_CStream_t* bitCPtr, const BYTE* ip, const HUF_PairTable* pairTable)
+{
+    const U32 elt = pairTable->table[((U32)pairTable->rank[ip[1]] << HUF_PAIRS_RANKLOG) + pairTable->rank[ip[0]]];
+    BIT_addBitsFast(bitCPtr, elt >> 8, elt & 255);
+}
+
 size_t HUF_compressBound(size_t size) { return HUF_COMPRESSBOUND(size); }
 
 #define HUF_FLUSHBITS(s)  (fast ? BIT_flushBitsFast(s) : BIT_flushBits(s))
@@ -386,14 +539,14 @@ size_t HUF_compressBound(size_t size) { return HUF_COMPRESSBOUND(size); }
 #define HUF_FLUSHBITS_2(stream) \
     if (sizeof((stream)->bitContainer)*8 < HUF_MAX_TABLELOG*4+7) HUF_FLUSHBITS(stream)
 
-size_t HUF_compress_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable)
+size_t HUF_compress1X_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable)
 {
     const BYTE* ip = (const BYTE*) src;
     BYTE* const ostart = (BYTE*)dst;
     BYTE* op = ostart;
     BYTE* const oend = ostart + dstSize;
     size_t n;
-    const unsigned fast = (dstSize >= HUF_BLOCKBOUND(srcSize));
+    const unsigned fast = (dstSize >= HUF_STREAMBOUND(srcSize));
     size_t errorCode;
     BIT_CStream_t bitC;
 
@@ -431,53 +584,247 @@ size_t HUF_compress_usingCTable(void* dst, size_t dstSize, const void* src, size
 }
 
 
-static size_t HUF_compress_into4Segments(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable)
+static void HUF_writeJump(BYTE* p, size_t length, U32 jumpSize)
+{
+    if (jumpSize==4) MEM_writeLE32(p, (U32)length);
+    else MEM_writeLE16(p, (U16)length);
+}
+
+/* HUF_compress_streams() :
+   same output as successive HUF_compress1X_usingCTable() on each segment, but all bitstreams advance together,
+   giving nbStreams independent dependency chains. Each stream gets its own region of dst,
+   regions are compacted at the end.
+   With `pairs`, main loop emits 2 symbols per lookup from pairTable (requires `fast`). */
+FORCE_INLINE size_t HUF_compress_streams_generic(void* dst, size_t dstSize, const void* src, size_t srcSize,
+                                           const HUF_CElt* CTable, const HUF_PairTable* pairTable,
+                                           const U32 nbStreams, const unsigned fast, const unsigned pairs)
+{
+    const size_t segmentSize = (srcSize+nbStreams-1) / nbStreams;
+    const size_t lastSize = srcSize - (nbStreams-1)*segmentSize;   /* <= segmentSize */
+    const U32 jumpSize = HUF_JUMP_SIZE(srcSize);
+    const size_t jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
+    const size_t regionSize = (dstSize-jumpTableSize) / nbStreams;
+    const BYTE* ip[HUF_MAX_NB_STREAMS];
+    BYTE* const ostart = (BYTE*) dst;
+    BYTE* const op = ostart + jumpTableSize;
+    BYTE* cEnd = op;
+    BIT_CStream_t bitC[HUF_MAX_NB_STREAMS];
+    size_t n;
+    U32 k;
+
+    /* init */
+    if (regionSize < 8) return 0;   /* not enough space to compress */
+    for (k=0; k<nbStreams; k++)
+    {
+        ip[k] = (const BYTE*)src + k*segmentSize;
+        BIT_initCStream(&bitC[k], op + k*regionSize, regionSize);
+    }
+
+    /* first segments may be longer than last one */
+    for (n=segmentSize; n>lastSize; n--)
+        for (k=0; k<nbStreams-1; k++)
+        {
+            HUF_encodeSymbol(&bitC[k], ip[k][n-1], CTable);
+            HUF_FLUSHBITS(&bitC[k]);
+        }
+
+    /* join to mod 4 */
+    while (n & 3)
+    {
+        n--;
+        for (k=0; k<nbStreams; k++)
+        {
+            HUF_encodeSymbol(&bitC[k], ip[k][n], CTable);
+            HUF_FLUSHBITS(&bitC[k]);
+        }
+    }
+
+    /* streams are independent within each round : out-of-order execution overlaps them */
+    if (pairs)
+        for (; n>0; n-=4)
+            for (k=0; k<nbStreams; k++)
+            {
+                HUF_encodePair(&bitC[k], ip[k]+n-2, pairTable);
+                HUF_FLUSHBITS_2(&bitC[k]);
+                HUF_encodePair(&bitC[k], ip[k]+n-4, pairTable);
+                HUF_FLUSHBITS(&bitC[k]);
+            }
+    for (; n>0; n-=4)   /* note : n&3==0 at this stage */
+        for (k=0; k<nbStreams; k++)
+        {
+            HUF_encodeSymbol(&bitC[k], ip[k][n-1], CTable);
+            HUF_FLUSHBITS_1(&bitC[k]);
+            HUF_encodeSymbol(&bitC[k], ip[k][n-2], CTable);
+            HUF_FLUSHBITS_2(&bitC[k]);
+            HUF_encodeSymbol(&bitC[k], ip[k][n-3], CTable);
+            HUF_FLUSHBITS_1(&bitC[k]);
+            HUF_encodeSymbol(&bitC[k], ip[k][n-4], CTable);
+            HUF_FLUSHBITS(&bitC[k]);
+        }
+
+    /* close streams, compact regions */
+    for (k=0; k<nbStreams; k++)
+    {
+        const size_t cSize = BIT_closeCStream(&bitC[k]);
+        if (cSize==0) return 0;
+        if (k < nbStreams-1) HUF_writeJump(ostart + jumpSize*k, cSize, jumpSize);
+        memmove(cEnd, op + k*regionSize, cSize);
+        cEnd += cSize;
+    }
+
+    return cEnd - ostart;
+}
+
+static size_t HUF_compress_streams(void* dst, size_t dstSize, const void* src, size_t srcSize,
+                                   const HUF_CElt* CTable, const HUF_PairTable* pairTable, U32 nbStreams)
+{
+    const size_t regionSize = (dstSize - HUF_JUMPTABLE_SIZE(nbStreams, HUF_JUMP_SIZE(srcSize))) / nbStreams;
+    const unsigned fast = (regionSize >= HUF_STREAMBOUND((srcSize+nbStreams-1) / nbStreams));   /* a segment can cost more than its share of dst */
+    if (nbStreams==8)
+    {
+        if (fast && pairTable) return HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, pairTable, 8, 1, 1);
+        return fast ? HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, NULL, 8, 1, 0)
+                    : HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, NULL, 8, 0, 0);
+    }
+    if (fast && pairTable) return HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, pairTable, 4, 1, 1);
+    return fast ? HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, NULL, 4, 1, 0)
+                : HUF_compress_streams_generic(dst, dstSize, src, srcSize, CTable, NULL, 4, 0, 0);
+}
+
+static size_t HUF_compress_intoSegments(void* dst, size_t dstSize, const void* src, size_t srcSize,
+                                        const HUF_CElt* CTable, const HUF_PairTable* pairTable, U32 nbStreams)
 {
-    size_t segmentSize = (srcSize+3)/4;   /* first 3 segments */
+    const size_t segmentSize = (srcSize+nbStreams-1) / nbStreams;   /* all segments but last one */
+    const U32 jumpSize = HUF_JUMP_SIZE(srcSize);
+    const size_t jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
     size_t errorCode;
     const BYTE* ip = (const BYTE*) src;
     const BYTE* const iend = ip + srcSize;
     BYTE* const ostart = (BYTE*) dst;
     BYTE* op = ostart;
     BYTE* const oend = ostart + dstSize;
+    U32 k;
 
-    if (dstSize < 6 + 1 + 1 + 1 + 8) return 0;   /* minimum space to compress successfully */
-    if (srcSize < 12) return 0;   /* no saving possible : too small input */
-    op += 6;   /* jumpTable */
+    if (dstSize < jumpTableSize + (nbStreams-1) + 8) return 0;   /* minimum space to compress successfully */
+    if (srcSize < 3*nbStreams) return 0;   /* no saving possible : too small input */
+    errorCode = HUF_compress_streams(dst, dstSize, src, srcSize, CTable, pairTable, nbStreams);
+    if (errorCode) return errorCode;   /* 0 : one region was too small, but segments may still fit sequentially */
+    op += jumpTableSize;
 
-    errorCode = HUF_compress_usingCTable(op, oend-op, ip, segmentSize, CTable);
-    if (HUF_isError(errorCode)) return errorCode;
-    if (errorCode==0) return 0;
-    MEM_writeLE16(ostart, (U16)errorCode);
+    for (k=0; k<nbStreams; k++)
+    {
+        const size_t segSize = (k < nbStreams-1) ? segmentSize : (size_t)(iend-ip);
+        errorCode = HUF_compress1X_usingCTable(op, oend-op, ip, segSize, CTable);
+        if (HUF_isError(errorCode)) return errorCode;
+        if (errorCode==0) return 0;
+        if (k < nbStreams-1) HUF_writeJump(ostart + jumpSize*k, errorCode, jumpSize);
+        ip += segSize;
+        op += errorCode;
+    }
 
-    ip += segmentSize;
-    op += errorCode;
-    errorCode = HUF_compress_usingCTable(op, oend-op, ip, segmentSize, CTable);
-    if (HUF_isError(errorCode)) return errorCode;
-    if (errorCode==0) return 0;
-    MEM_writeLE16(ostart+2, (U16)errorCode);
+    return op-ostart;
+}
 
-    ip += segmentSize;
-    op += errorCode;
-    errorCode = HUF_compress_usingCTable(op, oend-op, ip, segmentSize, CTable);
-    if (HUF_isError(errorCode)) return errorCode;
-    if (errorCode==0) return 0;
-    MEM_writeLE16(ostart+4, (U16)errorCode);
+static size_t HUF_compress_usingCTable_internal(void* dst, size_t dstSize, const void* src, size_t srcSize,
+                                                const HUF_CElt* CTable, const HUF_PairTable* pairTable)
+{
+    if (srcSize > HUF_BLOCKSIZE_MAX) return ERROR(srcSize_wrong);
+    if (HUF_NB_STREAMS(srcSize)==1) return HUF_compress1X_usingCTable(dst, dstSize, src, srcSize, CTable);
+    return HUF_compress_intoSegments(dst, dstSize, src, srcSize, CTable, pairTable, HUF_NB_STREAMS(srcSize));
+}
 
-    ip += segmentSize;
-    op += errorCode;
-    errorCode = HUF_compress_usingCTable(op, oend-op, ip, iend-ip, CTable);
-    if (HUF_isError(errorCode)) return errorCode;
-    if (errorCode==0) return 0;
+size_t HUF_compress_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable)
+{
+    HUF_STATIC_ASSERT(sizeof(HUF_CElt) <= sizeof(U32));   /* HUF_CREATE_STATIC_CTABLE() */
+    return HUF_compress_usingCTable_internal(dst, dstSize, src, srcSize, CTable, NULL);   /* symbols set unknown : no pair table */
+}
 
-    op += errorCode;
-    return op-ostart;
+size_t HUF_compress4X_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable)
+{
+    if (srcSize > HUF_SMALLBLOCK_MAX) return ERROR(srcSize_wrong);   /* original format limit */
+    return HUF_compress_intoSegments(dst, dstSize, src, srcSize, CTable, NULL, 4);
+}
+
+size_t HUF_writeLayoutHeader(void* dst, size_t dstSize, size_t srcSize)
+{
+    const U32 nbStreams = HUF_NB_STREAMS(srcSize);
+    if (nbStreams == 4) return 0;   /* original layout : no layout byte */
+    if (dstSize < 1) return ERROR(dstSize_tooSmall);
+    *(BYTE*)dst = (nbStreams == 1) ? HUF_1STREAM_HEADER : HUF_8STREAMS_HEADER;
+    return 1;
+}
+
+size_t HUF_writeRepeatHeader(void* dst, size_t dstSize)
+{
+    if (dstSize < 1) return ERROR(dstSize_tooSmall);
+    *(BYTE*)dst = HUF_REPEAT_HEADER;
+    return 1;
+}
+
+unsigned HUF_validateCTable(const HUF_CElt* CTable, const unsigned* count, unsigned maxSymbolValue)
+{
+    U32 s;
+    for (s=0; s<=maxSymbolValue; s++)
+        if ((count[s] != 0) && (CTable[s].nbBits == 0)) return 0;
+    return 1;
+}
+
+size_t HUF_estimateCompressedSize(const HUF_CElt* CTable, const unsigned* count, unsigned maxSymbolValue)
+{
+    size_t nbBits = 0;
+    U32 s;
+    for (s=0; s<=maxSymbolValue; s++)
+        nbBits += (size_t)CTable[s].nbBits * count[s];
+    return nbBits >> 3;
+}
+
+/* HUF_optimalTableLog() :
+   builds a CTable for each depth from minimum (enough room for all present symbols) to maxTableLog,
+   and estimates block cost as header size + body size.
+   Deeper trees compress slightly better, but require larger decoding tables, slower to build and less cache-friendly.
+   @return : smallest depth whose cost is within 1/(1<<HUF_AUTOLOG_TOLERANCE_LOG) of best one, or an error code */
+#define HUF_AUTOLOG_TOLERANCE_LOG 7
+size_t HUF_optimalTableLog(const unsigned* count, unsigned maxSymbolValue, unsigned maxTableLog, unsigned scrambler)
+{
+    HUF_CElt CTable[HUF_MAX_SYMBOL_VALUE+1];
+    BYTE header[HUF_CTABLEBOUND];
+    size_t cost[HUF_MAX_TABLELOG+1];
+    size_t bestCost = (size_t)-1;
+    U32 cardinality = 0, minLog, log, s;
+
+    /* checks */
+    if (maxSymbolValue > HUF_MAX_SYMBOL_VALUE) return ERROR(maxSymbolValue_tooLarge);
+    if (!maxTableLog) maxTableLog = HUF_DEFAULT_TABLELOG;
+    if (maxTableLog > HUF_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    for (s=0; s<=maxSymbolValue; s++) cardinality += (count[s]!=0);
+    if (cardinality < 2) return maxTableLog;   /* nothing to evaluate : RLE */
+    minLog = BIT_highbit32(cardinality) + 1;
+    if (minLog >= maxTableLog) return maxTableLog;
+
+    /* evaluate candidates */
+    for (log=0; log<=maxTableLog; log++) cost[log] = (size_t)-1;
+    for (log=maxTableLog; log>=minLog; log--)
+    {
+        size_t hSize;
+        size_t depth = HUF_buildCTable(CTable, count, maxSymbolValue, log);
+        if (HUF_isError(depth)) return depth;
+        log = (U32)depth;   /* tree may be naturally shallower (even < minLog) : skip identical candidates */
+        hSize = HUF_writeCTable(header, sizeof(header), CTable, maxSymbolValue, log, scrambler);
+        if (HUF_isError(hSize)) return hSize;
+        cost[log] = hSize + HUF_estimateCompressedSize(CTable, count, maxSymbolValue);
+        if (cost[log] < bestCost) bestCost = cost[log];
+    }
+
+    /* select shallowest acceptable depth */
+    for (log=1; log<maxTableLog; log++)
+        if (cost[log] <= bestCost + (bestCost >> HUF_AUTOLOG_TOLERANCE_LOG)) break;
+    return log;
 }
 
 
-size_t HUF_compress2 (void* dst, size_t dstSize,
+static size_t HUF_compress2_internal (void* dst, size_t dstSize,
                 const void* src, size_t srcSize,
-                unsigned maxSymbolValue, unsigned huffLog, unsigned scrambler)
+                unsigned maxSymbolValue, unsigned huffLog, unsigned scrambler, unsigned sampling)
 {
     BYTE* const ostart = (BYTE*)dst;
     BYTE* op = ostart;
@@ -490,31 +837,52 @@ size_t HUF_compress2 (void* dst, size_t dstSize,
     /* checks & inits */
     if (srcSize < 1) return 0;  /* Uncompressed */
     if (dstSize < 1) return 0;  /* not compressible within dst budget */
-    if (srcSize > 128 * 1024) return ERROR(srcSize_wrong);   /* current block size limit */
-    if (huffLog > HUF_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    if (srcSize > HUF_BLOCKSIZE_MAX) return ERROR(srcSize_wrong);
+    if ((huffLog > HUF_MAX_TABLELOG) && (huffLog != HUF_TABLELOG_AUTO)) return ERROR(tableLog_tooLarge);
     if (!maxSymbolValue) maxSymbolValue = HUF_MAX_SYMBOL_VALUE;
     if (!huffLog) huffLog = HUF_DEFAULT_TABLELOG;
+    if (sampling && (maxSymbolValue == HUF_MAX_SYMBOL_VALUE) && FSE_isIncompressible(src, srcSize)) return 0;   /* sampled : not worth counting */
 
     /* Scan input and build symbol stats */
     errorCode = FSE_count (count, &maxSymbolValue, (const BYTE*)src, srcSize);
     if (HUF_isError(errorCode)) return errorCode;
     if (errorCode == srcSize) { *ostart = ((const BYTE*)src)[0]; return 1; }
     if (errorCode <= (srcSize >> 7)+1) return 0;   /* Heuristic : not compressible enough */
+    if (huffLog == HUF_TABLELOG_AUTO)
+    {
+        errorCode = HUF_optimalTableLog(count, maxSymbolValue, HUF_MAX_TABLELOG, scrambler);
+        if (HUF_isError(errorCode)) return errorCode;
+        huffLog = (U32)errorCode;
+    }
 
     /* Build Huffman Tree */
     errorCode = HUF_buildCTable (CTable, count, maxSymbolValue, huffLog);
     if (HUF_isError(errorCode)) return errorCode;
     huffLog = (U32)errorCode;
+    if (scrambler)
+    {
+        errorCode = HUF_scrambleCTable (CTable, maxSymbolValue, scrambler);
+        if (HUF_isError(errorCode)) return errorCode;
+    }
 
-    /* Write table description header */
-    errorCode = HUF_writeCTable (op, dstSize, CTable, maxSymbolValue, huffLog, scrambler);
+    /* Write layout and table description headers */
+    errorCode = HUF_writeLayoutHeader (op, dstSize, srcSize);
+    if (HUF_isError(errorCode)) return errorCode;
+    op += errorCode;
+    if (op == oend) return 0;   /* not compressible within dst budget */
+    errorCode = HUF_writeCTable (op, oend - op, CTable, maxSymbolValue, huffLog, scrambler);
     if (HUF_isError(errorCode)) return errorCode;
-    if (errorCode + 12 >= srcSize) return 0;   /* not useful to try compression */
     op += errorCode;
+    if ((size_t)(op-ostart) + 12 >= srcSize) return 0;   /* not useful to try compression */
 
     /* Compress */
-    //errorCode = HUF_compress_usingCTable(op, oend - op, src, srcSize, CTable);   /* single segment */
-    errorCode = HUF_compress_into4Segments(op, oend - op, src, srcSize, CTable);
+    //errorCode = HUF_compress1X_usingCTable(op, oend - op, src, srcSize, CTable);   /* single segment */
+    {
+        HUF_PairTable pairTable;
+        const unsigned usePairs = HUF_usePairTable(count, maxSymbolValue, srcSize);
+        if (usePairs) HUF_buildPairTable(&pairTable, CTable, count, maxSymbolValue);
+        errorCode = HUF_compress_usingCTable_internal(op, oend - op, src, srcSize, CTable, usePairs ? &pairTable : NULL);
+    }
     if (HUF_isError(errorCode)) return errorCode;
     if (errorCode==0) return 0;
     op += errorCode;
@@ -526,6 +894,16 @@ size_t HUF_compress2 (void* dst, size_t dstSize,
     return op-ostart;
 }
 
+size_t HUF_compress2 (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned huffLog, unsigned scrambler)
+{
+    return HUF_compress2_internal(dst, dstSize, src, srcSize, maxSymbolValue, huffLog, scrambler, 0);
+}
+
+size_t HUF_compress2_sampled (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned huffLog, unsigned scrambler)
+{
+    return HUF_compress2_internal(dst, dstSize, src, srcSize, maxSymbolValue, huffLog, scrambler, 1);
+}
+
 size_t HUF_compress (void* dst, size_t maxDstSize, const void* src, size_t srcSize, unsigned scrambler)
 {
 	return HUF_compress2(dst, maxDstSize, src, (U32)srcSize, 255, HUF_DEFAULT_TABLELOG, scrambler);
@@ -537,6 +915,13 @@ size_t HUF_compress (void* dst, size_t maxDstSize, const void* src, size_t srcSi
 *********************************************************/
 typedef struct { BYTE byte; BYTE nbBits; } HUF_DEltX2;   /* single-symbol decoding */
 
+/* HUF_DGEN() :
+   generates decoder `fn` from `fn##_body`, with a BMI2 variant selected at runtime (see CPU_DISPATCH_BMI2()) */
+#define HUF_DGEN(fn, DTableType)                                                                \
+    CPU_DISPATCH_BMI2(size_t, fn,                                                               \
+                      (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const DTableType* DTable), \
+                      (dst, dstSize, cSrc, cSrcSize, DTable))
+
 typedef struct { U16 sequence; BYTE nbBits; BYTE length; } HUF_DEltX4;  /* double-symbols decoding */
 
 typedef struct { BYTE symbol; BYTE weight; } sortedSymbol_t;
@@ -559,6 +944,7 @@ static size_t HUF_readStats(BYTE* huffWeight, size_t hwSize, U32* rankStats,
 
     //memset(huffWeight, 0, hwSize);   /* is not necessary, even though some analyzer complain ... */
 
+    if (iSize == HUF_REPEAT_HEADER) return ERROR(corruption_detected);   /* no previous table : requires HUF_decompress_usingDCtx() */
     if (iSize >= 128)  /* special header */
     {
         if (iSize >= (242))   /* RLE */
@@ -620,6 +1006,97 @@ static size_t HUF_readStats(BYTE* huffWeight, size_t hwSize, U32* rankStats,
     return iSize+1;
 }
 
+/*! HUF_readLayout
+    A body made of 1 or 8 streams is announced by a HUF_1STREAM_HEADER or HUF_8STREAMS_HEADER byte, before table header.
+    Otherwise, body uses the original layout : 4 streams, whatever dstSize, up to HUF_SMALLBLOCK_MAX.
+    @return : size of layout byte (0 or 1), or an error code
+*/
+static size_t HUF_readLayout(U32* nbStreamsPtr, const void* src, size_t srcSize, size_t dstSize)
+{
+    if (srcSize < 1) return ERROR(srcSize_wrong);
+    switch(*(const BYTE*)src)
+    {
+    case HUF_1STREAM_HEADER : *nbStreamsPtr = 1; return 1;
+    case HUF_8STREAMS_HEADER : *nbStreamsPtr = 8; return 1;
+    default : break;
+    }
+    if (dstSize > HUF_SMALLBLOCK_MAX) return ERROR(corruption_detected);
+    *nbStreamsPtr = 4;
+    return 0;
+}
+
+/* HUF_checkLayout() : for decoders of a single layout, the layout byte is optional (caller knows the layout),
+   but must match when present. @return : size of layout byte (0 or 1), or an error code */
+static size_t HUF_checkLayout(const void* src, size_t srcSize, U32 nbStreams)
+{
+    if (srcSize < 1) return ERROR(srcSize_wrong);
+    switch(*(const BYTE*)src)
+    {
+    case HUF_1STREAM_HEADER : return (nbStreams == 1) ? 1 : ERROR(corruption_detected);
+    case HUF_8STREAMS_HEADER : return (nbStreams == 8) ? 1 : ERROR(corruption_detected);
+    default : return 0;
+    }
+}
+
+
+static size_t HUF_readJump(const BYTE* p, U32 jumpSize)
+{
+    return (jumpSize==4) ? MEM_readLE32(p) : MEM_readLE16(p);
+}
+
+/* HUF_initStreams() :
+   multi-streams format : jump table ((nbStreams-1) entries of 2 bytes, or 4 bytes for large blocks), then nbStreams bitstreams,
+   each regenerating one segment of (dstSize+nbStreams-1)/nbStreams bytes (last one : remaining).
+   Initializes bitD[], and op[]/opEnd[] for each segment */
+FORCE_INLINE size_t HUF_initStreams(BIT_DStream_t* bitD, BYTE** op, BYTE** opEnd,
+                                    BYTE* ostart, size_t dstSize, const void* cSrc, size_t cSrcSize, const U32 nbStreams)
+{
+    const U32 jumpSize = HUF_JUMP_SIZE(dstSize);
+    const size_t jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
+    const BYTE* ip = (const BYTE*)cSrc + jumpTableSize;
+    const size_t segmentSize = (dstSize+nbStreams-1) / nbStreams;
+    size_t lengthTotal = jumpTableSize;
+    U32 k;
+
+    if (cSrcSize < jumpTableSize + nbStreams) return ERROR(corruption_detected);   /* strict minimum : jump table + 1 byte per stream */
+    if (segmentSize*(nbStreams-1) > dstSize) return ERROR(corruption_detected);   /* too small for nbStreams segments */
+    for (k=0; k<nbStreams; k++)
+    {
+        const size_t length = (k<nbStreams-1) ? HUF_readJump((const BYTE*)cSrc + jumpSize*k, jumpSize) : cSrcSize - lengthTotal;
+        size_t errorCode;
+        if (length > cSrcSize - lengthTotal) return ERROR(corruption_detected);   /* overflow */
+        lengthTotal += length;
+        errorCode = BIT_initDStream(&bitD[k], ip, length);
+        if (HUF_isError(errorCode)) return errorCode;
+        ip += length;
+        op[k] = ostart + k*segmentSize;
+        opEnd[k] = (k<nbStreams-1) ? op[k] + segmentSize : ostart + dstSize;
+    }
+    return 0;
+}
+
+/* HUF_streamsRoom() : all streams can decode one more round of 'roundSize' bytes within their own segment */
+FORCE_INLINE U32 HUF_streamsRoom(BYTE* const* op, BYTE* const* opEnd, const size_t roundSize, const U32 nbStreams)
+{
+    U32 room = 1, k;
+    for (k=0; k<nbStreams; k++) room &= (op[k] + roundSize <= opEnd[k]);
+    return room;
+}
+
+FORCE_INLINE U32 HUF_streamsReload(BIT_DStream_t* bitD, const U32 nbStreams)
+{
+    U32 endSignal = 0, k;
+    for (k=0; k<nbStreams; k++) endSignal |= BIT_reloadDStream(&bitD[k]);
+    return endSignal;
+}
+
+FORCE_INLINE U32 HUF_streamsEnd(BIT_DStream_t* bitD, const U32 nbStreams)
+{
+    U32 end = 1, k;
+    for (k=0; k<nbStreams; k++) end &= BIT_endOfDStream(&bitD[k]);
+    return end;
+}
+
 
 /**************************/
 /* single-symbol decoding */
@@ -628,12 +1105,13 @@ static size_t HUF_readStats(BYTE* huffWeight, size_t hwSize, U32* rankStats,
 size_t HUF_readDTableX2 (U16* DTable, const void* src, size_t srcSize, unsigned scrambler)
 {
     BYTE huffWeight[HUF_MAX_SYMBOL_VALUE + 1];
+    BYTE order[HUF_MAX_SYMBOL_VALUE + 1];
     U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];   /* large enough for values from 0 to 16 */
     U32 tableLog = 0;
     const BYTE* ip = (const BYTE*) src;
     size_t iSize = ip[0];
     U32 nbSymbols = 0;
-    U32 n;
+    U32 n, k;
     U32 nextRankStart;
     HUF_DEltX2* const dt = (HUF_DEltX2*)(DTable + 1);
 
@@ -656,14 +1134,17 @@ size_t HUF_readDTableX2 (U16* DTable, const void* src, size_t srcSize, unsigned
         rankVal[n] = current;
     }
 
-    /* fill DTable */
-    for (n=0; n<nbSymbols; n++)
+    /* fill DTable, in keyed order */
+    HUF_keyedOrder(order, scrambler);
+    for (k=0; k<=HUF_MAX_SYMBOL_VALUE; k++)
     {
-        const U32 w = huffWeight[n];
-        const U32 length = (1 << w) >> 1;
-        U32 i;
+        const U32 s = order[k];
+        U32 w, length, i;
         HUF_DEltX2 D;
-        D.byte = (BYTE)n; D.nbBits = (BYTE)(tableLog + 1 - w);
+        if (s >= nbSymbols) continue;
+        w = huffWeight[s];
+        length = (1 << w) >> 1;
+        D.byte = (BYTE)s; D.nbBits = (BYTE)(tableLog + 1 - w);
         for (i = rankVal[w]; i < rankVal[w] + length; i++)
             dt[i] = D;
         rankVal[w] += length;
@@ -672,7 +1153,7 @@ size_t HUF_readDTableX2 (U16* DTable, const void* src, size_t srcSize, unsigned
     return iSize;
 }
 
-static BYTE HUF_decodeSymbolX2(BIT_DStream_t* Dstream, const HUF_DEltX2* dt, const U32 dtLog)
+FORCE_INLINE BYTE HUF_decodeSymbolX2(BIT_DStream_t* Dstream, const HUF_DEltX2* dt, const U32 dtLog)
 {
         const size_t val = BIT_lookBitsFast(Dstream, dtLog); /* note : dtLog >= 1 */
         const BYTE c = dt[val].byte;
@@ -691,7 +1172,7 @@ static BYTE HUF_decodeSymbolX2(BIT_DStream_t* Dstream, const HUF_DEltX2* dt, con
 	if (MEM_64bits()) \
         HUF_DECODE_SYMBOLX2_0(ptr, DStreamPtr)
 
-static inline size_t HUF_decodeStreamX2(BYTE* p, BIT_DStream_t* const bitDPtr, BYTE* const pEnd, const HUF_DEltX2* const dt, const U32 dtLog)
+FORCE_INLINE size_t HUF_decodeStreamX2(BYTE* p, BIT_DStream_t* const bitDPtr, BYTE* const pEnd, const HUF_DEltX2* const dt, const U32 dtLog)
 {
     BYTE* const pStart = p;
 
@@ -715,7 +1196,7 @@ static inline size_t HUF_decodeStreamX2(BYTE* p, BIT_DStream_t* const bitDPtr, B
     return pEnd-pStart;
 }
 
-size_t HUF_decompress1X2_usingDTable(
+FORCE_INLINE size_t HUF_decompress1X2_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U16* DTable)
@@ -737,13 +1218,20 @@ size_t HUF_decompress1X2_usingDTable(
     return dstSize;
 }
 
+HUF_DGEN(HUF_decompress1X2_usingDTable, U16)
+
 size_t HUF_decompress1X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX2(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
     size_t errorCode;
 
-	errorCode = HUF_readDTableX2(DTable, cSrc, cSrcSize, scrambler);
+    errorCode = HUF_checkLayout(cSrc, cSrcSize, 1);
+    if (HUF_isError(errorCode)) return errorCode;
+    ip += errorCode;
+    cSrcSize -= errorCode;
+
+    errorCode = HUF_readDTableX2 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(errorCode)) return errorCode;
     if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);
     ip += errorCode;
@@ -753,7 +1241,7 @@ size_t HUF_decompress1X2 (void* dst, size_t dstSize, const void* cSrc, size_t cS
 }
 
 
-size_t HUF_decompress4X2_usingDTable(
+FORCE_INLINE size_t HUF_decompress4X2_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U16* DTable)
@@ -849,13 +1337,20 @@ size_t HUF_decompress4X2_usingDTable(
 }
 
 
+HUF_DGEN(HUF_decompress4X2_usingDTable, U16)
+
 size_t HUF_decompress4X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX2(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
     size_t errorCode;
 
-    errorCode = HUF_readDTableX2 (DTable, cSrc, cSrcSize, scrambler);
+    errorCode = HUF_checkLayout(cSrc, cSrcSize, 4);
+    if (HUF_isError(errorCode)) return errorCode;
+    ip += errorCode;
+    cSrcSize -= errorCode;
+
+    errorCode = HUF_readDTableX2 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(errorCode)) return errorCode;
     if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);
     ip += errorCode;
@@ -864,71 +1359,202 @@ size_t HUF_decompress4X2 (void* dst, size_t dstSize, const void* cSrc, size_t cS
     return HUF_decompress4X2_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
 }
 
-
-/***************************/
-/* double-symbols decoding */
-/***************************/
-
-static void HUF_fillDTableX4Level2(HUF_DEltX4* DTable, U32 sizeLog, const U32 consumed,
-                           const U32* rankValOrigin, const int minWeight,
-                           const sortedSymbol_t* sortedSymbols, const U32 sortedListSize,
-                           U32 nbBitsBaseline, U16 baseSeq)
+FORCE_INLINE size_t HUF_decompress8X2_usingDTable_body(
+          void* dst,  size_t dstSize,
+    const void* cSrc, size_t cSrcSize,
+    const U16* DTable)
 {
-    HUF_DEltX4 DElt;
-    U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];
-    U32 s;
+    const HUF_DEltX2* const dt = ((const HUF_DEltX2*)DTable) +1;
+    const U32 dtLog = DTable[0];
+    BIT_DStream_t bitD[8];
+    BYTE* op[8];
+    BYTE* opEnd[8];
+    U32 endSignal, k;
+    size_t errorCode;
 
-    /* get pre-calculated rankVal */
-    memcpy(rankVal, rankValOrigin, sizeof(rankVal));
+    errorCode = HUF_initStreams(bitD, op, opEnd, (BYTE*)dst, dstSize, cSrc, cSrcSize, 8);
+    if (HUF_isError(errorCode)) return errorCode;
 
-    /* fill skipped values */
-    if (minWeight>1)
+    /* 32-64 symbols per loop (4-8 symbols per stream) */
+    endSignal = HUF_streamsReload(bitD, 8);
+    while ((endSignal==BIT_DStream_unfinished) && HUF_streamsRoom(op, opEnd, 4, 8))
     {
-        U32 i, skipSize = rankVal[minWeight];
-        MEM_writeLE16(&(DElt.sequence), baseSeq);
-        DElt.nbBits   = (BYTE)(consumed);
-        DElt.length   = 1;
-        for (i = 0; i < skipSize; i++)
-            DTable[i] = DElt;
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX2_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX2_1(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX2_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX2_0(op[k], &bitD[k]);
+        endSignal = HUF_streamsReload(bitD, 8);
     }
 
-    /* fill DTable */
-    for (s=0; s<sortedListSize; s++)   /* note : sortedSymbols already skipped */
-    {
-        const U32 symbol = sortedSymbols[s].symbol;
-        const U32 weight = sortedSymbols[s].weight;
-        const U32 nbBits = nbBitsBaseline - weight;
-        const U32 length = 1 << (sizeLog-nbBits);
-        const U32 start = rankVal[weight];
-        U32 i = start;
-        const U32 end = start + length;
+    /* finish bitStreams one by one */
+    for (k=0; k<8; k++) HUF_decodeStreamX2(op[k], &bitD[k], opEnd[k], dt, dtLog);
 
-        MEM_writeLE16(&(DElt.sequence), (U16)(baseSeq + (symbol << 8)));
-        DElt.nbBits = (BYTE)(nbBits + consumed);
-        DElt.length = 2;
-        do { DTable[i++] = DElt; } while (i<end);   /* since length >= 1 */
+    /* check */
+    if (!HUF_streamsEnd(bitD, 8)) return ERROR(corruption_detected);
 
-        rankVal[weight] += length;
-    }
+    return dstSize;
 }
 
-typedef U32 rankVal_t[HUF_ABSOLUTEMAX_TABLELOG][HUF_ABSOLUTEMAX_TABLELOG + 1];
+HUF_DGEN(HUF_decompress8X2_usingDTable, U16)
 
-static void HUF_fillDTableX4(HUF_DEltX4* DTable, const U32 targetLog,
-                           const sortedSymbol_t* sortedList, const U32 sortedListSize,
-                           const U32* rankStart, rankVal_t rankValOrigin, const U32 maxWeight,
-                           const U32 nbBitsBaseline)
+size_t HUF_decompress8X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
-    U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];
-    const int scaleLog = nbBitsBaseline - targetLog;   /* note : targetLog >= srcLog, hence scaleLog <= 1 */
-    const U32 minBits  = nbBitsBaseline - maxWeight;
-    U32 s;
+    HUF_CREATE_STATIC_DTABLEX2(DTable, HUF_MAX_TABLELOG);
+    const BYTE* ip = (const BYTE*) cSrc;
+    size_t errorCode;
 
-    memcpy(rankVal, rankValOrigin, sizeof(rankVal));
+    errorCode = HUF_checkLayout(cSrc, cSrcSize, 8);
+    if (HUF_isError(errorCode)) return errorCode;
+    ip += errorCode;
+    cSrcSize -= errorCode;
 
-    /* fill DTable */
-    for (s=0; s<sortedListSize; s++)
-    {
+    errorCode = HUF_readDTableX2 (DTable, ip, cSrcSize, scrambler);
+    if (HUF_isError(errorCode)) return errorCode;
+    if (errorCode >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += errorCode;
+    cSrcSize -= errorCode;
+
+    return HUF_decompress8X2_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
+}
+
+
+/* in-place variant : streams are reversed and read forward, and decoded one after another,
+   so that output never overtakes input still to be read, located from bitDPtr->ptr onward */
+static size_t HUF_decodeStreamX2_inPlace(BYTE* p, BIT_DStream_t* const bitDPtr, BYTE* const pEnd, const HUF_DEltX2* const dt, const U32 dtLog)
+{
+    BIT_DStream_status status;
+
+    /* up to 4 symbols at a time */
+    while (((status = BIT_reloadForwardDStream(bitDPtr)) == BIT_DStream_unfinished) && (p <= pEnd-4) && (p+4 <= (const BYTE*)bitDPtr->ptr))
+    {
+        HUF_DECODE_SYMBOLX2_2(p, bitDPtr);
+        HUF_DECODE_SYMBOLX2_1(p, bitDPtr);
+        HUF_DECODE_SYMBOLX2_2(p, bitDPtr);
+        HUF_DECODE_SYMBOLX2_0(p, bitDPtr);
+    }
+
+    /* closer to the end */
+    while (((status = BIT_reloadForwardDStream(bitDPtr)) == BIT_DStream_unfinished) && (p < pEnd) && (p < (const BYTE*)bitDPtr->ptr))
+        HUF_DECODE_SYMBOLX2_0(p, bitDPtr);
+    if ((status == BIT_DStream_unfinished) && (p < pEnd)) return ERROR(dstSize_tooSmall);   /* in-place margin too small */
+
+    /* no more data to retrieve from bitstream, hence no need to reload */
+    while (p < pEnd)
+        HUF_DECODE_SYMBOLX2_0(p, bitDPtr);
+
+    return 0;
+}
+
+static size_t HUF_decompressX2_inPlace_usingDTable(
+          BYTE* ostart, size_t dstSize,
+          BYTE* istart, size_t cSrcSize,
+    const U16* DTable, const U32 nbStreams)
+{
+    const HUF_DEltX2* const dt = ((const HUF_DEltX2*)DTable) +1;
+    const U32 dtLog = DTable[0];
+    const size_t segmentSize = (dstSize+nbStreams-1) / nbStreams;
+    const U32 jumpSize = HUF_JUMP_SIZE(dstSize);
+    const size_t jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
+    size_t length[HUF_MAX_NB_STREAMS];
+    size_t lengthTotal = jumpTableSize;
+    BYTE* ip = istart + jumpTableSize;
+    BYTE* op = ostart;
+    U32 n;
+
+    if (cSrcSize < jumpTableSize + nbStreams) return ERROR(corruption_detected);   /* strict minimum : jump table + 1 byte per stream */
+    if (segmentSize*(nbStreams-1) > dstSize) return ERROR(corruption_detected);   /* too small for nbStreams segments */
+    for (n=0; n<nbStreams-1; n++)
+    {
+        length[n] = HUF_readJump(istart + jumpSize*n, jumpSize);
+        if (length[n] > cSrcSize - lengthTotal) return ERROR(corruption_detected);   /* overflow */
+        lengthTotal += length[n];
+    }
+    length[nbStreams-1] = cSrcSize - lengthTotal;
+
+    for (n=0; n<nbStreams; n++)
+    {
+        BYTE* const oend = (n==nbStreams-1) ? ostart + dstSize : op + segmentSize;
+        BIT_DStream_t bitD;
+        size_t errorCode;
+
+        BIT_reverseBytes(ip, length[n]);
+        errorCode = BIT_initForwardDStream(&bitD, ip, length[n]);
+        if (HUF_isError(errorCode)) return errorCode;
+        errorCode = HUF_decodeStreamX2_inPlace(op, &bitD, oend, dt, dtLog);
+        if (HUF_isError(errorCode)) return errorCode;
+        if (!BIT_endOfDStream(&bitD)) return ERROR(corruption_detected);
+        ip += length[n];
+        op = oend;
+    }
+
+    return dstSize;
+}
+
+
+/***************************/
+/* double-symbols decoding */
+/***************************/
+
+static void HUF_fillDTableX4Level2(HUF_DEltX4* DTable, U32 sizeLog, const U32 consumed,
+                           const U32* rankValOrigin, const int minWeight,
+                           const sortedSymbol_t* sortedSymbols, const U32 sortedListSize,
+                           U32 nbBitsBaseline, U16 baseSeq)
+{
+    HUF_DEltX4 DElt;
+    U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];
+    U32 s;
+
+    /* get pre-calculated rankVal */
+    memcpy(rankVal, rankValOrigin, sizeof(rankVal));
+
+    /* fill skipped values */
+    if (minWeight>1)
+    {
+        U32 i, skipSize = rankVal[minWeight];
+        MEM_writeLE16(&(DElt.sequence), baseSeq);
+        DElt.nbBits   = (BYTE)(consumed);
+        DElt.length   = 1;
+        for (i = 0; i < skipSize; i++)
+            DTable[i] = DElt;
+    }
+
+    /* fill DTable */
+    for (s=0; s<sortedListSize; s++)   /* note : sortedSymbols already skipped */
+    {
+        const U32 symbol = sortedSymbols[s].symbol;
+        const U32 weight = sortedSymbols[s].weight;
+        const U32 nbBits = nbBitsBaseline - weight;
+        const U32 length = 1 << (sizeLog-nbBits);
+        const U32 start = rankVal[weight];
+        U32 i = start;
+        const U32 end = start + length;
+
+        MEM_writeLE16(&(DElt.sequence), (U16)(baseSeq + (symbol << 8)));
+        DElt.nbBits = (BYTE)(nbBits + consumed);
+        DElt.length = 2;
+        do { DTable[i++] = DElt; } while (i<end);   /* since length >= 1 */
+
+        rankVal[weight] += length;
+    }
+}
+
+typedef U32 rankVal_t[HUF_ABSOLUTEMAX_TABLELOG][HUF_ABSOLUTEMAX_TABLELOG + 1];
+
+static void HUF_fillDTableX4(HUF_DEltX4* DTable, const U32 targetLog,
+                           const sortedSymbol_t* sortedList, const U32 sortedListSize,
+                           const U32* rankStart, rankVal_t rankValOrigin, const U32 maxWeight,
+                           const U32 nbBitsBaseline)
+{
+    U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];
+    const int scaleLog = nbBitsBaseline - targetLog;   /* note : targetLog >= srcLog, hence scaleLog <= 1 */
+    const U32 minBits  = nbBitsBaseline - maxWeight;
+    U32 s;
+
+    memcpy(rankVal, rankValOrigin, sizeof(rankVal));
+
+    /* fill DTable */
+    for (s=0; s<sortedListSize; s++)
+    {
         const U16 symbol = sortedList[s].symbol;
         const U32 weight = sortedList[s].weight;
         const U32 nbBits = nbBitsBaseline - weight;
@@ -1002,12 +1628,17 @@ size_t HUF_readDTableX4 (U32* DTable, const void* src, size_t srcSize, unsigned
         sizeOfSort = nextRankStart;
     }
 
-    /* sort symbols by weight */
+    /* sort symbols by weight, then in keyed order */
     {
-        U32 s;
-        for (s=0; s<nbSymbols; s++)
+        BYTE order[HUF_MAX_SYMBOL_VALUE + 1];
+        U32 k;
+        HUF_keyedOrder(order, scrambler);
+        for (k=0; k<=HUF_MAX_SYMBOL_VALUE; k++)
         {
-            U32 w = weightList[s];
+            const U32 s = order[k];
+            U32 w;
+            if (s >= nbSymbols) continue;
+            w = weightList[s];
             U32 r = rankStart[w]++;
             sortedSymbol[r].symbol = (BYTE)s;
             sortedSymbol[r].weight = (BYTE)w;
@@ -1042,7 +1673,7 @@ size_t HUF_readDTableX4 (U32* DTable, const void* src, size_t srcSize, unsigned
 }
 
 
-static U32 HUF_decodeSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DEltX4* dt, const U32 dtLog)
+FORCE_INLINE U32 HUF_decodeSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DEltX4* dt, const U32 dtLog)
 {
     const size_t val = BIT_lookBitsFast(DStream, dtLog);   /* note : dtLog >= 1 */
     memcpy(op, dt+val, 2);
@@ -1050,7 +1681,7 @@ static U32 HUF_decodeSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DEltX4
     return dt[val].length;
 }
 
-static U32 HUF_decodeLastSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DEltX4* dt, const U32 dtLog)
+FORCE_INLINE U32 HUF_decodeLastSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DEltX4* dt, const U32 dtLog)
 {
     const size_t val = BIT_lookBitsFast(DStream, dtLog);   /* note : dtLog >= 1 */
     memcpy(op, dt+val, 1);
@@ -1079,7 +1710,7 @@ static U32 HUF_decodeLastSymbolX4(void* op, BIT_DStream_t* DStream, const HUF_DE
 	if (MEM_64bits()) \
         ptr += HUF_decodeSymbolX4(ptr, DStreamPtr, dt, dtLog)
 
-static inline size_t HUF_decodeStreamX4(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* const pEnd, const HUF_DEltX4* const dt, const U32 dtLog)
+FORCE_INLINE size_t HUF_decodeStreamX4(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* const pEnd, const HUF_DEltX4* const dt, const U32 dtLog)
 {
     BYTE* const pStart = p;
 
@@ -1106,7 +1737,7 @@ static inline size_t HUF_decodeStreamX4(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* c
 }
 
 
-size_t HUF_decompress1X4_usingDTable(
+FORCE_INLINE size_t HUF_decompress1X4_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U32* DTable)
@@ -1134,12 +1765,20 @@ size_t HUF_decompress1X4_usingDTable(
     return dstSize;
 }
 
+HUF_DGEN(HUF_decompress1X4_usingDTable, U32)
+
 size_t HUF_decompress1X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX4(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
 
-	size_t hSize = HUF_readDTableX4(DTable, cSrc, cSrcSize, scrambler);
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 1);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    hSize = HUF_readDTableX4 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(hSize)) return hSize;
     if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
     ip += hSize;
@@ -1148,7 +1787,7 @@ size_t HUF_decompress1X4 (void* dst, size_t dstSize, const void* cSrc, size_t cS
     return HUF_decompress1X4_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
 }
 
-size_t HUF_decompress4X4_usingDTable(
+FORCE_INLINE size_t HUF_decompress4X4_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U32* DTable)
@@ -1244,12 +1883,20 @@ size_t HUF_decompress4X4_usingDTable(
 }
 
 
+HUF_DGEN(HUF_decompress4X4_usingDTable, U32)
+
 size_t HUF_decompress4X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX4(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
+
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 4);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
 
-    size_t hSize = HUF_readDTableX4 (DTable, cSrc, cSrcSize, scrambler);
+    hSize = HUF_readDTableX4 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(hSize)) return hSize;
     if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
     ip += hSize;
@@ -1258,6 +1905,64 @@ size_t HUF_decompress4X4 (void* dst, size_t dstSize, const void* cSrc, size_t cS
     return HUF_decompress4X4_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
 }
 
+FORCE_INLINE size_t HUF_decompress8X4_usingDTable_body(
+          void* dst,  size_t dstSize,
+    const void* cSrc, size_t cSrcSize,
+    const U32* DTable)
+{
+    const HUF_DEltX4* const dt = ((const HUF_DEltX4*)DTable) +1;
+    const U32 dtLog = DTable[0];
+    BIT_DStream_t bitD[8];
+    BYTE* op[8];
+    BYTE* opEnd[8];
+    U32 endSignal, k;
+    size_t errorCode;
+
+    errorCode = HUF_initStreams(bitD, op, opEnd, (BYTE*)dst, dstSize, cSrc, cSrcSize, 8);
+    if (HUF_isError(errorCode)) return errorCode;
+
+    /* 32-64 symbols per loop (4-8 symbols per stream) */
+    endSignal = HUF_streamsReload(bitD, 8);
+    while ((endSignal==BIT_DStream_unfinished) && HUF_streamsRoom(op, opEnd, 8, 8))
+    {
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX4_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX4_1(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX4_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX4_0(op[k], &bitD[k]);
+        endSignal = HUF_streamsReload(bitD, 8);
+    }
+
+    /* finish bitStreams one by one */
+    for (k=0; k<8; k++) HUF_decodeStreamX4(op[k], &bitD[k], opEnd[k], dt, dtLog);
+
+    /* check */
+    if (!HUF_streamsEnd(bitD, 8)) return ERROR(corruption_detected);
+
+    return dstSize;
+}
+
+HUF_DGEN(HUF_decompress8X4_usingDTable, U32)
+
+size_t HUF_decompress8X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    HUF_CREATE_STATIC_DTABLEX4(DTable, HUF_MAX_TABLELOG);
+    const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
+
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 8);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    hSize = HUF_readDTableX4 (DTable, ip, cSrcSize, scrambler);
+    if (HUF_isError(hSize)) return hSize;
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    return HUF_decompress8X4_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
+}
+
 
 /**********************************/
 /* quad-symbol decoding           */
@@ -1369,12 +2074,17 @@ size_t HUF_readDTableX6 (U32* DTable, const void* src, size_t srcSize, unsigned
         sizeOfSort = nextRankStart;
     }
 
-    /* sort symbols by weight */
+    /* sort symbols by weight, then in keyed order */
     {
-        U32 s;
-        for (s=0; s<nbSymbols; s++)
+        BYTE order[HUF_MAX_SYMBOL_VALUE + 1];
+        U32 k;
+        HUF_keyedOrder(order, scrambler);
+        for (k=0; k<=HUF_MAX_SYMBOL_VALUE; k++)
         {
-            U32 w = weightList[s];
+            const U32 s = order[k];
+            U32 w;
+            if (s >= nbSymbols) continue;
+            w = weightList[s];
             U32 r = rankStart[w]++;
             sortedSymbol[r].symbol = (BYTE)s;
             sortedSymbol[r].weight = (BYTE)w;
@@ -1419,7 +2129,7 @@ size_t HUF_readDTableX6 (U32* DTable, const void* src, size_t srcSize, unsigned
 }
 
 
-static U32 HUF_decodeSymbolX6(void* op, BIT_DStream_t* DStream, const HUF_DDescX6* dd, const HUF_DSeqX6* ds, const U32 dtLog)
+FORCE_INLINE U32 HUF_decodeSymbolX6(void* op, BIT_DStream_t* DStream, const HUF_DDescX6* dd, const HUF_DSeqX6* ds, const U32 dtLog)
 {
     const size_t val = BIT_lookBitsFast(DStream, dtLog);   /* note : dtLog >= 1 */
     memcpy(op, ds+val, sizeof(HUF_DSeqX6));
@@ -1427,7 +2137,7 @@ static U32 HUF_decodeSymbolX6(void* op, BIT_DStream_t* DStream, const HUF_DDescX
     return dd[val].nbBytes;
 }
 
-static U32 HUF_decodeLastSymbolsX6(void* op, const U32 maxL, BIT_DStream_t* DStream,
+FORCE_INLINE U32 HUF_decodeLastSymbolsX6(void* op, const U32 maxL, BIT_DStream_t* DStream,
                                   const HUF_DDescX6* dd, const HUF_DSeqX6* ds, const U32 dtLog)
 {
     const size_t val = BIT_lookBitsFast(DStream, dtLog);   /* note : dtLog >= 1 */
@@ -1460,7 +2170,7 @@ static U32 HUF_decodeLastSymbolsX6(void* op, const U32 maxL, BIT_DStream_t* DStr
 	if (MEM_64bits()) \
         HUF_DECODE_SYMBOLX6_0(ptr, DStreamPtr)
 
-static inline size_t HUF_decodeStreamX6(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* const pEnd, const U32* DTable, const U32 dtLog)
+FORCE_INLINE size_t HUF_decodeStreamX6(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* const pEnd, const U32* DTable, const U32 dtLog)
 {
     const HUF_DDescX6* dd = (const HUF_DDescX6*)(DTable+1);
     const HUF_DSeqX6* ds = (const HUF_DSeqX6*)(DTable + 1 + (1<<(dtLog-1)));
@@ -1489,7 +2199,7 @@ static inline size_t HUF_decodeStreamX6(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* c
 }
 
 
-size_t HUF_decompress1X6_usingDTable(
+FORCE_INLINE size_t HUF_decompress1X6_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U32* DTable)
@@ -1516,12 +2226,20 @@ size_t HUF_decompress1X6_usingDTable(
     return dstSize;
 }
 
+HUF_DGEN(HUF_decompress1X6_usingDTable, U32)
+
 size_t HUF_decompress1X6(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX6(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
+
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 1);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
 
-    size_t hSize = HUF_readDTableX6 (DTable, cSrc, cSrcSize, scrambler);
+    hSize = HUF_readDTableX6 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(hSize)) return hSize;
     if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
     ip += hSize;
@@ -1531,7 +2249,7 @@ size_t HUF_decompress1X6(void* dst, size_t dstSize, const void* cSrc, size_t cSr
 }
 
 
-size_t HUF_decompress4X6_usingDTable(
+FORCE_INLINE size_t HUF_decompress4X6_usingDTable_body(
           void* dst,  size_t dstSize,
     const void* cSrc, size_t cSrcSize,
     const U32* DTable)
@@ -1628,12 +2346,20 @@ size_t HUF_decompress4X6_usingDTable(
 }
 
 
+HUF_DGEN(HUF_decompress4X6_usingDTable, U32)
+
 size_t HUF_decompress4X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
     HUF_CREATE_STATIC_DTABLEX6(DTable, HUF_MAX_TABLELOG);
     const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
+
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 4);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
 
-	size_t hSize = HUF_readDTableX6(DTable, cSrc, cSrcSize, scrambler);
+    hSize = HUF_readDTableX6 (DTable, ip, cSrcSize, scrambler);
     if (HUF_isError(hSize)) return hSize;
     if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
     ip += hSize;
@@ -1642,65 +2368,988 @@ size_t HUF_decompress4X6 (void* dst, size_t dstSize, const void* cSrc, size_t cS
     return HUF_decompress4X6_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
 }
 
+FORCE_INLINE size_t HUF_decompress8X6_usingDTable_body(
+          void* dst,  size_t dstSize,
+    const void* cSrc, size_t cSrcSize,
+    const U32* DTable)
+{
+    const U32 dtLog = DTable[0];
+    const HUF_DDescX6* dd = (const HUF_DDescX6*)(DTable+1);
+    const HUF_DSeqX6* ds = (const HUF_DSeqX6*)(DTable + 1 + (1<<(dtLog-1)));
+    BIT_DStream_t bitD[8];
+    BYTE* op[8];
+    BYTE* opEnd[8];
+    U32 endSignal, k;
+    size_t errorCode;
 
-/**********************************/
-/* Generic decompression selector */
-/**********************************/
+    errorCode = HUF_initStreams(bitD, op, opEnd, (BYTE*)dst, dstSize, cSrc, cSrcSize, 8);
+    if (HUF_isError(errorCode)) return errorCode;
 
-typedef struct { U32 tableTime; U32 decode256Time; } algo_time_t;
-static const algo_time_t algoTime[16 /* Quantization */][3 /* single, double, quad */] =
-{
-    /* single, double, quad */
-    {{0,0}, {1,1}, {2,2}},  /* Q==0 : impossible */
-    {{0,0}, {1,1}, {2,2}},  /* Q==1 : impossible */
-    {{  38,130}, {1313, 74}, {2151, 38}},   /* Q == 2 : 12-18% */
-    {{ 448,128}, {1353, 74}, {2238, 41}},   /* Q == 3 : 18-25% */
-    {{ 556,128}, {1353, 74}, {2238, 47}},   /* Q == 4 : 25-32% */
-    {{ 714,128}, {1418, 74}, {2436, 53}},   /* Q == 5 : 32-38% */
-    {{ 883,128}, {1437, 74}, {2464, 61}},   /* Q == 6 : 38-44% */
-    {{ 897,128}, {1515, 75}, {2622, 68}},   /* Q == 7 : 44-50% */
-    {{ 926,128}, {1613, 75}, {2730, 75}},   /* Q == 8 : 50-56% */
-    {{ 947,128}, {1729, 77}, {3359, 77}},   /* Q == 9 : 56-62% */
-    {{1107,128}, {2083, 81}, {4006, 84}},   /* Q ==10 : 62-69% */
-    {{1177,128}, {2379, 87}, {4785, 88}},   /* Q ==11 : 69-75% */
-    {{1242,128}, {2415, 93}, {5155, 84}},   /* Q ==12 : 75-81% */
-    {{1349,128}, {2644,106}, {5260,106}},   /* Q ==13 : 81-87% */
-    {{1455,128}, {2422,124}, {4174,124}},   /* Q ==14 : 87-93% */
-    {{ 722,128}, {1891,145}, {1936,146}},   /* Q ==15 : 93-99% */
-};
+    /* 32-64 sequences per loop (4-8 sequences per stream) */
+    endSignal = HUF_streamsReload(bitD, 8);
+    while ((endSignal==BIT_DStream_unfinished) && HUF_streamsRoom(op, opEnd, 16, 8))
+    {
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX6_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX6_1(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX6_2(op[k], &bitD[k]);
+        for (k=0; k<8; k++) HUF_DECODE_SYMBOLX6_0(op[k], &bitD[k]);
+        endSignal = HUF_streamsReload(bitD, 8);
+    }
 
-typedef size_t (*decompressionAlgo)(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+    /* finish bitStreams one by one */
+    for (k=0; k<8; k++) HUF_decodeStreamX6(op[k], &bitD[k], opEnd[k], DTable, dtLog);
 
-size_t HUF_decompress (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+    /* check */
+    if (!HUF_streamsEnd(bitD, 8)) return ERROR(corruption_detected);
+
+    return dstSize;
+}
+
+HUF_DGEN(HUF_decompress8X6_usingDTable, U32)
+
+size_t HUF_decompress8X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
 {
-    static const decompressionAlgo decompress[3] = { HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6 };
-    /* estimate decompression time */
+    HUF_CREATE_STATIC_DTABLEX6(DTable, HUF_MAX_TABLELOG);
+    const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
 
-    U32 Q;
-    const U32 D256 = (U32)(dstSize >> 8);
-    U32 Dtime[3];
-    U32 algoNb = 0;
-    int n;
+    hSize = HUF_checkLayout(cSrc, cSrcSize, 8);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
 
-    /* validation checks */
-    if (dstSize == 0) return ERROR(dstSize_tooSmall);
-    if (cSrcSize > dstSize) return ERROR(corruption_detected);   /* invalid */
-    if (cSrcSize == dstSize) { memcpy(dst, cSrc, dstSize); return dstSize; }   /* not compressed */
-    if (cSrcSize == 1) { memset(dst, ((const BYTE*)cSrc)[0], dstSize); return dstSize; }   /* RLE */
+    hSize = HUF_readDTableX6 (DTable, ip, cSrcSize, scrambler);
+    if (HUF_isError(hSize)) return hSize;
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += hSize;
+    cSrcSize -= hSize;
 
-    /* decoder timing evaluation */
-    Q = (U32)(cSrcSize * 16 / dstSize);   /* Q < 16 since dstSize > cSrcSize */
-    for (n=0; n<3; n++)
-        Dtime[n] = algoTime[Q][n].tableTime + (algoTime[Q][n].decode256Time * D256);
+    return HUF_decompress8X6_usingDTable (dst, dstSize, ip, cSrcSize, DTable);
+}
 
-    // Dtime[1] += Dtime[1] >> 4; Dtime[2] += Dtime[2] >> 3; /* advantage to algorithms using less memory */
 
-    if (Dtime[1] < Dtime[0]) algoNb = 1;
-    if (Dtime[2] < Dtime[algoNb]) algoNb = 2;
+/**********************************/
+/* compact canonical decoding     */
+/**********************************/
+/* The XC decoder trades speed for cache footprint : instead of 2^tableLog cells, it keeps
+   the first code of each weight, and a 2^HUF_XC_LUTLOG lookup table resolving short codes.
+   Longer codes are resolved by a short search over weights.
+   Codes are canonical (see HUF_buildCTable()) : sorted by weight, then in keyed order (see HUF_keyedOrder()),
+   lowest weights (longest codes) taking the lowest values */
+#define HUF_XC_LUTLOG 7
+
+typedef struct {
+    BYTE tableLog;
+    BYTE lutShift;   /* tableLog - lutLog */
+    BYTE lutWeight;  /* codes of weight > lutWeight are resolved by lut[] */
+    BYTE reserved;
+    U16  start[HUF_MAX_TABLELOG+1];   /* first code of each weight, left-aligned on tableLog bits */
+    U16  base[HUF_MAX_TABLELOG+1];    /* index of first symbol of each weight within symbols[] */
+    HUF_DEltX2 lut[1<<HUF_XC_LUTLOG]; /* nbBits==0 : code longer than lutLog */
+    BYTE symbols[HUF_MAX_SYMBOL_VALUE+1];   /* sorted by weight, then in keyed order */
+} HUF_DTableXC;
+
+size_t HUF_readDTableXC (U32* DTable, const void* src, size_t srcSize, unsigned scrambler)
+{
+    BYTE huffWeight[HUF_MAX_SYMBOL_VALUE + 1];
+    U32 rankVal[HUF_ABSOLUTEMAX_TABLELOG + 1];
+    U32 rankStart[HUF_MAX_TABLELOG + 1];
+    U32 rankNext[HUF_MAX_TABLELOG + 1];
+    BYTE order[HUF_MAX_SYMBOL_VALUE + 1];
+    U32 tableLog = 0;
+    U32 nbSymbols = 0;
+    U32 lutLog, nextStart, nextBase;
+    U32 k, w;
+    size_t iSize;
+    HUF_DTableXC* const dt = (HUF_DTableXC*)DTable;
 
-    return decompress[algoNb](dst, dstSize, cSrc, cSrcSize, scrambler);
+    HUF_STATIC_ASSERT(sizeof(HUF_DTableXC) <= HUF_DTABLEXC_SIZE_U32 * sizeof(U32));   /* if compilation fails here, assertion is false */
 
-    //return HUF_decompress4X2(dst, dstSize, cSrc, cSrcSize);   /* multi-streams single-symbol decoding */
-    //return HUF_decompress4X4(dst, dstSize, cSrc, cSrcSize);   /* multi-streams double-symbols decoding */
-    //return HUF_decompress4X6(dst, dstSize, cSrc, cSrcSize);   /* multi-streams quad-symbols decoding */
+    iSize = HUF_readStats(huffWeight, HUF_MAX_SYMBOL_VALUE + 1, rankVal, &nbSymbols, &tableLog, src, srcSize, scrambler);
+    if (HUF_isError(iSize)) return iSize;
+
+    /* check result */
+    if (tableLog > HUF_MAX_TABLELOG) return ERROR(tableLog_tooLarge);
+    lutLog = (tableLog < HUF_XC_LUTLOG) ? tableLog : HUF_XC_LUTLOG;
+    dt->tableLog = (BYTE)tableLog;
+    dt->lutShift = (BYTE)(tableLog - lutLog);
+    dt->lutWeight = (BYTE)(tableLog - lutLog);
+    dt->reserved = 0;
+
+    /* Prepare ranks */
+    nextStart = 0;
+    nextBase = 0;
+    dt->start[0] = 0;
+    dt->base[0] = 0;
+    for (w=1; w<=tableLog; w++)
+    {
+        dt->start[w] = (U16)nextStart;
+        dt->base[w] = (U16)nextBase;
+        rankStart[w] = nextStart;
+        rankNext[w] = nextBase;
+        nextStart += rankVal[w] << (w-1);
+        nextBase += rankVal[w];
+    }
+
+    /* fill symbols and lut, in keyed order */
+    memset(dt->lut, 0, sizeof(dt->lut));
+    HUF_keyedOrder(order, scrambler);
+    for (k=0; k<=HUF_MAX_SYMBOL_VALUE; k++)
+    {
+        const U32 n = order[k];
+        U32 length;
+        if (n >= nbSymbols) continue;
+        w = huffWeight[n];
+        if (w == 0) continue;
+        length = (1 << w) >> 1;
+        dt->symbols[rankNext[w]++] = (BYTE)n;
+        if (w > dt->lutWeight)
+        {
+            const U32 first = rankStart[w] >> dt->lutShift;
+            U32 i;
+            HUF_DEltX2 D;
+            D.byte = (BYTE)n; D.nbBits = (BYTE)(tableLog + 1 - w);
+            for (i = first; i < first + (length >> dt->lutShift); i++)
+                dt->lut[i] = D;
+        }
+        rankStart[w] += length;
+    }
+
+    return iSize;
+}
+
+/* note : table parameters are passed separately, so that they stay in registers, despite byte writes into dst */
+FORCE_INLINE BYTE HUF_decodeSymbolXC(BIT_DStream_t* Dstream, const HUF_DTableXC* dt, const U32 dtLog, const U32 lutShift, const U32 lutWeight)
+{
+    const size_t val = BIT_lookBitsFast(Dstream, dtLog);   /* note : dtLog >= 1 */
+    const HUF_DEltX2 D = dt->lut[val >> lutShift];
+    if (D.nbBits)
+    {
+        BIT_skipBits(Dstream, D.nbBits);
+        return D.byte;
+    }
+    {
+        U32 w = lutWeight;   /* val < start[lutWeight+1] : weight is lutWeight or lower; start[1]==0 stops the search */
+        while (val < dt->start[w]) w--;
+        BIT_skipBits(Dstream, dtLog + 1 - w);
+        return dt->symbols[dt->base[w] + ((val - dt->start[w]) >> (w-1))];
+    }
+}
+
+#define HUF_DECODE_SYMBOLXC_0(ptr, DStreamPtr) \
+    *ptr++ = HUF_decodeSymbolXC(DStreamPtr, dt, dtLog, lutShift, lutWeight)
+
+#define HUF_DECODE_SYMBOLXC_1(ptr, DStreamPtr) \
+    if (MEM_64bits() || (HUF_MAX_TABLELOG<=12)) \
+        HUF_DECODE_SYMBOLXC_0(ptr, DStreamPtr)
+
+#define HUF_DECODE_SYMBOLXC_2(ptr, DStreamPtr) \
+    if (MEM_64bits()) \
+        HUF_DECODE_SYMBOLXC_0(ptr, DStreamPtr)
+
+FORCE_INLINE size_t HUF_decodeStreamXC(BYTE* p, BIT_DStream_t* const bitDPtr, BYTE* const pEnd, const HUF_DTableXC* const dt)
+{
+    BYTE* const pStart = p;
+    const U32 dtLog = dt->tableLog;
+    const U32 lutShift = dt->lutShift;
+    const U32 lutWeight = dt->lutWeight;
+
+    /* up to 4 symbols at a time */
+    while ((BIT_reloadDStream(bitDPtr) == BIT_DStream_unfinished) && (p <= pEnd-4))
+    {
+        HUF_DECODE_SYMBOLXC_2(p, bitDPtr);
+        HUF_DECODE_SYMBOLXC_1(p, bitDPtr);
+        HUF_DECODE_SYMBOLXC_2(p, bitDPtr);
+        HUF_DECODE_SYMBOLXC_0(p, bitDPtr);
+    }
+
+    /* closer to the end */
+    while ((BIT_reloadDStream(bitDPtr) == BIT_DStream_unfinished) && (p < pEnd))
+        HUF_DECODE_SYMBOLXC_0(p, bitDPtr);
+
+    /* no more data to retrieve from bitstream, hence no need to reload */
+    while (p < pEnd)
+        HUF_DECODE_SYMBOLXC_0(p, bitDPtr);
+
+    return pEnd-pStart;
+}
+
+FORCE_INLINE size_t HUF_decompress1XC_usingDTable_body(
+          void* dst,  size_t dstSize,
+    const void* cSrc, size_t cSrcSize,
+    const U32* DTable)
+{
+    BYTE* op = (BYTE*)dst;
+    BYTE* const oend = op + dstSize;
+    size_t errorCode;
+    const HUF_DTableXC* const dt = (const HUF_DTableXC*)DTable;
+    BIT_DStream_t bitD;
+    errorCode = BIT_initDStream(&bitD, cSrc, cSrcSize);
+    if (HUF_isError(errorCode)) return errorCode;
+
+    HUF_decodeStreamXC(op, &bitD, oend, dt);
+
+    /* check */
+    if (!BIT_endOfDStream(&bitD)) return ERROR(corruption_detected);
+
+    return dstSize;
+}
+
+/* 4 and 8 streams formats share the same loop */
+FORCE_INLINE size_t HUF_decompressNXC_usingDTable_body(
+          void* dst,  size_t dstSize,
+    const void* cSrc, size_t cSrcSize,
+    const U32* DTable, const U32 nbStreams)
+{
+    const HUF_DTableXC* const dt = (const HUF_DTableXC*)DTable;
+    const U32 dtLog = dt->tableLog;
+    const U32 lutShift = dt->lutShift;
+    const U32 lutWeight = dt->lutWeight;
+    BIT_DStream_t bitD[8];
+    BYTE* op[8];
+    BYTE* opEnd[8];
+    U32 endSignal, k;
+    size_t errorCode;
+
+    errorCode = HUF_initStreams(bitD, op, opEnd, (BYTE*)dst, dstSize, cSrc, cSrcSize, nbStreams);
+    if (HUF_isError(errorCode)) return errorCode;
+
+    /* 4-8 symbols per stream per loop */
+    endSignal = HUF_streamsReload(bitD, nbStreams);
+    while ((endSignal==BIT_DStream_unfinished) && HUF_streamsRoom(op, opEnd, 4, nbStreams))
+    {
+        for (k=0; k<nbStreams; k++) HUF_DECODE_SYMBOLXC_2(op[k], &bitD[k]);
+        for (k=0; k<nbStreams; k++) HUF_DECODE_SYMBOLXC_1(op[k], &bitD[k]);
+        for (k=0; k<nbStreams; k++) HUF_DECODE_SYMBOLXC_2(op[k], &bitD[k]);
+        for (k=0; k<nbStreams; k++) HUF_DECODE_SYMBOLXC_0(op[k], &bitD[k]);
+        endSignal = HUF_streamsReload(bitD, nbStreams);
+    }
+
+    /* finish bitStreams one by one */
+    for (k=0; k<nbStreams; k++) HUF_decodeStreamXC(op[k], &bitD[k], opEnd[k], dt);
+
+    /* check */
+    if (!HUF_streamsEnd(bitD, nbStreams)) return ERROR(corruption_detected);
+
+    return dstSize;
+}
+
+FORCE_INLINE size_t HUF_decompress4XC_usingDTable_body(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const U32* DTable)
+{
+    return HUF_decompressNXC_usingDTable_body(dst, dstSize, cSrc, cSrcSize, DTable, 4);
+}
+
+FORCE_INLINE size_t HUF_decompress8XC_usingDTable_body(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const U32* DTable)
+{
+    return HUF_decompressNXC_usingDTable_body(dst, dstSize, cSrc, cSrcSize, DTable, 8);
+}
+
+HUF_DGEN(HUF_decompress1XC_usingDTable, U32)
+HUF_DGEN(HUF_decompress4XC_usingDTable, U32)
+HUF_DGEN(HUF_decompress8XC_usingDTable, U32)
+
+typedef size_t (*HUF_decompressXC_usingDTable_f)(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const U32* DTable);
+
+static size_t HUF_decompressXC_generic(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler,
+                                       HUF_decompressXC_usingDTable_f decoder, U32 nbStreams)
+{
+    HUF_CREATE_STATIC_DTABLEXC(DTable);
+    const BYTE* ip = (const BYTE*) cSrc;
+    size_t hSize;
+
+    hSize = HUF_checkLayout(cSrc, cSrcSize, nbStreams);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    hSize = HUF_readDTableXC(DTable, ip, cSrcSize, scrambler);
+    if (HUF_isError(hSize)) return hSize;
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    return decoder(dst, dstSize, ip, cSrcSize, DTable);
+}
+
+size_t HUF_decompress1XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    return HUF_decompressXC_generic(dst, dstSize, cSrc, cSrcSize, scrambler, HUF_decompress1XC_usingDTable, 1);
+}
+
+size_t HUF_decompress4XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    return HUF_decompressXC_generic(dst, dstSize, cSrc, cSrcSize, scrambler, HUF_decompress4XC_usingDTable, 4);
+}
+
+size_t HUF_decompress8XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    return HUF_decompressXC_generic(dst, dstSize, cSrc, cSrcSize, scrambler, HUF_decompress8XC_usingDTable, 8);
+}
+
+/**********************************/
+/* Generic decompression selector */
+/**********************************/
+
+typedef struct { U32 tableTime; U32 decode256Time; } algo_time_t;
+static const algo_time_t algoTime[16 /* Quantization */][3 /* single, double, quad */] =
+{
+    /* single, double, quad */
+    {{0,0}, {1,1}, {2,2}},  /* Q==0 : impossible */
+    {{0,0}, {1,1}, {2,2}},  /* Q==1 : impossible */
+    {{  38,130}, {1313, 74}, {2151, 38}},   /* Q == 2 : 12-18% */
+    {{ 448,128}, {1353, 74}, {2238, 41}},   /* Q == 3 : 18-25% */
+    {{ 556,128}, {1353, 74}, {2238, 47}},   /* Q == 4 : 25-32% */
+    {{ 714,128}, {1418, 74}, {2436, 53}},   /* Q == 5 : 32-38% */
+    {{ 883,128}, {1437, 74}, {2464, 61}},   /* Q == 6 : 38-44% */
+    {{ 897,128}, {1515, 75}, {2622, 68}},   /* Q == 7 : 44-50% */
+    {{ 926,128}, {1613, 75}, {2730, 75}},   /* Q == 8 : 50-56% */
+    {{ 947,128}, {1729, 77}, {3359, 77}},   /* Q == 9 : 56-62% */
+    {{1107,128}, {2083, 81}, {4006, 84}},   /* Q ==10 : 62-69% */
+    {{1177,128}, {2379, 87}, {4785, 88}},   /* Q ==11 : 69-75% */
+    {{1242,128}, {2415, 93}, {5155, 84}},   /* Q ==12 : 75-81% */
+    {{1349,128}, {2644,106}, {5260,106}},   /* Q ==13 : 81-87% */
+    {{1455,128}, {2422,124}, {4174,124}},   /* Q ==14 : 87-93% */
+    {{ 722,128}, {1891,145}, {1936,146}},   /* Q ==15 : 93-99% */
+};
+
+typedef size_t (*decompressionAlgo)(void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+
+
+/* Decoder calibration
+   Times the 3 decoders on synthetic blocks, one per Q bucket, at 2 block sizes.
+   Resulting unit is nanoseconds, same as the static table. */
+#define HUF_CALIB_SMALL   (1 * 1024)
+#define HUF_CALIB_LARGE  (12 * 1024)   /* stays within 4-streams format */
+#define HUF_CALIB_CBOUND  HUF_COMPRESSBOUND(HUF_CALIB_LARGE)
+#define HUF_CALIB_TIMEMIN (CLOCKS_PER_SEC / 1000)
+#define HUF_CALIB_NBPASS  2
+
+static U32 HUF_calibRand(U32* seed)
+{
+    U32 r = *seed;
+    r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+    *seed = r;
+    return r;
+}
+
+/* geometric distribution of ratio r over 256 symbols; r==0 => single symbol, r==1 => uniform */
+static void HUF_calibGenerate(BYTE* dst, size_t size, double r, U32 seed)
+{
+    BYTE table[4096];
+    double w = 1., total = 0.;
+    U32 s, pos = 0;
+    size_t i;
+
+    for (s=0; s<256; s++) { total += w; w *= r; }
+    w = 1.;
+    for (s=0; (s<256) && (pos<4096); s++)
+    {
+        U32 n = (U32)(w / total * 4096. + 0.5);
+        if (pos + n > 4096) n = 4096 - pos;
+        memset(table+pos, s, n);
+        pos += n;
+        w *= r;
+    }
+    if (pos < 4096) memset(table+pos, 0, 4096-pos);
+    for (i=0; i<size; i++) dst[i] = table[HUF_calibRand(&seed) & 4095];
+}
+
+/* returns nanoseconds per call, best of HUF_CALIB_NBPASS, or an error code */
+static size_t HUF_calibTime(decompressionAlgo decoder, BYTE* dst, size_t dstSize, const BYTE* cSrc, size_t cSrcSize)
+{
+    double best = 1e12;
+    U32 pass;
+
+    for (pass=0; pass<HUF_CALIB_NBPASS; pass++)
+    {
+        U32 nbLoops = 1, n;
+        clock_t elapsed;
+        for ( ; ; nbLoops *= 2)
+        {
+            const clock_t start = clock();
+            for (n=0; n<nbLoops; n++)
+            {
+                const size_t result = decoder(dst, dstSize, cSrc, cSrcSize, 0);
+                if (HUF_isError(result)) return result;
+                if (result != dstSize) return ERROR(GENERIC);
+            }
+            elapsed = clock() - start;
+            if (elapsed >= HUF_CALIB_TIMEMIN) break;
+        }
+        {
+            const double t = (double)elapsed * 1e9 / CLOCKS_PER_SEC / nbLoops;
+            if (t < best) best = t;
+        }
+    }
+    return (size_t)best;
+}
+
+/* find a distribution landing into bucket Q, then time each decoder at 2 sizes */
+static size_t HUF_calibBucket(algo_time_t timings[3], U32 Q, BYTE* src, BYTE* cSrc, BYTE* dst)
+{
+    static const decompressionAlgo decompress[3] = { HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6 };
+    static const size_t sizes[2] = { HUF_CALIB_SMALL, HUF_CALIB_LARGE };
+    double rMin = 0., rMax = 1.;
+    size_t cSizes[2];
+    U32 n, s, it;
+
+    /* bisect on compression ratio, which grows with r */
+    for (it=0; it<24; it++)
+    {
+        const double r = (rMin + rMax) / 2;
+        U32 cQ;
+        HUF_calibGenerate(src, HUF_CALIB_LARGE, r, Q+1);
+        cSizes[1] = HUF_compress(cSrc, HUF_CALIB_CBOUND, src, HUF_CALIB_LARGE, 0);
+        if (HUF_isError(cSizes[1])) return cSizes[1];
+        cQ = (cSizes[1] == 0) ? 16 : (U32)(cSizes[1] * 16 / HUF_CALIB_LARGE);
+        if (cQ == Q) break;
+        if (cQ < Q) rMin = r; else rMax = r;
+    }
+    if (it == 24) return 0;   /* bucket not reachable : keep static estimation */
+
+    /* small block : same statistics, compressed separately */
+    cSizes[0] = HUF_compress(cSrc + HUF_CALIB_CBOUND, HUF_CALIB_CBOUND, src, HUF_CALIB_SMALL, 0);
+    if (HUF_isError(cSizes[0])) return cSizes[0];
+    if (cSizes[0] < 2) return 0;
+
+    for (n=0; n<3; n++)
+    {
+        size_t t[2];
+        double d256, table;
+        for (s=0; s<2; s++)
+        {
+            t[s] = HUF_calibTime(decompress[n], dst, sizes[s], cSrc + (1-s)*HUF_CALIB_CBOUND, cSizes[s]);
+            if (HUF_isError(t[s])) return t[s];
+        }
+        d256 = t[1] > t[0] ? (double)(t[1] - t[0]) * 256 / (HUF_CALIB_LARGE - HUF_CALIB_SMALL) : 1.;
+        table = (double)t[0] - d256 * HUF_CALIB_SMALL / 256;
+        timings[n].decode256Time = (U32)d256 + 1;
+        timings[n].tableTime = table > 0. ? (U32)table : 0;
+    }
+    return 1;
+}
+
+
+/* HUF_selectDecoder() :
+   estimate decompression time of each decoder, using timings table algoTime (built-in, or DCtx's own).
+   requires : dstSize > cSrcSize
+   @return : 0 (X2), 1 (X4) or 2 (X6) */
+static U32 HUF_selectDecoder(const algo_time_t (*timings)[3], size_t dstSize, size_t cSrcSize)
+{
+    const U32 Q = (U32)(cSrcSize * 16 / dstSize);   /* Q < 16 since dstSize > cSrcSize */
+    const U64 D256 = (U64)(dstSize >> 8);
+    U64 Dtime[3];   /* large blocks overflow 32 bits */
+    U32 algoNb = 0;
+    int n;
+
+    for (n=0; n<3; n++)
+        Dtime[n] = timings[Q][n].tableTime + (timings[Q][n].decode256Time * D256);
+
+    // Dtime[1] += Dtime[1] >> 4; Dtime[2] += Dtime[2] >> 3; /* advantage to algorithms using less memory */
+
+    if (Dtime[1] < Dtime[0]) algoNb = 1;
+    if (Dtime[2] < Dtime[algoNb]) algoNb = 2;
+    return algoNb;
+}
+
+size_t HUF_decompress (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    static const decompressionAlgo decompress[3][3] = { { HUF_decompress1X2, HUF_decompress1X4, HUF_decompress1X6 },
+                                                        { HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6 },
+                                                        { HUF_decompress8X2, HUF_decompress8X4, HUF_decompress8X6 } };
+    U32 nbStreams;
+    size_t lSize;
+
+    /* validation checks */
+    if (dstSize == 0) return ERROR(dstSize_tooSmall);
+    if (cSrcSize > dstSize) return ERROR(corruption_detected);   /* invalid */
+    if (cSrcSize == dstSize) { memcpy(dst, cSrc, dstSize); return dstSize; }   /* not compressed */
+    if (cSrcSize == 1) { memset(dst, ((const BYTE*)cSrc)[0], dstSize); return dstSize; }   /* RLE */
+
+    lSize = HUF_readLayout(&nbStreams, cSrc, cSrcSize, dstSize);
+    if (HUF_isError(lSize)) return lSize;
+    return decompress[nbStreams >> 2][HUF_selectDecoder(algoTime, dstSize, cSrcSize)](dst, dstSize, cSrc, cSrcSize, scrambler);   /* 1, 4, 8 streams => 0, 1, 2 */
+
+    //return HUF_decompress4X2(dst, dstSize, cSrc, cSrcSize);   /* multi-streams single-symbol decoding */
+    //return HUF_decompress4X4(dst, dstSize, cSrc, cSrcSize);   /* multi-streams double-symbols decoding */
+    //return HUF_decompress4X6(dst, dstSize, cSrc, cSrcSize);   /* multi-streams quad-symbols decoding */
+}
+
+/* same as HUF_decompress(), but always uses the compact decoder */
+size_t HUF_decompressXC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    static const decompressionAlgo decompress[3] = { HUF_decompress1XC, HUF_decompress4XC, HUF_decompress8XC };
+    U32 nbStreams;
+    size_t lSize;
+
+    /* validation checks */
+    if (dstSize == 0) return ERROR(dstSize_tooSmall);
+    if (cSrcSize > dstSize) return ERROR(corruption_detected);   /* invalid */
+    if (cSrcSize == dstSize) { memcpy(dst, cSrc, dstSize); return dstSize; }   /* not compressed */
+    if (cSrcSize == 1) { memset(dst, ((const BYTE*)cSrc)[0], dstSize); return dstSize; }   /* RLE */
+
+    lSize = HUF_readLayout(&nbStreams, cSrc, cSrcSize, dstSize);
+    if (HUF_isError(lSize)) return lSize;
+    return decompress[nbStreams >> 2](dst, dstSize, cSrc, cSrcSize, scrambler);   /* 1, 4, 8 streams => 0, 1, 2 */
+}
+
+
+/**********************************/
+/* Decompression context          */
+/**********************************/
+#define HUF_DCTX_NOTABLE 3
+
+/* contexts keep the allocator which created them, to release themselves with it */
+static void* HUF_malloc(size_t size, FSE_customMem customMem)
+{
+    if ((customMem.customAlloc == NULL) ^ (customMem.customFree == NULL)) return NULL;   /* both or none */
+    if (customMem.customAlloc == NULL) return malloc(size);
+    return customMem.customAlloc(customMem.opaque, size);
+}
+
+static void HUF_free(void* ptr, FSE_customMem customMem)
+{
+    if (ptr == NULL) return;
+    if (customMem.customFree == NULL) { free(ptr); return; }
+    customMem.customFree(customMem.opaque, ptr);
+}
+
+struct HUF_DCtx_s
+{
+    FSE_customMem customMem;
+    U32 algoNb;   /* decoder able to use stored DTable; HUF_DCTX_NOTABLE if none */
+    U32 scrambler;   /* scrambler used to build DTable */
+    algo_time_t algoTime[16][3];   /* decoder selection timings : built-in, or host profile */
+    size_t headerSize;
+    BYTE header[HUF_CTABLEBOUND];   /* raw header DTable was built from : an identical header reuses it */
+    union {
+        U16 x2[HUF_DTABLE_SIZE(HUF_MAX_TABLELOG)];
+        U32 x4[HUF_DTABLE_SIZE(HUF_MAX_TABLELOG)];
+        U32 x6[HUF_DTABLE_SIZE(HUF_MAX_TABLELOG) * 3 / 2];
+    } DTable;
+};
+
+HUF_DCtx* HUF_createDCtx_advanced(FSE_customMem customMem)
+{
+    HUF_DCtx* const dctx = (HUF_DCtx*)HUF_malloc(sizeof(HUF_DCtx), customMem);
+    if (dctx) { dctx->customMem = customMem; dctx->algoNb = HUF_DCTX_NOTABLE; dctx->headerSize = 0; HUF_resetDecoderProfile(dctx); }
+    return dctx;
+}
+
+HUF_DCtx* HUF_createDCtx(void)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return HUF_createDCtx_advanced(defaultMem);
+}
+
+size_t HUF_freeDCtx(HUF_DCtx* dctx) { if (dctx) HUF_free(dctx, dctx->customMem); return 0; }
+
+/* decoder selection profile : owned by each DCtx, built-in algoTime stays read-only */
+size_t HUF_calibrateDecoders(HUF_DCtx* dctx)
+{
+    algo_time_t measured[16][3];
+    BYTE* const src = (BYTE*)malloc(HUF_CALIB_LARGE);
+    BYTE* const cSrc = (BYTE*)malloc(2 * HUF_CALIB_CBOUND);
+    BYTE* const dst = (BYTE*)malloc(HUF_CALIB_LARGE);
+    size_t result = 0;
+    U32 Q;
+
+    memcpy(measured, algoTime, sizeof(measured));
+    if (!src || !cSrc || !dst) result = ERROR(memory_allocation);
+    for (Q=2; (Q<16) && !HUF_isError(result); Q++)
+        result = HUF_calibBucket(measured[Q], Q, src, cSrc, dst);
+
+    free(src);
+    free(cSrc);
+    free(dst);
+    if (HUF_isError(result)) return result;
+
+    memcpy(dctx->algoTime, measured, sizeof(dctx->algoTime));
+    return 0;
+}
+
+#define HUF_PROFILE_MAGIC 0x48DEC0F1
+
+size_t HUF_saveDecoderProfile(const HUF_DCtx* dctx, void* dst, size_t dstCapacity)
+{
+    BYTE* op = (BYTE*)dst;
+    U32 Q, n;
+
+    if (dstCapacity < HUF_DECODER_PROFILE_SIZE) return ERROR(dstSize_tooSmall);
+    MEM_writeLE32(op, HUF_PROFILE_MAGIC); op += 4;
+    for (Q=0; Q<16; Q++)
+        for (n=0; n<3; n++)
+        {
+            MEM_writeLE32(op, dctx->algoTime[Q][n].tableTime); op += 4;
+            MEM_writeLE32(op, dctx->algoTime[Q][n].decode256Time); op += 4;
+        }
+    return HUF_DECODER_PROFILE_SIZE;
+}
+
+size_t HUF_loadDecoderProfile(HUF_DCtx* dctx, const void* src, size_t srcSize)
+{
+    algo_time_t loaded[16][3];
+    const BYTE* ip = (const BYTE*)src;
+    U32 Q, n;
+
+    if (srcSize < HUF_DECODER_PROFILE_SIZE) return ERROR(srcSize_wrong);
+    if (MEM_readLE32(ip) != HUF_PROFILE_MAGIC) return ERROR(corruption_detected);
+    ip += 4;
+    for (Q=0; Q<16; Q++)
+        for (n=0; n<3; n++)
+        {
+            loaded[Q][n].tableTime = MEM_readLE32(ip); ip += 4;
+            loaded[Q][n].decode256Time = MEM_readLE32(ip); ip += 4;
+        }
+
+    memcpy(dctx->algoTime, loaded, sizeof(dctx->algoTime));
+    return HUF_DECODER_PROFILE_SIZE;
+}
+
+void HUF_resetDecoderProfile(HUF_DCtx* dctx) { memcpy(dctx->algoTime, algoTime, sizeof(dctx->algoTime)); }
+
+
+size_t HUF_decompress_usingDCtx (HUF_DCtx* dctx, void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler)
+{
+    const BYTE* ip = (const BYTE*) cSrc;
+    U32 nbStreams;
+    U32 algoNb;
+    size_t hSize;
+
+    /* validation checks */
+    if (dstSize == 0) return ERROR(dstSize_tooSmall);
+    if (cSrcSize > dstSize) return ERROR(corruption_detected);   /* invalid */
+    if (cSrcSize == dstSize) { memcpy(dst, cSrc, dstSize); return dstSize; }   /* not compressed; keeps previous table */
+    if (cSrcSize == 1) { memset(dst, ip[0], dstSize); return dstSize; }   /* RLE; keeps previous table */
+
+    /* layout */
+    hSize = HUF_readLayout(&nbStreams, ip, cSrcSize, dstSize);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    /* get DTable */
+    if (ip[0] == HUF_REPEAT_HEADER)
+    {
+        if (dctx->algoNb == HUF_DCTX_NOTABLE) return ERROR(corruption_detected);
+        algoNb = dctx->algoNb;
+        hSize = 1;
+    }
+    else if ( (dctx->algoNb != HUF_DCTX_NOTABLE) && (dctx->scrambler == scrambler) && (dctx->headerSize > 0)
+           && (dctx->headerSize < cSrcSize) && (!memcmp(ip, dctx->header, dctx->headerSize)) )
+    {
+        /* same header as stored table : skip DTable construction (header is self-delimiting) */
+        algoNb = dctx->algoNb;
+        hSize = dctx->headerSize;
+    }
+    else
+    {
+        algoNb = HUF_selectDecoder((const algo_time_t (*)[3])dctx->algoTime, dstSize, cSrcSize);
+        dctx->algoNb = HUF_DCTX_NOTABLE;   /* DTable content is invalid if reading fails */
+        switch(algoNb)
+        {
+        case 0 : dctx->DTable.x2[0] = HUF_MAX_TABLELOG;
+                 hSize = HUF_readDTableX2(dctx->DTable.x2, ip, cSrcSize, scrambler); break;
+        case 1 : dctx->DTable.x4[0] = HUF_MAX_TABLELOG;
+                 hSize = HUF_readDTableX4(dctx->DTable.x4, ip, cSrcSize, scrambler); break;
+        default: dctx->DTable.x6[0] = HUF_MAX_TABLELOG;
+                 hSize = HUF_readDTableX6(dctx->DTable.x6, ip, cSrcSize, scrambler); break;
+        }
+        if (HUF_isError(hSize)) return hSize;
+        dctx->algoNb = algoNb;
+        dctx->scrambler = scrambler;
+        dctx->headerSize = 0;   /* no cache if header doesn't fit */
+        if (hSize <= sizeof(dctx->header))
+        {
+            memcpy(dctx->header, ip, hSize);
+            dctx->headerSize = hSize;
+        }
+    }
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    /* decode */
+    switch(algoNb)
+    {
+    case 0 : if (nbStreams==1) return HUF_decompress1X2_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x2);
+             if (nbStreams==4) return HUF_decompress4X2_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x2);
+             return HUF_decompress8X2_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x2);
+    case 1 : if (nbStreams==1) return HUF_decompress1X4_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x4);
+             if (nbStreams==4) return HUF_decompress4X4_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x4);
+             return HUF_decompress8X4_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x4);
+    default: if (nbStreams==1) return HUF_decompress1X6_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x6);
+             if (nbStreams==4) return HUF_decompress4X6_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x6);
+             return HUF_decompress8X6_usingDTable(dst, dstSize, ip, cSrcSize, dctx->DTable.x6);
+    }
+}
+
+
+size_t HUF_inPlaceMargin(size_t size) { return HUF_INPLACE_MARGIN(size); }
+
+size_t HUF_decompress_inPlace (void* buffer, size_t bufferSize, size_t dstSize, size_t cSrcSize, unsigned scrambler)
+{
+    HUF_CREATE_STATIC_DTABLEX2(DTable, HUF_MAX_TABLELOG);
+    BYTE* const ostart = (BYTE*)buffer;
+    BYTE* ip;
+    U32 nbStreams;
+    size_t hSize;
+
+    /* validation checks */
+    if (dstSize == 0) return ERROR(dstSize_tooSmall);
+    if (cSrcSize > dstSize) return ERROR(corruption_detected);   /* invalid */
+    if (dstSize > bufferSize) return ERROR(dstSize_tooSmall);
+    ip = ostart + bufferSize - cSrcSize;
+    if (cSrcSize == dstSize) { memmove(ostart, ip, dstSize); return dstSize; }   /* not compressed */
+    if (cSrcSize == 1) { memset(ostart, ip[0], dstSize); return dstSize; }   /* RLE */
+
+    /* header, table and jump table are fully read before anything is written into buffer */
+    hSize = HUF_readLayout(&nbStreams, ip, cSrcSize, dstSize);
+    if (HUF_isError(hSize)) return hSize;
+    ip += hSize;
+    cSrcSize -= hSize;
+    hSize = HUF_readDTableX2 (DTable, ip, cSrcSize, scrambler);
+    if (HUF_isError(hSize)) return hSize;
+    if (hSize >= cSrcSize) return ERROR(srcSize_wrong);
+    ip += hSize;
+    cSrcSize -= hSize;
+
+    return HUF_decompressX2_inPlace_usingDTable (ostart, dstSize, ip, cSrcSize, DTable, nbStreams);
+}
+
+
+/**********************************/
+/* Forward streams                */
+/**********************************/
+
+/* HUF_headerSize() : size of table description, deduced from its first byte */
+static size_t HUF_headerSize(const BYTE* ip)
+{
+    const U32 h = ip[0];
+    if (h >= 242) return 1;   /* RLE weights */
+    if (h == HUF_REPEAT_HEADER) return 1;
+    if (h >= 128) return 1 + ((h-127)+1)/2;   /* raw weights */
+    return 1 + h;   /* FSE-compressed weights */
+}
+
+size_t HUF_reverseStreams(void* cSrc, size_t cSrcSize, size_t dstSize)
+{
+    BYTE* const istart = (BYTE*)cSrc;
+    const U32 jumpSize = HUF_JUMP_SIZE(dstSize);
+    size_t jumpTableSize;
+    size_t length[HUF_MAX_NB_STREAMS];
+    size_t lengthTotal;
+    BYTE* ip;
+    U32 nbStreams;
+    U32 k;
+
+    if ((cSrcSize <= 1) || (cSrcSize == dstSize)) return cSrcSize;   /* not compressed, or RLE : no bitStream */
+    if (cSrcSize > dstSize) return ERROR(corruption_detected);
+    lengthTotal = HUF_readLayout(&nbStreams, istart, cSrcSize, dstSize);
+    if (HUF_isError(lengthTotal)) return lengthTotal;
+    jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
+    ip = istart + lengthTotal;
+    ip += HUF_headerSize(ip);
+    lengthTotal = (size_t)(ip - istart) + jumpTableSize;
+    if (lengthTotal + nbStreams > cSrcSize) return ERROR(corruption_detected);   /* strict minimum : jump table + 1 byte per stream */
+
+    /* all lengths are validated before anything is modified */
+    for (k=0; k<nbStreams-1; k++)
+    {
+        length[k] = HUF_readJump(ip + jumpSize*k, jumpSize);
+        if (length[k] > cSrcSize - lengthTotal) return ERROR(corruption_detected);   /* overflow */
+        lengthTotal += length[k];
+    }
+    length[nbStreams-1] = cSrcSize - lengthTotal;
+
+    ip += jumpTableSize;
+    for (k=0; k<nbStreams; k++)
+    {
+        BIT_reverseBytes(ip, length[k]);
+        ip += length[k];
+    }
+
+    return cSrcSize;
+}
+
+
+/* forward variant of HUF_decodeStreamX2() : while stream is incomplete (complete==0),
+   decoding stops before any reload would read beyond iLimit; it resumes on next call */
+FORCE_INLINE BYTE* HUF_decodeStreamX2_forward_body(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* pEnd,
+                                                   const BYTE* iLimit, unsigned complete,
+                                                   const HUF_DEltX2* dt, U32 dtLog)
+{
+    BIT_DStream_t bitD = *bitDPtr;   /* local copy : stays in registers */
+
+    /* up to 4 symbols at a time */
+    while ((complete || ((const BYTE*)bitD.ptr + 2*sizeof(bitD.bitContainer) <= iLimit))
+        && (BIT_reloadForwardDStream(&bitD) == BIT_DStream_unfinished) && (p <= pEnd-4))
+    {
+        HUF_DECODE_SYMBOLX2_2(p, &bitD);
+        HUF_DECODE_SYMBOLX2_1(p, &bitD);
+        HUF_DECODE_SYMBOLX2_2(p, &bitD);
+        HUF_DECODE_SYMBOLX2_0(p, &bitD);
+    }
+
+    if (complete)
+    {
+        /* closer to the end */
+        while ((BIT_reloadForwardDStream(&bitD) == BIT_DStream_unfinished) && (p < pEnd))
+            HUF_DECODE_SYMBOLX2_0(p, &bitD);
+
+        /* no more data to retrieve from bitstream, hence no need to reload */
+        while (p < pEnd)
+            HUF_DECODE_SYMBOLX2_0(p, &bitD);
+    }
+
+    *bitDPtr = bitD;
+    return p;
+}
+
+static BYTE* HUF_decodeStreamX2_forward(BYTE* p, BIT_DStream_t* bitDPtr, BYTE* pEnd, const BYTE* iLimit, unsigned complete, const HUF_DEltX2* dt, U32 dtLog);
+CPU_DISPATCH_BMI2(BYTE*, HUF_decodeStreamX2_forward,
+                  (BYTE* p, BIT_DStream_t* bitDPtr, BYTE* pEnd, const BYTE* iLimit, unsigned complete, const HUF_DEltX2* dt, U32 dtLog),
+                  (p, bitDPtr, pEnd, iLimit, complete, dt, dtLog))
+
+typedef enum { HUF_fwd_raw, HUF_fwd_header, HUF_fwd_streamInit, HUF_fwd_stream, HUF_fwd_done } HUF_fwdStage;
+
+struct HUF_ForwardDCtx_s
+{
+    FSE_customMem customMem;
+    U16 DTable[HUF_DTABLE_SIZE(HUF_MAX_TABLELOG)];
+    BIT_DStream_t bitD;   /* current stream */
+    BYTE* dst;
+    size_t dstSize;
+    size_t cSrcSize;
+    size_t decoded;   /* dst[0..decoded-1] is regenerated */
+    size_t streamStart;   /* position of current stream within cSrc */
+    size_t length[HUF_MAX_NB_STREAMS];
+    U32 nbStreams;
+    U32 streamNb;
+    U32 scrambler;
+    HUF_fwdStage stage;
+};
+
+HUF_ForwardDCtx* HUF_createForwardDCtx_advanced(FSE_customMem customMem)
+{
+    HUF_ForwardDCtx* const fctx = (HUF_ForwardDCtx*)HUF_malloc(sizeof(HUF_ForwardDCtx), customMem);
+    if (fctx) { fctx->customMem = customMem; fctx->stage = HUF_fwd_done; }
+    return fctx;
+}
+
+HUF_ForwardDCtx* HUF_createForwardDCtx(void)
+{
+    FSE_customMem const defaultMem = { NULL, NULL, NULL };
+    return HUF_createForwardDCtx_advanced(defaultMem);
+}
+
+size_t HUF_freeForwardDCtx(HUF_ForwardDCtx* fctx) { if (fctx) HUF_free(fctx, fctx->customMem); return 0; }
+
+size_t HUF_initForwardDecoding(HUF_ForwardDCtx* fctx, void* dst, size_t dstSize, size_t cSrcSize, unsigned scrambler)
+{
+    fctx->stage = HUF_fwd_done;
+    if (dstSize == 0) return ERROR(dstSize_tooSmall);
+    if ((cSrcSize == 0) || (cSrcSize > dstSize)) return ERROR(corruption_detected);   /* invalid */
+    fctx->dst = (BYTE*)dst;
+    fctx->dstSize = dstSize;
+    fctx->cSrcSize = cSrcSize;
+    fctx->decoded = 0;
+    fctx->scrambler = scrambler;
+    fctx->stage = (cSrcSize == dstSize) ? HUF_fwd_raw : HUF_fwd_header;
+    return 0;
+}
+
+size_t HUF_decompressForward_continue(HUF_ForwardDCtx* fctx, const void* cSrc, size_t availableSize)
+{
+    const BYTE* const istart = (const BYTE*)cSrc;
+    const BYTE* const iLimit = istart + availableSize;
+    BYTE* const ostart = fctx->dst;
+    const HUF_DEltX2* const dt = ((const HUF_DEltX2*)fctx->DTable) +1;
+
+    if (availableSize > fctx->cSrcSize) return ERROR(srcSize_wrong);
+    if ((availableSize == 0) || (fctx->stage == HUF_fwd_done)) return fctx->decoded;
+
+    if (fctx->stage == HUF_fwd_raw)   /* not compressed : regenerated as it arrives */
+    {
+        if (availableSize > fctx->decoded)
+        {
+            memcpy(ostart + fctx->decoded, istart + fctx->decoded, availableSize - fctx->decoded);
+            fctx->decoded = availableSize;
+        }
+        if (fctx->decoded == fctx->dstSize) fctx->stage = HUF_fwd_done;
+        return fctx->decoded;
+    }
+
+    if (fctx->stage == HUF_fwd_header)
+    {
+        const size_t dstSize = fctx->dstSize;
+        const U32 jumpSize = HUF_JUMP_SIZE(dstSize);
+        size_t jumpTableSize, lSize, hSize, lengthTotal;
+        U32 nbStreams, k;
+
+        if (fctx->cSrcSize == 1)   /* RLE */
+        {
+            memset(ostart, istart[0], dstSize);
+            fctx->decoded = dstSize;
+            fctx->stage = HUF_fwd_done;
+            return dstSize;
+        }
+
+        /* layout, header, table and jump table are needed before first stream */
+        lSize = HUF_readLayout(&nbStreams, istart, availableSize, dstSize);
+        if (HUF_isError(lSize)) return lSize;
+        jumpTableSize = HUF_JUMPTABLE_SIZE(nbStreams, jumpSize);
+        if ((availableSize < fctx->cSrcSize) && (availableSize <= lSize)) return 0;
+        hSize = lSize + HUF_headerSize(istart + lSize);
+        if ((availableSize < fctx->cSrcSize) && (availableSize < hSize + jumpTableSize)) return 0;
+        fctx->DTable[0] = HUF_MAX_TABLELOG;
+        hSize = HUF_readDTableX2(fctx->DTable, istart + lSize, availableSize - lSize, fctx->scrambler);
+        if (HUF_isError(hSize)) return hSize;
+        hSize += lSize;
+        lengthTotal = hSize + jumpTableSize;
+        if (lengthTotal + nbStreams > fctx->cSrcSize) return ERROR(corruption_detected);   /* strict minimum : jump table + 1 byte per stream */
+        if (((dstSize+nbStreams-1) / nbStreams) * (nbStreams-1) > dstSize) return ERROR(corruption_detected);   /* too small for nbStreams segments */
+        for (k=0; k<nbStreams-1; k++)
+        {
+            fctx->length[k] = HUF_readJump(istart + hSize + jumpSize*k, jumpSize);
+            if (fctx->length[k] > fctx->cSrcSize - lengthTotal) return ERROR(corruption_detected);   /* overflow */
+            lengthTotal += fctx->length[k];
+        }
+        fctx->length[nbStreams-1] = fctx->cSrcSize - lengthTotal;
+        fctx->nbStreams = nbStreams;
+        fctx->streamNb = 0;
+        fctx->streamStart = hSize + jumpTableSize;
+        fctx->stage = HUF_fwd_streamInit;
+    }
+
+    /* streams are decoded one after another, each as far as received bytes allow */
+    while (fctx->stage != HUF_fwd_done)
+    {
+        const U32 dtLog = fctx->DTable[0];
+        const size_t segmentSize = (fctx->dstSize + fctx->nbStreams-1) / fctx->nbStreams;
+        const size_t length = fctx->length[fctx->streamNb];
+        const unsigned complete = (availableSize >= fctx->streamStart + length);
+        BYTE* const oend = (fctx->streamNb == fctx->nbStreams-1) ? ostart + fctx->dstSize : ostart + (fctx->streamNb+1)*segmentSize;
+        BYTE* op;
+
+        if (fctx->stage == HUF_fwd_streamInit)
+        {
+            size_t errorCode;
+            if (!complete && (availableSize < fctx->streamStart + sizeof(fctx->bitD.bitContainer))) break;
+            errorCode = BIT_initForwardDStream(&fctx->bitD, istart + fctx->streamStart, length);
+            if (HUF_isError(errorCode)) return errorCode;
+            fctx->stage = HUF_fwd_stream;
+        }
+
+        op = HUF_decodeStreamX2_forward(ostart + fctx->decoded, &fctx->bitD, oend, iLimit, complete, dt, dtLog);
+        fctx->decoded = (size_t)(op - ostart);
+        if (!complete) break;
+
+        if (!BIT_endOfDStream(&fctx->bitD)) return ERROR(corruption_detected);
+        fctx->streamStart += length;
+        fctx->streamNb++;
+        fctx->stage = (fctx->streamNb == fctx->nbStreams) ? HUF_fwd_done : HUF_fwd_streamInit;
+    }
+
+    return fctx->decoded;
 }
@@ -56,7 +56,9 @@ size_t HUF_decompress(void* dst,  size_t dstSize,
 HUF_compress():
     Compress content of buffer 'src', of size 'srcSize', into destination buffer 'dst'.
     'dst' buffer must be already allocated. Compression runs faster if maxDstSize >= HUF_compressBound(srcSize).
-    Note : srcSize must be <= 128 KB
+    Note : srcSize must be <= 512 MB. Blocks > 128 KB use a large-block format, with 32-bit segment sizes.
+    'scrambler' : 0 = none. Otherwise, it keys both the table header, and the assignment of codes among symbols of same length.
+                  The same value must be provided to HUF_decompress(). Decoding speed is unaffected.
     return : size of compressed data (<= maxDstSize)
     Special values : if return == 0, srcData is not compressible => Nothing is stored within dst !!!
                      if return == 1, srcData is a single repeated byte symbol (RLE compression)
@@ -76,6 +78,7 @@ HUF_decompress():
 *  Tool functions
 ******************************************/
 size_t HUF_compressBound(size_t size);       /* maximum compressed size */
+size_t HUF_inPlaceMargin(size_t size);       /* extra buffer space required by HUF_decompress_inPlace() */
 
 /* Error Management */
 unsigned    HUF_isError(size_t code);        /* tells if a return value is an error code */
@@ -85,7 +88,35 @@ const char* HUF_getErrorName(size_t code);   /* provides error code string (usef
 /******************************************
 *  Advanced functions
 ******************************************/
+#define HUF_TABLELOG_AUTO 255
 size_t HUF_compress2 (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+/*
+HUF_compress2():
+    Same as HUF_compress(), with control over maxSymbolValue (0 = 255) and tableLog (0 = default, max 12).
+    tableLog == HUF_TABLELOG_AUTO : selects the shallowest tree whose compressed size stays within ~1% of the best one.
+    Shallower trees decode faster, since decoding tables are smaller and quicker to build.
+*/
+
+size_t HUF_compress2_sampled (void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned maxSymbolValue, unsigned tableLog, unsigned scrambler);
+/*
+HUF_compress2_sampled():
+    Same as HUF_compress2(), but blocks >= 4 KB using the full byte range are sampled first,
+    and return 0 (not compressible) without counting when they look incompressible (typically already compressed data).
+    Much faster on such blocks; when the sample looks compressible, result is identical to HUF_compress2().
+*/
+
+size_t HUF_decompress_inPlace (void* buffer, size_t bufferSize, size_t dstSize, size_t cSrcSize, unsigned scrambler);
+/*
+HUF_decompress_inPlace():
+    Same as HUF_decompress(), but regenerated data overwrites its own compressed source.
+    Compressed data must be placed at the end of 'buffer', in its last 'cSrcSize' bytes.
+    'dstSize' bytes are regenerated at the beginning of 'buffer'.
+    Success is guaranteed if bufferSize >= dstSize + HUF_inPlaceMargin(dstSize).
+    Compressed data is destroyed in the process, even if decoding fails.
+    return : size of regenerated data (== dstSize)
+             or an error code, which can be tested using HUF_isError()
+             (dstSize_tooSmall if decoding would overwrite compressed data not yet read)
+*/
 
 
 #if defined (__cplusplus)
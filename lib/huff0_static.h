@@ -43,6 +43,15 @@ extern "C" {
 *  Dependency
 ******************************************/
 #include "huff0.h"
+#include "fse.h"      /* FSE_customMem */
+
+
+/******************************************
+*  Types
+******************************************/
+typedef struct HUF_CElt_s HUF_CElt;   /* incomplete type; allocate with HUF_CREATE_STATIC_CTABLE() */
+typedef struct HUF_DCtx_s HUF_DCtx;   /* incomplete type */
+typedef struct HUF_ForwardDCtx_s HUF_ForwardDCtx;   /* incomplete type */
 
 
 /******************************************
@@ -52,6 +61,16 @@ extern "C" {
 #define HUF_CTABLEBOUND 129
 #define HUF_BLOCKBOUND(size) (size + (size>>8) + 8)   /* only true if incompressible pre-filtered with fast heuristic */
 #define HUF_COMPRESSBOUND(size) (HUF_CTABLEBOUND + HUF_BLOCKBOUND(size))   /* Macro version, useful for static allocation */
+#define HUF_4STREAMS_MINSIZE 256   /* HUF_compress() encodes smaller blocks into a single stream, without jump table */
+#define HUF_8STREAMS_MINSIZE (16 * 1024)   /* HUF_compress() splits blocks of this size or larger into 8 streams (14-bytes jump table), smaller ones into 4 (6 bytes) */
+#define HUF_SMALLBLOCK_MAX (128 * 1024)   /* larger blocks use the large-block format : 8 streams, 32-bit segment sizes (28-bytes jump table) */
+#define HUF_BLOCKSIZE_MAX (512 * 1024 * 1024)   /* absolute block size limit */
+#define HUF_INPLACE_MARGIN(size) (((size) / 3) + 16)   /* HUF_decompress_inPlace() : symbols cost at most 12 bits */
+
+/* static allocation of Huff0's CTable */
+#define HUF_CTABLE_SIZE_U32(maxSymbolValue)   ((maxSymbolValue)+1)   /* Use tables of U32, for proper alignment */
+#define HUF_CREATE_STATIC_CTABLE(name, maxSymbolValue) \
+        unsigned name##hb[HUF_CTABLE_SIZE_U32(maxSymbolValue)]; HUF_CElt* const name = (HUF_CElt*)(void*)name##hb
 
 /* static allocation of Huff0's DTable */
 #define HUF_DTABLE_SIZE(maxTableLog)   (1 + (1<<maxTableLog))  /* nb Cells; use unsigned short for X2, unsigned int for X4 */
@@ -61,6 +80,9 @@ extern "C" {
         unsigned int DTable[HUF_DTABLE_SIZE(maxTableLog)] = { maxTableLog }
 #define HUF_CREATE_STATIC_DTABLEX6(DTable, maxTableLog) \
         unsigned int DTable[HUF_DTABLE_SIZE(maxTableLog) * 3 / 2] = { maxTableLog }
+#define HUF_DTABLEXC_SIZE_U32 144   /* compact decoder : fixed size, whatever the tableLog */
+#define HUF_CREATE_STATIC_DTABLEXC(DTable) \
+        unsigned int DTable[HUF_DTABLEXC_SIZE_U32]
 
 
 /******************************************
@@ -70,6 +92,123 @@ size_t HUF_decompress4X2 (void* dst, size_t dstSize, const void* cSrc, size_t cS
 size_t HUF_decompress4X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* double-symbols decoder */
 size_t HUF_decompress4X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* quad-symbols decoder */
 
+/* Blocks of size < HUF_4STREAMS_MINSIZE are compressed into a single stream : use following decoders
+   (HUF_decompress() selects the right format automatically, from the layout byte described below) */
+size_t HUF_decompress1X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* single-symbol decoder */
+size_t HUF_decompress1X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* double-symbols decoder */
+size_t HUF_decompress1X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* quad-symbols decoder */
+
+/* Blocks of size >= HUF_8STREAMS_MINSIZE are compressed into 8 streams : use following decoders
+   (HUF_decompress() selects the right format automatically).
+   Such blocks, as well as single-stream ones, start with a layout byte, before the table header :
+   HUF_decompress() decodes blocks without it with the original 4-streams layout, whatever their size (up to HUF_SMALLBLOCK_MAX).
+   Decoders of a given layout skip a matching layout byte */
+size_t HUF_decompress8X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* single-symbol decoder */
+size_t HUF_decompress8X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* double-symbols decoder */
+size_t HUF_decompress8X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);   /* quad-symbols decoder */
+
+/* Compact decoder
+   Decoding tables above use 2^tableLog cells (8 KB for X2, 16-24 KB for X4/X6), competing for L1/L2 cache
+   with other tenants of a core. The compact decoder uses a fixed table of HUF_DTABLEXC_SIZE_U32*4 bytes
+   (canonical first codes per weight, and a small lookup table for short codes), at the cost of decoding speed.
+   It is never selected by HUF_decompress() : call it explicitly.
+   HUF_decompressXC() : same as HUF_decompress(), selecting the layout (1, 4 or 8 streams) the same way.
+   HUF_readDTableXC() : builds a compact table into DTable (see HUF_CREATE_STATIC_DTABLEXC()).
+                        return : header size, or an error code */
+size_t HUF_decompressXC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+size_t HUF_decompress1XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+size_t HUF_decompress4XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+size_t HUF_decompress8XC (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+size_t HUF_readDTableXC (unsigned* DTable, const void* src, size_t srcSize, unsigned scrambler);
+size_t HUF_decompress1XC_usingDTable (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const unsigned* DTable);
+size_t HUF_decompress4XC_usingDTable (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const unsigned* DTable);
+size_t HUF_decompress8XC_usingDTable (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, const unsigned* DTable);
+
+/* Table reuse across blocks
+   A compressed block is a table header, followed by the compressed body.
+   The header either describes a new table (HUF_writeCTable()), or tells to reuse the table of previous block (HUF_writeRepeatHeader()).
+   Repeat blocks save both header space and decoding table construction, which matters most for small blocks.
+   Only HUF_decompress_usingDCtx() can decode repeat blocks; other decoders fail with corruption_detected.
+
+   HUF_buildCTable() : builds a CTable from symbol statistics (from FSE_count()), limiting code length to maxNbBits (0 = default).
+                       return : tableLog actually used (for HUF_writeCTable()), or an error code
+   HUF_optimalTableLog() : selects maxNbBits for HUF_buildCTable(), as the shallowest depth (up to maxTableLog, 0 = default)
+                       whose estimated block size (header + body) stays within ~1% of the best one.
+                       Shallower trees give smaller decoding tables, faster to build. return : depth, or an error code
+   HUF_writeCTable() : writes the header describing CTable. maxSymbolValue and huffLog as used and returned by HUF_buildCTable().
+                       return : header size, or an error code
+   HUF_scrambleCTable() : re-assigns codes among symbols of same length, in an order derived from scrambler
+                          (scrambler==0 : canonical order, as built by HUF_buildCTable()). Code lengths are unchanged.
+                          Required before HUF_compress_usingCTable() when the header is written with a non-zero scrambler,
+                          since decoders assign codes the same way. return : 0, or an error code
+   HUF_writeRepeatHeader() : writes a 1-byte header "same table as previous block".
+   HUF_writeLayoutHeader() : writes the layout byte which must precede the table header (or repeat header)
+                       when srcSize selects 1 or 8 streams (srcSize < HUF_4STREAMS_MINSIZE, or >= HUF_8STREAMS_MINSIZE).
+                       return : nb of bytes written (0 or 1), or an error code
+   HUF_compress_usingCTable() : compresses src into a block body. All symbols present in src must have a code within CTable.
+                       return : body size, 0 if it doesn't fit into dst, or an error code
+                       Note : total block size (layout + header + body) must remain < srcSize-1, since the decoder interprets
+                              cSrcSize==dstSize as raw data, and cSrcSize==1 as RLE : otherwise, store the block raw.
+   HUF_compress4X_usingCTable() : same, but always uses the original 4-streams layout, without layout byte
+                       (srcSize <= HUF_SMALLBLOCK_MAX), decodable by HUF_decompress4X*().
+   HUF_validateCTable() : tells if CTable can encode all symbols with non-zero count (1 == yes).
+                          maxSymbolValue must be <= the one used to build CTable.
+   HUF_estimateCompressedSize() : body size estimation (without jump table) for symbols statistics count[], using CTable.
+                          Compare with a new table's header + body to decide whether to repeat.
+   HUF_decompress_usingDCtx() : same as HUF_decompress(), but keeps last decoded table within dctx, for following repeat blocks.
+                                A block whose header is byte-identical to the one of the kept table (same scrambler) also reuses it,
+                                skipping decoding table construction. Raw and RLE blocks keep the previous table. */
+size_t HUF_buildCTable (HUF_CElt* CTable, const unsigned* count, unsigned maxSymbolValue, unsigned maxNbBits);
+size_t HUF_optimalTableLog (const unsigned* count, unsigned maxSymbolValue, unsigned maxTableLog, unsigned scrambler);
+size_t HUF_writeCTable (void* dst, size_t maxDstSize, const HUF_CElt* CTable, unsigned maxSymbolValue, unsigned huffLog, unsigned scrambler);
+size_t HUF_scrambleCTable (HUF_CElt* CTable, unsigned maxSymbolValue, unsigned scrambler);
+size_t HUF_writeRepeatHeader (void* dst, size_t dstSize);
+size_t HUF_writeLayoutHeader (void* dst, size_t dstSize, size_t srcSize);
+size_t HUF_compress_usingCTable (void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable);
+size_t HUF_compress4X_usingCTable (void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable);
+unsigned HUF_validateCTable (const HUF_CElt* CTable, const unsigned* count, unsigned maxSymbolValue);
+size_t HUF_estimateCompressedSize (const HUF_CElt* CTable, const unsigned* count, unsigned maxSymbolValue);
+
+HUF_DCtx* HUF_createDCtx(void);
+HUF_DCtx* HUF_createDCtx_advanced(FSE_customMem customMem);   /* released by HUF_freeDCtx() with the same allocator */
+size_t    HUF_freeDCtx(HUF_DCtx* dctx);
+size_t    HUF_decompress_usingDCtx (HUF_DCtx* dctx, void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize, unsigned scrambler);
+
+/* Decoder selection
+   HUF_decompress() picks a decoder from timings estimated per compression ratio.
+   Built-in timings were measured on a single reference machine; they are never modified.
+   Each DCtx holds its own copy, used by HUF_decompress_usingDCtx(), which can be replaced by host measurements.
+   HUF_calibrateDecoders() : times the decoders on synthetic data (takes a fraction of a second), and stores result into dctx.
+                             return : 0, or an error code (dctx timings are then unchanged)
+   HUF_saveDecoderProfile() : writes dctx timings into dst, for later reuse (typically into a file, or another DCtx).
+                              return : HUF_DECODER_PROFILE_SIZE, or an error code
+   HUF_loadDecoderProfile() : installs into dctx timings previously written by HUF_saveDecoderProfile(), skipping calibration.
+                              return : nb of bytes read, or an error code (profile not recognized)
+   HUF_resetDecoderProfile() : reverts dctx to built-in timings (initial state of a new DCtx) */
+#define HUF_DECODER_PROFILE_SIZE (4 + 16*3*8)
+size_t HUF_calibrateDecoders(HUF_DCtx* dctx);
+size_t HUF_saveDecoderProfile(const HUF_DCtx* dctx, void* dst, size_t dstCapacity);
+size_t HUF_loadDecoderProfile(HUF_DCtx* dctx, const void* src, size_t srcSize);
+void   HUF_resetDecoderProfile(HUF_DCtx* dctx);
+
+/* Forward streams
+   By default, bitStreams are read backward : decoding can only start once a block is fully received.
+   HUF_reverseStreams() converts a compressed block (as produced by HUF_compress*()) so that its bitStreams are read forward.
+   Converting again restores the original block. Not compressed and RLE blocks are left unmodified.
+   Blocks using HUF_REPEAT_HEADER can be converted, but not decoded incrementally.
+   return : cSrcSize, or an error code
+   A forward block can then be decoded incrementally, while it's being received :
+   HUF_initForwardDecoding() : starts a new block, of compressed size cSrcSize, regenerating dstSize bytes into dst
+   HUF_decompressForward_continue() : availableSize is the nb of bytes of cSrc received so far (always the same cSrc pointer).
+                                      return : nb of bytes regenerated so far, at the beginning of dst (== dstSize when block is complete)
+                                               or an error code; after an error, block must be started again with HUF_initForwardDecoding() */
+size_t HUF_reverseStreams(void* cSrc, size_t cSrcSize, size_t dstSize);
+HUF_ForwardDCtx* HUF_createForwardDCtx(void);
+HUF_ForwardDCtx* HUF_createForwardDCtx_advanced(FSE_customMem customMem);
+size_t HUF_freeForwardDCtx(HUF_ForwardDCtx* fctx);
+size_t HUF_initForwardDecoding(HUF_ForwardDCtx* fctx, void* dst, size_t dstSize, size_t cSrcSize, unsigned scrambler);
+size_t HUF_decompressForward_continue(HUF_ForwardDCtx* fctx, const void* cSrc, size_t availableSize);
+
 
 #if defined (__cplusplus)
 }
@@ -282,7 +282,7 @@ void BMK_benchMem285(chunkParameters_t* chunkP, int nbChunks, char* inFileName,
             {
                 const void* rawPtr = chunkP[chunkNb].origBuffer;
                 const U16* U16chunkPtr = (const U16*) rawPtr;
-                chunkP[chunkNb].compressedSize = FSE_compressU16(chunkP[chunkNb].compressedBuffer, chunkP[chunkNb].origSize, U16chunkPtr, chunkP[chunkNb].origSize/2, 0, memLog);
+                chunkP[chunkNb].compressedSize = FSE_compressU16(chunkP[chunkNb].compressedBuffer, chunkP[chunkNb].origSize, U16chunkPtr, chunkP[chunkNb].origSize/2, 0, memLog, 0);
             }
             nbLoops++;
         }
@@ -308,7 +308,7 @@ void BMK_benchMem285(chunkParameters_t* chunkP, int nbChunks, char* inFileName,
             {
                 void* rawPtr = chunkP[chunkNb].destBuffer;
                 U16* U16dstPtr = (U16*)rawPtr;
-                chunkP[chunkNb].compressedSize = FSE_decompressU16(U16dstPtr, chunkP[chunkNb].origSize/2, chunkP[chunkNb].compressedBuffer, chunkP[chunkNb].compressedSize);
+                chunkP[chunkNb].compressedSize = FSE_decompressU16(U16dstPtr, chunkP[chunkNb].origSize/2, chunkP[chunkNb].compressedBuffer, chunkP[chunkNb].compressedSize, 0);
             }
             nbLoops++;
         }
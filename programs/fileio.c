@@ -223,6 +223,34 @@ void FIO_overwriteMode(void) { g_overwrite = 1; }
 void FIO_setCompressor(FIO_compressor_t c) { g_compressor = c; }
 
 
+/**************************************
+*  Memory allocation
+**************************************/
+static const FIO_customMem FIO_defaultMem = { NULL, NULL, NULL };
+
+static void* FIO_malloc(size_t size, FIO_customMem customMem)
+{
+	if (customMem.customAlloc == NULL) return malloc(size);
+	return customMem.customAlloc(customMem.opaque, size);
+}
+
+static void FIO_free(void* ptr, FIO_customMem customMem)
+{
+	if (ptr == NULL) return;
+	if (customMem.customFree == NULL) { free(ptr); return; }
+	customMem.customFree(customMem.opaque, ptr);
+}
+
+static ZSTD_customMem FIO_zstdMem(FIO_customMem customMem)
+{
+	ZSTD_customMem zstdMem;
+	zstdMem.customAlloc = customMem.customAlloc;
+	zstdMem.customFree = customMem.customFree;
+	zstdMem.opaque = customMem.opaque;
+	return zstdMem;
+}
+
+
 /**************************************
 *  Exceptions
 **************************************/
@@ -256,7 +284,7 @@ static unsigned FIO_GetMilliSpan(clock_t nPrevious)
 }
 
 static int FIO_blockID_to_blockSize(int id) { return (1 << id) KB; }
-size_t FIO_loadFile(void** dict_buffer, const char* dict_file_name);
+size_t FIO_loadFile(void** dict_buffer, const char* dict_file_name, FIO_customMem customMem);
 int FIO_getFiles(FILE** dst_file, FILE** src_file, const char* dst_file_name, const char* src_file_name);
 
 /**************************************
@@ -320,15 +348,41 @@ size_t FIO_ZLIBH_compress(void* dst, size_t dstSize, const void* src, size_t src
 	return (size_t)ZLIBH_compress((char*)dst, (const char*)src, (int)srcSize);
 }
 
-static int password_length = 0;
+/* files often contain already compressed data : blocks are sampled, and stored raw when they look incompressible */
+static size_t FIO_FSE_compress(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned scrambler)
+{
+	return FSE_compress2_sampled(dst, dstSize, src, srcSize, 0, 0, scrambler);
+}
+
+static size_t FIO_HUF_compress(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned scrambler)
+{
+	return HUF_compress2_sampled(dst, dstSize, src, srcSize, 0, 0, scrambler);
+}
+
+/* per-stream scrambler state : no global, so that several streams can be processed concurrently */
+typedef struct
+{
+	const char* password;
+	int passwordLength;
+	randctx rng;
+} FIO_scrambler_t;
+
+static void FIO_initScrambler(FIO_scrambler_t* ctx, const char* password)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->password = password;
+	if (password != NULL) ctx->passwordLength = (int)strlen(password);
+}
 
-static unsigned simlple_scrambler(const char * password, int index)
+static unsigned simlple_scrambler(FIO_scrambler_t* ctx, int index)
 {
-	return abs(getNumber64ForPassword(password + index)) % (unsigned)password[index % password_length];
+	const char* const password = ctx->password;
+	return abs(getNumber64ForPassword(&ctx->rng, password + index)) % (unsigned)password[index % ctx->passwordLength];
 }
 
-static unsigned empty_scrambler(const char * password, int index)
+static unsigned empty_scrambler(FIO_scrambler_t* ctx, int index)
 {
+	(void)ctx; (void)index;
 	return 0;
 }
 
@@ -366,7 +420,7 @@ the compressed data itself.
 STREAMCRC - 3 bytes (including 1-byte blockheader)
 22 bits (xxh32() >> 5) checksum of the original data, big endian
 */
-unsigned long long FIO_compressFilename(const char* output_filename, const char* input_filename, const char* password)
+unsigned long long FIO_compressFilename_advanced(const char* output_filename, const char* input_filename, const char* password, FIO_customMem customMem)
 {
 	U64 filesize = 0;
 	U64 compressedfilesize = 0;
@@ -388,11 +442,11 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 	switch (g_compressor)
 	{
 	case FIO_fse:
-		compressor = FSE_compress;
+		compressor = FIO_FSE_compress;
 		magicNumber = FIO_magicNumber_fse;
 		break;
 	case FIO_huff0:
-		compressor = HUF_compress;
+		compressor = FIO_HUF_compress;
 		magicNumber = FIO_magicNumber_huff0;
 		break;
 	case FIO_zlibh:
@@ -405,8 +459,8 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 
 	/* Allocate Memory */
 	if (inputBlockSize == 0) EXM_THROW(0, "impossible problem, to please static analyzer");
-	in_buff = (char*)malloc(inputBlockSize);
-	out_buff = (char*)malloc(FSE_compressBound(inputBlockSize) + 5);
+	in_buff = (char*)FIO_malloc(inputBlockSize, customMem);
+	out_buff = (char*)FIO_malloc(FSE_compressBound(inputBlockSize) + 5, customMem);
 	if (!in_buff || !out_buff) EXM_THROW(21, "Allocation error : not enough memory");
 
 	////RC4 keystream encrypt attempt
@@ -425,10 +479,11 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 	compressedfilesize += FIO_FRAMEHEADERSIZE;
 
 	unsigned index = 0;
-	unsigned(*scrambler_func)(const char *, int);
+	FIO_scrambler_t scramblerCtx;
+	unsigned(*scrambler_func)(FIO_scrambler_t*, int);
+	FIO_initScrambler(&scramblerCtx, password);
 	if (password != NULL)
 	{
-		password_length = strlen(password);
 		scrambler_func = simlple_scrambler;
 	}
 	else
@@ -436,7 +491,7 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 		scrambler_func = empty_scrambler;
 	}
 
-	FIO_writeLE64(out_buff, getNumber64());
+	FIO_writeLE64(out_buff, getNumber64(&scramblerCtx.rng));
 
 
 
@@ -456,7 +511,7 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 		DISPLAYUPDATE(2, "\rRead : %u MB ", (U32)(filesize >> 20));
 
 		/* Compress Block */
-		cSize = compressor(out_buff + FIO_maxBlockHeaderSize, FSE_compressBound(inputBlockSize), in_buff, inSize, scrambler_func(password, index++));
+		cSize = compressor(out_buff + FIO_maxBlockHeaderSize, FSE_compressBound(inputBlockSize), in_buff, inSize, scrambler_func(&scramblerCtx, index++));
 		if (FSE_isError(cSize)) EXM_THROW(23, "Compression error : %s ", FSE_getErrorName(cSize));
 
 		/* Write cBlock */
@@ -544,14 +599,19 @@ unsigned long long FIO_compressFilename(const char* output_filename, const char*
 		(unsigned long long) filesize, (unsigned long long) compressedfilesize, (double)compressedfilesize / filesize * 100);
 
 	/* clean */
-	free(in_buff);
-	free(out_buff);
+	FIO_free(in_buff, customMem);
+	FIO_free(out_buff, customMem);
 	fclose(finput);
 	fclose(foutput);
 
 	return compressedfilesize;
 }
 
+unsigned long long FIO_compressFilename(const char* output_filename, const char* input_filename, const char* password)
+{
+	return FIO_compressFilename_advanced(output_filename, input_filename, password, FIO_defaultMem);
+}
+
 
 
 size_t FIO_ZLIBH_decompress(void* dst, size_t dstSize, const void* src, size_t srcSize, unsigned scrambler)
@@ -583,7 +643,7 @@ the compressed data itself.
 STREAMCRC - 3 bytes (including 1-byte blockheader)
 22 bits (xxh32() >> 5) checksum of the original data, big endian
 */
-unsigned long long FIO_decompressFilename(const char* output_filename, const char* input_filename, const char* password)
+unsigned long long FIO_decompressFilename_advanced(const char* output_filename, const char* input_filename, const char* password, FIO_customMem customMem)
 {
 	FILE* finput, *foutput;
 	U64   filesize = 0;
@@ -637,8 +697,8 @@ unsigned long long FIO_decompressFilename(const char* output_filename, const cha
 
 	/* Allocate Memory */
 	inputBufferSize = blockSize + FIO_maxBlockHeaderSize;
-	in_buff = (BYTE*)malloc(inputBufferSize);
-	out_buff = (BYTE*)malloc(blockSize);
+	in_buff = (BYTE*)FIO_malloc(inputBufferSize, customMem);
+	out_buff = (BYTE*)FIO_malloc(blockSize, customMem);
 	if (!in_buff || !out_buff) EXM_THROW(33, "Allocation error : not enough memory");
 	ip = in_buff;
 
@@ -648,10 +708,11 @@ unsigned long long FIO_decompressFilename(const char* output_filename, const cha
 	/* Main Loop */
 
 	unsigned index = 0;
-	unsigned(*scrambler_func)(const char *, int);
+	FIO_scrambler_t scramblerCtx;
+	unsigned(*scrambler_func)(FIO_scrambler_t*, int);
+	FIO_initScrambler(&scramblerCtx, password);
 	if (password != NULL)
 	{
-		password_length = strlen(password);
 		scrambler_func = simlple_scrambler;
 	}
 	else
@@ -706,7 +767,7 @@ unsigned long long FIO_decompressFilename(const char* output_filename, const cha
 		{
 		case bt_compressed:
 			//rSize = decompressor(out_buff, rSize, in_buff, cSize, scrambler);
-			rSize = decompressor(out_buff, rSize, in_buff, cSize, scrambler_func(password, index++));
+			rSize = decompressor(out_buff, rSize, in_buff, cSize, scrambler_func(&scramblerCtx, index++));
 			if (FSE_isError(rSize)) EXM_THROW(39, "Decoding error : %s", FSE_getErrorName(rSize));
 			break;
 		case bt_raw:
@@ -759,14 +820,19 @@ unsigned long long FIO_decompressFilename(const char* output_filename, const cha
 	DISPLAYLEVEL(2, "Decoded %llu bytes \n", (long long unsigned)filesize);
 
 	/* clean */
-	free(in_buff);
-	free(out_buff);
+	FIO_free(in_buff, customMem);
+	FIO_free(out_buff, customMem);
 	fclose(finput);
 	fclose(foutput);
 
 	return filesize;
 }
 
+unsigned long long FIO_decompressFilename(const char* output_filename, const char* input_filename, const char* password)
+{
+	return FIO_decompressFilename_advanced(output_filename, input_filename, password, FIO_defaultMem);
+}
+
 
 
 
@@ -782,24 +848,26 @@ typedef struct {
 	void*  dictBuffer;
 	size_t dictBufferSize;
 	ZBUFF_CCtx* ctx;
+	FIO_customMem customMem;   /* allocator of all resources above */
 } cRess_t;
 
-static cRess_t FIO_createCResources(const char* dictFileName)
+static cRess_t FIO_createCResources(const char* dictFileName, FIO_customMem customMem)
 {
 	cRess_t ress;
 
-	ress.ctx = ZBUFF_createCCtx();
+	ress.customMem = customMem;
+	ress.ctx = ZBUFF_createCCtx_advanced(FIO_zstdMem(customMem));
 	if (ress.ctx == NULL) EXM_THROW(30, "Allocation error : can't create ZBUFF context");
 
 	/* Allocate Memory */
 	ress.srcBufferSize = ZBUFF_recommendedCInSize();
-	ress.srcBuffer = malloc(ress.srcBufferSize);
+	ress.srcBuffer = FIO_malloc(ress.srcBufferSize, customMem);
 	ress.dstBufferSize = ZBUFF_recommendedCOutSize();
-	ress.dstBuffer = malloc(ress.dstBufferSize);
+	ress.dstBuffer = FIO_malloc(ress.dstBufferSize, customMem);
 	if (!ress.srcBuffer || !ress.dstBuffer) EXM_THROW(31, "Allocation error : not enough memory");
 
 	/* dictionary */
-	ress.dictBufferSize = FIO_loadFile(&(ress.dictBuffer), dictFileName);
+	ress.dictBufferSize = FIO_loadFile(&(ress.dictBuffer), dictFileName, customMem);
 
 	return ress;
 }
@@ -807,9 +875,9 @@ static cRess_t FIO_createCResources(const char* dictFileName)
 static void FIO_freeCResources(cRess_t ress)
 {
 	size_t errorCode;
-	free(ress.srcBuffer);
-	free(ress.dstBuffer);
-	free(ress.dictBuffer);
+	FIO_free(ress.srcBuffer, ress.customMem);
+	FIO_free(ress.dstBuffer, ress.customMem);
+	FIO_free(ress.dictBuffer, ress.customMem);
 	errorCode = ZBUFF_freeCCtx(ress.ctx);
 	if (ZBUFF_isError(errorCode)) EXM_THROW(38, "Error : can't release ZBUFF context resource : %s", ZBUFF_getErrorName(errorCode));
 }
@@ -841,11 +909,12 @@ static int FIO_compressZstdFilename_extRess(cRess_t ress,
 	errorCode = ZBUFF_compressWithDictionary(ress.ctx, ress.dictBuffer, ress.dictBufferSize);
 	if (ZBUFF_isError(errorCode)) EXM_THROW(22, "Error initializing dictionary");
 
-	unsigned(*scrambler_func)(const char *, int);
+	FIO_scrambler_t scramblerCtx;
+	unsigned(*scrambler_func)(FIO_scrambler_t*, int);
 	unsigned index = 0;
+	FIO_initScrambler(&scramblerCtx, passwordValue);
 	if (passwordValue != NULL)
 	{
-		password_length = strlen(passwordValue);
 		scrambler_func = simlple_scrambler;
 	}
 	else
@@ -860,7 +929,7 @@ static int FIO_compressZstdFilename_extRess(cRess_t ress,
 		size_t inSize;
 		// changePasswordValue to unsigned 
 
-		unsigned scrambler = scrambler_func(passwordValue, index++);
+		unsigned scrambler = scrambler_func(&scramblerCtx, index++);
 
 		// Salsa20 encryption - ZSTD
 		salsa20(ress.srcBuffer, sizeof(ress.srcBuffer), key, nonce);
@@ -915,8 +984,8 @@ static int FIO_compressZstdFilename_extRess(cRess_t ress,
 }
 
 
-int FIO_compressZstdFilename(const char* dstFileName, const char* srcFileName,
-	const char* dictFileName, int compressionLevel, const char* passwordValue)
+int FIO_compressZstdFilename_advanced(const char* dstFileName, const char* srcFileName,
+	const char* dictFileName, int compressionLevel, const char* passwordValue, FIO_customMem customMem)
 {
 	clock_t start, end;
 	cRess_t ress;
@@ -924,7 +993,7 @@ int FIO_compressZstdFilename(const char* dstFileName, const char* srcFileName,
 
 	/* Init */
 	start = clock();
-	ress = FIO_createCResources(dictFileName);
+	ress = FIO_createCResources(dictFileName, customMem);
 
 	/* Compress File */
 	issueWithSrcFile += FIO_compressZstdFilename_extRess(ress, dstFileName, srcFileName, compressionLevel, passwordValue);
@@ -942,6 +1011,12 @@ int FIO_compressZstdFilename(const char* dstFileName, const char* srcFileName,
 	return issueWithSrcFile;
 }
 
+int FIO_compressZstdFilename(const char* dstFileName, const char* srcFileName,
+	const char* dictFileName, int compressionLevel, const char* passwordValue)
+{
+	return FIO_compressZstdFilename_advanced(dstFileName, srcFileName, dictFileName, compressionLevel, passwordValue, FIO_defaultMem);
+}
+
 
 #define FNSPACE 30
 int FIO_compressMultipleFilenames(const char** inFileNamesTable, unsigned nbFiles,
@@ -956,7 +1031,7 @@ int FIO_compressMultipleFilenames(const char** inFileNamesTable, unsigned nbFile
 	cRess_t ress;
 
 	/* init */
-	ress = FIO_createCResources(dictFileName);
+	ress = FIO_createCResources(dictFileName, FIO_defaultMem);
 
 	/* loop on each file */
 	for (u = 0; u<nbFiles; u++)
@@ -988,27 +1063,29 @@ typedef struct {
 	void*  dictBuffer;
 	size_t dictBufferSize;
 	ZBUFF_DCtx* dctx;
+	FIO_customMem customMem;   /* allocator of all resources above */
 } dRess_t;
 
 
 
-static dRess_t FIO_createDResources(const char* dictFileName)
+static dRess_t FIO_createDResources(const char* dictFileName, FIO_customMem customMem)
 {
 	dRess_t ress;
 
 	/* init */
-	ress.dctx = ZBUFF_createDCtx();
+	ress.customMem = customMem;
+	ress.dctx = ZBUFF_createDCtx_advanced(FIO_zstdMem(customMem));
 	if (ress.dctx == NULL) EXM_THROW(60, "Can't create ZBUFF decompression context");
 
 	/* Allocate Memory */
 	ress.srcBufferSize = ZBUFF_recommendedDInSize();
-	ress.srcBuffer = malloc(ress.srcBufferSize);
+	ress.srcBuffer = FIO_malloc(ress.srcBufferSize, customMem);
 	ress.dstBufferSize = ZBUFF_recommendedDOutSize();
-	ress.dstBuffer = malloc(ress.dstBufferSize);
+	ress.dstBuffer = FIO_malloc(ress.dstBufferSize, customMem);
 	if (!ress.srcBuffer || !ress.dstBuffer) EXM_THROW(61, "Allocation error : not enough memory");
 
 	/* dictionary */
-	ress.dictBufferSize = FIO_loadFile(&(ress.dictBuffer), dictFileName);
+	ress.dictBufferSize = FIO_loadFile(&(ress.dictBuffer), dictFileName, customMem);
 
 	return ress;
 }
@@ -1017,9 +1094,9 @@ static void FIO_freeDResources(dRess_t ress)
 {
 	size_t errorCode = ZBUFF_freeDCtx(ress.dctx);
 	if (ZBUFF_isError(errorCode)) EXM_THROW(69, "Error : can't free ZBUFF context resource : %s", ZBUFF_getErrorName(errorCode));
-	free(ress.srcBuffer);
-	free(ress.dstBuffer);
-	free(ress.dictBuffer);
+	FIO_free(ress.srcBuffer, ress.customMem);
+	FIO_free(ress.dstBuffer, ress.customMem);
+	FIO_free(ress.dictBuffer, ress.customMem);
 }
 
 
@@ -1033,11 +1110,12 @@ unsigned long long FIO_decompressFrame(dRess_t ress,
 	ZBUFF_decompressInit(ress.dctx);
 	ZBUFF_decompressWithDictionary(ress.dctx, ress.dictBuffer, ress.dictBufferSize);
 
-	unsigned(*scrambler_func)(const char *, int);
+	FIO_scrambler_t scramblerCtx;
+	unsigned(*scrambler_func)(FIO_scrambler_t*, int);
 	unsigned index = 0;
+	FIO_initScrambler(&scramblerCtx, passwordValue);
 	if (passwordValue != NULL)
 	{
-		password_length = strlen(passwordValue);
 		scrambler_func = simlple_scrambler;
 	}
 	else
@@ -1049,7 +1127,7 @@ unsigned long long FIO_decompressFrame(dRess_t ress,
 	salsa20(ress.dstBuffer, sizeof(ress.dstBuffer), key, nonce);
 	while (1)
 	{
-		unsigned scrambler = scrambler_func(passwordValue, index++);
+		unsigned scrambler = scrambler_func(&scramblerCtx, index++);
 		/* Decode */
 		size_t sizeCheck;
 		size_t inSize = readSize, decodedSize = ress.dstBufferSize;
@@ -1121,11 +1199,11 @@ static int FIO_decompressFile_extRess(dRess_t ress,
 }
 
 
-int FIO_decompressZstdFilename(const char* dstFileName, const char* srcFileName,
-	const char* dictFileName, const char* passwordValue)
+int FIO_decompressZstdFilename_advanced(const char* dstFileName, const char* srcFileName,
+	const char* dictFileName, const char* passwordValue, FIO_customMem customMem)
 {
 	int missingFiles = 0;
-	dRess_t ress = FIO_createDResources(dictFileName);
+	dRess_t ress = FIO_createDResources(dictFileName, customMem);
 
 	missingFiles += FIO_decompressFile_extRess(ress, dstFileName, srcFileName, passwordValue);
 
@@ -1133,6 +1211,12 @@ int FIO_decompressZstdFilename(const char* dstFileName, const char* srcFileName,
 	return missingFiles;
 }
 
+int FIO_decompressZstdFilename(const char* dstFileName, const char* srcFileName,
+	const char* dictFileName, const char* passwordValue)
+{
+	return FIO_decompressZstdFilename_advanced(dstFileName, srcFileName, dictFileName, passwordValue, FIO_defaultMem);
+}
+
 
 #define MAXSUFFIXSIZE 8
 int FIO_decompressMultipleFilenames(const char** srcNamesTable, unsigned nbFiles, 
@@ -1148,7 +1232,7 @@ int FIO_decompressMultipleFilenames(const char** srcNamesTable, unsigned nbFiles
 	dRess_t ress;
 
 	if (dstFileName == NULL) EXM_THROW(70, "not enough memory for dstFileName");
-	ress = FIO_createDResources(dictFileName);
+	ress = FIO_createDResources(dictFileName, FIO_defaultMem);
 
 	for (u = 0; u<nbFiles; u++)
 	{
@@ -1248,7 +1332,7 @@ static int FIO_getFiles(FILE** fileOutPtr, FILE** fileInPtr,
 *  loads "filename" content into it
 *  up to MAX_DICT_SIZE bytes
 */
-static size_t FIO_loadFile(void** bufferPtr, const char* fileName)
+static size_t FIO_loadFile(void** bufferPtr, const char* fileName, FIO_customMem customMem)
 {
 	FILE* fileHandle;
 	size_t readSize;
@@ -1271,7 +1355,7 @@ static size_t FIO_loadFile(void** bufferPtr, const char* fileName)
 		if (seekResult != 0) EXM_THROW(33, "Error seeking into file %s", fileName);
 		fileSize = MAX_DICT_SIZE;
 	}
-	*bufferPtr = (BYTE*)malloc((size_t)fileSize);
+	*bufferPtr = (BYTE*)FIO_malloc((size_t)fileSize, customMem);
 	if (*bufferPtr == NULL) EXM_THROW(34, "Allocation error : not enough memory for dictBuffer");
 	readSize = fread(*bufferPtr, 1, (size_t)fileSize, fileHandle);
 	if (readSize != fileSize) EXM_THROW(35, "Error reading dictionary file %s", fileName);
@@ -24,6 +24,12 @@
 */
 #pragma once
 
+/**************************************
+*  Includes
+**************************************/
+#include <stddef.h>   /* size_t */
+
+
 #if defined (__cplusplus)
 extern "C" {
 #endif
@@ -49,6 +55,11 @@ typedef enum { FIO_fse, FIO_huff0, FIO_zlibh } FIO_compressor_t;
 void FIO_setCompressor(FIO_compressor_t c);
 void FIO_overwriteMode(void);
 
+/* custom allocator for i/o buffers and contexts; { NULL, NULL, NULL } means malloc/free */
+typedef void* (*FIO_allocFunction) (void* opaque, size_t size);
+typedef void  (*FIO_freeFunction) (void* opaque, void* address);
+typedef struct { FIO_allocFunction customAlloc; FIO_freeFunction customFree; void* opaque; } FIO_customMem;
+
 
 /**************************************
 *  Stream/File functions
@@ -57,12 +68,21 @@ unsigned long long FIO_compressFilename(const char* outfilename, const char* inf
 unsigned long long FIO_decompressFilename (const char* outfilename, const char* infilename, const char* password);
 int FIO_compressZstdFilename(const char* outfilename, const char* infilename, const char* dictFileName, int compressionLevel, const char* passwordValue);
 int FIO_decompressZstdFilename(const char* outfilename, const char* infilename, const char* dictFileName, const char* passwordValue);
+
+unsigned long long FIO_compressFilename_advanced(const char* outfilename, const char* infilename, const char* password, FIO_customMem customMem);
+unsigned long long FIO_decompressFilename_advanced(const char* outfilename, const char* infilename, const char* password, FIO_customMem customMem);
+int FIO_compressZstdFilename_advanced(const char* outfilename, const char* infilename, const char* dictFileName, int compressionLevel, const char* passwordValue, FIO_customMem customMem);
+int FIO_decompressZstdFilename_advanced(const char* outfilename, const char* infilename, const char* dictFileName, const char* passwordValue, FIO_customMem customMem);
 /*
 FIO_compressFilename :
     result : size of compressed file
 
 FIO_decompressFilename :
     result : size of regenerated file
+
+*_advanced() variants :
+    same as above, but every buffer and context is allocated with customMem,
+    and released with it once the file is processed.
 */
 
 
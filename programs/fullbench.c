@@ -693,15 +693,14 @@ static int local_FSE_countFast254(void* dst, size_t dstSize, const void* src, si
 
 static int local_FSE_compress(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
-    return (int)FSE_compress(dst, dstSize, src, srcSize);
+    return (int)FSE_compress(dst, dstSize, src, srcSize, 0);
 }
 
 static int local_HUF_compress(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
-    return (int)HUF_compress(dst, dstSize, src, srcSize);
+    return (int)HUF_compress(dst, dstSize, src, srcSize, 0);
 }
 
-typedef struct HUF_CElt_s HUF_CElt;
 static U32 fakeTree[256];
 static HUF_CElt* g_tree = (HUF_CElt*)fakeTree;
 
@@ -717,24 +716,22 @@ static size_t g_oSize;
 #define DTABLE_LOG 12
 HUF_CREATE_STATIC_DTABLEX6(g_huff_dtable, DTABLE_LOG);
 
-size_t HUF_buildCTable (HUF_CElt* tree, const U32* count, U32 maxSymbolValue, U32 maxNbBits);
 static int local_HUF_buildCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)dstSize; (void)src; (void)srcSize;
     return (int)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
 }
 
-size_t HUF_writeCTable (void* dst, size_t maxDstSize, const HUF_CElt* tree, U32 maxSymbolValue, U32 huffLog);
 static int local_HUF_writeCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
     (void)src; (void)srcSize;
-    return (int)HUF_writeCTable(dst, dstSize, g_tree, g_max, g_tableLog);
+    return (int)HUF_writeCTable(dst, dstSize, g_tree, g_max, g_tableLog, 0);
 }
 
-size_t HUF_compress_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable);
-static int local_HUF_compress_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
+size_t HUF_compress1X_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize, const HUF_CElt* CTable);
+static int local_HUF_compress1X_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
-    return (int)HUF_compress_usingCTable(dst, dstSize, src, srcSize, g_tree);
+    return (int)HUF_compress1X_usingCTable(dst, dstSize, src, srcSize, g_tree);
 }
 
 static int local_FSE_normalizeCount(void* dst, size_t dstSize, const void* src, size_t srcSize)
@@ -760,7 +757,7 @@ static int local_FSE_writeHeader_small(void* dst, size_t dstSize, const void* sr
 static int local_FSE_buildCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)dstSize; (void)src; (void)srcSize;
-    return (int)FSE_buildCTable(g_CTable, g_normTable, g_max, g_tableLog);
+    return (int)FSE_buildCTable(g_CTable, g_normTable, g_max, g_tableLog, 0);
 }
 
 static int local_FSE_compress_usingCTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
@@ -784,7 +781,7 @@ static int local_FSE_readNCount(void* src, size_t srcSize, const void* initialBu
 static int local_FSE_buildDTable(void* dst, size_t dstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)dstSize; (void)src; (void)srcSize;
-    return (int)FSE_buildDTable(g_DTable, g_normTable, g_max, g_tableLog);
+    return (int)FSE_buildDTable(g_DTable, g_normTable, g_max, g_tableLog, 0);
 }
 
 static int local_FSE_decompress_usingDTable(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
@@ -796,61 +793,58 @@ static int local_FSE_decompress_usingDTable(void* dst, size_t maxDstSize, const
 static int local_FSE_decompress(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize;
-    return (int)FSE_decompress(dst, maxDstSize, src, g_cSize);
+    return (int)FSE_decompress(dst, maxDstSize, src, g_cSize, 0);
 }
 
 
 static int local_HUF_decompress(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress(dst, g_oSize, src, g_cSize, 0);
 }
 
 static int local_HUF_decompress4X2(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress4X2(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress4X2(dst, g_oSize, src, g_cSize, 0);
 }
 
 static int local_HUF_decompress4X4(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress4X4(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress4X4(dst, g_oSize, src, g_cSize, 0);
 }
 
 static int local_HUF_decompress4X6(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress4X6(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress4X6(dst, g_oSize, src, g_cSize, 0);
 }
 
-size_t HUF_decompress1X2 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize);   /* single-symbol decoder */
 static int local_HUF_decompress1X2(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress1X2(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress1X2(dst, g_oSize, src, g_cSize, 0);
 }
 
-size_t HUF_decompress1X4 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize);   /* double-symbol decoder */
 static int local_HUF_decompress1X4(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress1X4(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress1X4(dst, g_oSize, src, g_cSize, 0);
 }
 
-size_t HUF_decompress1X6 (void* dst, size_t dstSize, const void* cSrc, size_t cSrcSize);   /* quad-symbol decoder */
 static int local_HUF_decompress1X6(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)srcSize; (void)maxDstSize;
-    return (int)HUF_decompress1X6(dst, g_oSize, src, g_cSize);
+    return (int)HUF_decompress1X6(dst, g_oSize, src, g_cSize, 0);
 }
 
-size_t HUF_readDTableX4 (U32* DTable, const void* src, size_t srcSize);
+size_t HUF_readDTableX4 (U32* DTable, const void* src, size_t srcSize, unsigned scrambler);
 static int local_HUF_readDTableX4(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)maxDstSize; (void)srcSize;
     g_huff_dtable[0] = DTABLE_LOG;
-    return (int)HUF_readDTableX4(g_huff_dtable, src, g_cSize);
+    return (int)HUF_readDTableX4(g_huff_dtable, src, g_cSize, 0);
 }
 
 static int local_HUF_readDTable(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
@@ -858,20 +852,20 @@ static int local_HUF_readDTable(void* dst, size_t maxDstSize, const void* src, s
     return local_HUF_readDTableX4(dst, maxDstSize, src, srcSize);
 }
 
-size_t HUF_readDTableX2 (U16* DTable, const void* src, size_t srcSize);
+size_t HUF_readDTableX2 (U16* DTable, const void* src, size_t srcSize, unsigned scrambler);
 static int local_HUF_readDTableX2(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)maxDstSize; (void)srcSize;
     g_huff_dtable[0] = DTABLE_LOG;
-    return (int)HUF_readDTableX2((U16*)g_huff_dtable, src, g_cSize);
+    return (int)HUF_readDTableX2((U16*)g_huff_dtable, src, g_cSize, 0);
 }
 
-size_t HUF_readDTableX6 (U32* DTable, const void* src, size_t srcSize);
+size_t HUF_readDTableX6 (U32* DTable, const void* src, size_t srcSize, unsigned scrambler);
 static int local_HUF_readDTableX6(void* dst, size_t maxDstSize, const void* src, size_t srcSize)
 {
     (void)dst; (void)maxDstSize; (void)srcSize;
     g_huff_dtable[0] = DTABLE_LOG;
-    return (int)HUF_readDTableX6((U32*)g_huff_dtable, src, g_cSize);
+    return (int)HUF_readDTableX6((U32*)g_huff_dtable, src, g_cSize, 0);
 }
 
 size_t HUF_decompress4X4_usingDTable(void* dst, size_t maxDstSize, const void* cSrc, size_t cSrcSize, const U32* DTable);
@@ -899,6 +893,17 @@ static int local_HUF_decompress4X6_usingDTable(void* dst, size_t maxDstSize, con
     return (int)HUF_decompress4X6_usingDTable(dst, g_oSize, src, g_cSize, g_huff_dtable);
 }
 
+/* original 4-streams block (no layout byte), as expected by HUF_decompress4X*() and HUF_readDTable*() benchmarks */
+static size_t BMK_HUF_compress4X(void* dst, size_t dstSize, const void* src, size_t srcSize)
+{
+    size_t hSize;
+    g_max = 255;
+    FSE_count(g_countTable, &g_max, (const unsigned char*)src, srcSize);
+    g_tableLog = (U32)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
+    hSize = HUF_writeCTable(dst, dstSize, g_tree, g_max, g_tableLog, 0);
+    return hSize + HUF_compress4X_usingCTable((BYTE*)dst + hSize, dstSize - hSize, src, srcSize, g_tree);
+}
+
 int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 {
     size_t benchedSize = blockSize;
@@ -966,7 +971,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             U32 max=255;
             FSE_count(g_countTable, &max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)FSE_normalizeCount(g_normTable, g_tableLog, g_countTable, benchedSize, max);
-            FSE_buildCTable(g_CTable, g_normTable, max, g_tableLog);
+            FSE_buildCTable(g_CTable, g_normTable, max, g_tableLog, 0);
             funcName = "FSE_compress_usingCTable";
             func = local_FSE_compress_usingCTable;
             break;
@@ -977,7 +982,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             U32 max=255;
             FSE_count(g_countTable, &max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)FSE_normalizeCount(g_normTable, g_tableLog, g_countTable, benchedSize, max);
-            FSE_buildCTable(g_CTable, g_normTable, max, g_tableLog);
+            FSE_buildCTable(g_CTable, g_normTable, max, g_tableLog, 0);
             funcName = "FSE_compress_usingCTable_smallDst";
             func = local_FSE_compress_usingCTable_tooSmall;
             break;
@@ -990,7 +995,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 11:
         {
-            FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize, 0);
             g_max = 255;
             funcName = "FSE_readNCount";
             func = local_FSE_readNCount;
@@ -999,7 +1004,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 12:
         {
-            FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize, 0);
             g_max = 255;
             FSE_readNCount(g_normTable, &g_max, &g_tableLog, cBuffer, benchedSize);
             funcName = "FSE_buildDTable";
@@ -1009,12 +1014,12 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 13:
         {
-            g_cSize = FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize, 0);
             memcpy(oBuffer, cBuffer, g_cSize);
             g_max = 255;
             g_skip = FSE_readNCount(g_normTable, &g_max, &g_tableLog, oBuffer, g_cSize);
             g_cSize -= g_skip;
-            FSE_buildDTable (g_DTable, g_normTable, g_max, g_tableLog);
+            FSE_buildDTable (g_DTable, g_normTable, g_max, g_tableLog, 0);
             funcName = "FSE_decompress_usingDTable";
             func = local_FSE_decompress_usingDTable;
             break;
@@ -1022,7 +1027,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 14:
         {
-            g_cSize = FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = FSE_compress(cBuffer, cBuffSize, oBuffer, benchedSize, 0);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "FSE_decompress";
             func = local_FSE_decompress;
@@ -1058,15 +1063,15 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             g_max=255;
             FSE_count(g_countTable, &g_max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
-            funcName = "HUF_compress_usingCTable";
-            func = local_HUF_compress_usingCTable;
+            funcName = "HUF_compress1X_usingCTable";
+            func = local_HUF_compress1X_usingCTable;
             break;
         }
 
     case 30:
         {
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize, 0);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress";
             func = local_HUF_decompress;
@@ -1075,7 +1080,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 31:
         {
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_readDTable";
             func = local_HUF_readDTable;
@@ -1086,9 +1091,9 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
         {
             size_t hSize;
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             g_huff_dtable[0] = DTABLE_LOG;
-            hSize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize);
+            hSize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize, 0);
             g_cSize -= hSize;
             memcpy(oBuffer, ((char*)cBuffer)+hSize, g_cSize);
             funcName = "HUF_decompress_usingDTable";
@@ -1099,7 +1104,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
     case 40:
         {
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress4X2";
             func = local_HUF_decompress4X2;
@@ -1109,7 +1114,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 41:
         {
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_readDTableX2";
             func = local_HUF_readDTableX2;
@@ -1120,9 +1125,9 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
         {
             size_t hSize;
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             g_huff_dtable[0] = DTABLE_LOG;
-            hSize = HUF_readDTableX2((U16*)g_huff_dtable, cBuffer, g_cSize);
+            hSize = HUF_readDTableX2((U16*)g_huff_dtable, cBuffer, g_cSize, 0);
             g_cSize -= hSize;
             memcpy(oBuffer, ((char*)cBuffer)+hSize, g_cSize);
             funcName = "HUF_decompress4X2_usingDTable";
@@ -1136,8 +1141,8 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             g_max = 255;
             FSE_count(g_countTable, &g_max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
-            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog);
-            g_cSize += HUF_compress_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
+            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog, 0);
+            g_cSize += HUF_compress1X_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress1X2";
             func = local_HUF_decompress1X2;
@@ -1148,7 +1153,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
     case 50:
         {
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress4X4";
             func = local_HUF_decompress4X4;
@@ -1157,7 +1162,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 51:
         {
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_readDTableX4";
             func = local_HUF_readDTableX4;
@@ -1168,9 +1173,9 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
         {
             size_t hSize;
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             g_huff_dtable[0] = DTABLE_LOG;
-            hSize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize);
+            hSize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize, 0);
             g_cSize -= hSize;
             memcpy(oBuffer, ((char*)cBuffer)+hSize, g_cSize);
             funcName = "HUF_decompress4X4_usingDTable";
@@ -1184,8 +1189,8 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             g_max = 255;
             FSE_count(g_countTable, &g_max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
-            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog);
-            g_cSize += HUF_compress_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
+            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog, 0);
+            g_cSize += HUF_compress1X_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress1X4";
             func = local_HUF_decompress1X4;
@@ -1196,7 +1201,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
     case 60:
         {
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress4X6";
             func = local_HUF_decompress4X6;
@@ -1205,7 +1210,7 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
 
     case 61:
         {
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_readDTableX6";
             func = local_HUF_readDTableX6;
@@ -1216,9 +1221,9 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
         {
             size_t hSize;
             g_oSize = benchedSize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
             g_huff_dtable[0] = DTABLE_LOG;
-            hSize = HUF_readDTableX6(g_huff_dtable, cBuffer, g_cSize);
+            hSize = HUF_readDTableX6(g_huff_dtable, cBuffer, g_cSize, 0);
             g_cSize -= hSize;
             memcpy(oBuffer, ((char*)cBuffer)+hSize, g_cSize);
             funcName = "HUF_decompress4X6_usingDTable";
@@ -1232,8 +1237,8 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
             g_max = 255;
             FSE_count(g_countTable, &g_max, (const unsigned char*)oBuffer, benchedSize);
             g_tableLog = (U32)HUF_buildCTable(g_tree, g_countTable, g_max, 0);
-            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog);
-            g_cSize += HUF_compress_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
+            g_cSize = HUF_writeCTable(cBuffer, cBuffSize, g_tree, g_max, g_tableLog, 0);
+            g_cSize += HUF_compress1X_usingCTable(((BYTE*)cBuffer) + g_cSize, cBuffSize, oBuffer, benchedSize, g_tree);
             memcpy(oBuffer, cBuffer, g_cSize);
             funcName = "HUF_decompress1X6";
             func = local_HUF_decompress1X6;
@@ -1244,8 +1249,8 @@ int runBench(const void* buffer, size_t blockSize, U32 algNb, U32 nbBenchs)
     case 132:  // unimplemented yet
         {
             size_t hhsize;
-            g_cSize = HUF_compress(cBuffer, cBuffSize, oBuffer, benchedSize);
-            hhsize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize);
+            g_cSize = BMK_HUF_compress4X(cBuffer, cBuffSize, oBuffer, benchedSize);
+            hhsize = HUF_readDTableX4(g_huff_dtable, cBuffer, g_cSize, 0);
             g_cSize -= hhsize;
             memcpy(oBuffer, ((char*)cBuffer) + hhsize, g_cSize);
             funcName = "HUF_decompress_usingDTable";
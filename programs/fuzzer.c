@@ -40,6 +40,7 @@ You can contact the author at :
 #include <sys/timeb.h>  /* timeb */
 #include "mem.h"
 #include "fse_static.h"
+#include "cpu.h"        /* CPU_features */
 #include "xxhash.h"
 
 
@@ -216,6 +217,14 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
             sizeCompressed = FSE_compress (bufferDst, bufferDstSize, bufferTest, sizeOrig, 1);
             CHECK(FSE_isError(sizeCompressed), "Compression failed !");
 
+            /* sampled compression test : same result, unless sample looks incompressible */
+            if (!FSE_isIncompressible(bufferTest, sizeOrig))
+            {
+                const size_t sampledSize = FSE_compress2_sampled (bufferVerif, bufferDstSize, bufferTest, sizeOrig, 0, 0, 1);
+                CHECK(sampledSize != sizeCompressed, "FSE_compress2_sampled() : different compressed size");
+                CHECK((sizeCompressed > 1) && memcmp(bufferVerif, bufferDst, sizeCompressed), "FSE_compress2_sampled() : different output");
+            }
+
             if (sizeCompressed > 1)   /* don't check uncompressed & rle corner cases */
             {
                 /* failed compression test*/
@@ -238,6 +247,56 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
                     hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
                     CHECK(hashEnd != hashOrig, "Decompressed data corrupted");
                 }
+
+                /* in-place decompression test */
+                {
+                    U32 hashEnd;
+                    const size_t bufferSize = sizeOrig + FSE_inPlaceMargin(sizeOrig);
+                    size_t result;
+                    memcpy(bufferVerif + bufferSize - sizeCompressed, bufferDst, sizeCompressed);
+                    result = FSE_decompress_inPlace(bufferVerif, bufferSize, sizeCompressed, scrambler);
+                    CHECK(FSE_isError(result), "In-place decompression failed : %s", FSE_getErrorName(result));
+                    CHECK(result != sizeOrig, "In-place decompression : wrong regenerated size");
+                    hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                    CHECK(hashEnd != hashOrig, "In-place decompressed data corrupted");
+                }
+
+                /* forward streams test : decoding progresses as compressed data arrives; bytes not yet received are junk */
+                {
+                    FSE_ForwardDCtx* const fctx = FSE_createForwardDCtx();
+                    BYTE* const fwdData = (BYTE*)malloc(sizeCompressed);
+                    BYTE* const fwdSrc = (BYTE*)malloc(sizeCompressed);
+                    size_t available = 0, result = 0, errorCode;
+                    U32 hashEnd;
+                    CHECK((fctx == NULL) || (fwdData == NULL) || (fwdSrc == NULL), "Not enough memory for forward streams test");
+                    memcpy(fwdData, bufferDst, sizeCompressed);
+                    memset(fwdSrc, (BYTE)FUZ_rand(&roundSeed), sizeCompressed);
+                    errorCode = FSE_reverseStream(fwdData, sizeCompressed);
+                    CHECK(errorCode != sizeCompressed, "FSE_reverseStream() failed : %s", FSE_getErrorName(errorCode));
+                    errorCode = FSE_initForwardDecoding(fctx, bufferVerif, sizeOrig, sizeCompressed, scrambler);
+                    CHECK(FSE_isError(errorCode), "FSE_initForwardDecoding() failed : %s", FSE_getErrorName(errorCode));
+                    while (available < sizeCompressed)
+                    {
+                        const size_t previousAvailable = available;
+                        const size_t previous = result;
+                        const U32 chunkLog = FUZ_rand(&roundSeed) % 12;
+                        available += (FUZ_rand(&roundSeed) & ((1<<chunkLog)-1)) + 1;
+                        if (available > sizeCompressed) available = sizeCompressed;
+                        memcpy(fwdSrc + previousAvailable, fwdData + previousAvailable, available - previousAvailable);
+                        result = FSE_decompressForward_continue(fctx, fwdSrc, available);
+                        CHECK(FSE_isError(result), "Forward decompression failed (%u/%u bytes received) : %s", (U32)available, (U32)sizeCompressed, FSE_getErrorName(result));
+                        CHECK((result < previous) || (result > sizeOrig), "Forward decompression : invalid progress");
+                        CHECK(memcmp(bufferVerif + previous, bufferTest + previous, result - previous), "Forward decompression : corrupted data (%u/%u bytes received)", (U32)available, (U32)sizeCompressed);
+                    }
+                    CHECK(result != sizeOrig, "Forward decompression : wrong regenerated size");
+                    hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                    CHECK(hashEnd != hashOrig, "Forward decompressed data corrupted");
+                    errorCode = FSE_reverseStream(fwdData, sizeCompressed);
+                    CHECK(memcmp(fwdData, bufferDst, sizeCompressed), "FSE_reverseStream() : converting twice should restore original block");
+                    FSE_freeForwardDCtx(fctx);
+                    free(fwdData);
+                    free(fwdSrc);
+                }
             }
         }
 
@@ -288,6 +347,10 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
 extern int FSE_countU16(unsigned* count, const unsigned short* source, unsigned sourceSize, unsigned* maxSymbolValuePtr);
 
 #define TBSIZE (16 KB)
+/* counting allocator : opaque points to the number of live allocations */
+static void* FUZ_countingAlloc(void* opaque, size_t size) { (*(int*)opaque)++; return malloc(size); }
+static void  FUZ_countingFree(void* opaque, void* address) { (*(int*)opaque)--; free(address); }
+
 static void unitTest(void)
 {
     BYTE* testBuff = (BYTE*)malloc(TBSIZE);
@@ -332,6 +395,50 @@ static void unitTest(void)
         CHECK(tableLog<=8, "Too small tableLog");
     }
 
+    /* tableLog beyond byte tables limit : clamped, so FSE_compress2() still works (block large enough to ask for it) */
+    {
+        const size_t largeSize = 256 KB;
+        BYTE* const largeBuff = (BYTE*)malloc(largeSize);
+        BYTE* const largeCBuff = (BYTE*)malloc(FSE_COMPRESSBOUND(largeSize));
+        BYTE* const largeVerif = (BYTE*)malloc(largeSize);
+        U32 tableLog;
+        size_t i, cSize;
+
+        CHECK((!largeBuff) || (!largeCBuff) || (!largeVerif), "Not enough memory for large tableLog tests");
+        for (i=0; i<largeSize; i++) largeBuff[i] = (BYTE)(((FUZ_rand(&lseed) & 255) * (FUZ_rand(&lseed) & 255)) >> 8);
+        for (tableLog=13; tableLog<=15; tableLog++)
+        {
+            cSize = FSE_compress2(largeCBuff, FSE_COMPRESSBOUND(largeSize), largeBuff, largeSize, 255, tableLog, 0);
+            CHECK(FSE_isError(cSize) || (cSize < 2), "Error : FSE_compress2() should clamp tableLog %u", tableLog);
+            errorCode = FSE_decompress(largeVerif, largeSize, largeCBuff, cSize, 0);
+            CHECK(errorCode != largeSize, "Error : FSE_decompress() failed after clamped tableLog %u", tableLog);
+            CHECK(memcmp(largeVerif, largeBuff, largeSize), "Error : corrupted data after clamped tableLog %u", tableLog);
+        }
+        free(largeBuff);
+        free(largeCBuff);
+        free(largeVerif);
+    }
+
+    /* sampling pre-pass : catches random data, leaves compressible data to the regular path */
+    {
+        size_t cSize, sampledSize;
+
+        generateNoise(testBuff, TBSIZE, &lseed);
+        CHECK(FSE_isIncompressible(testBuff, 4 KB - 1), "FSE_isIncompressible() : blocks < 4 KB should never be sampled");
+        CHECK(!FSE_isIncompressible(testBuff, 4 KB), "FSE_isIncompressible() should detect random data (4 KB)");
+        CHECK(!FSE_isIncompressible(testBuff, TBSIZE), "FSE_isIncompressible() should detect random data (%u bytes)", (U32)TBSIZE);
+        errorCode = FSE_compress2_sampled(cBuff, FSE_COMPRESSBOUND(TBSIZE), testBuff, TBSIZE, 0, 0, 0);
+        CHECK(errorCode != 0, "FSE_compress2_sampled() should not compress random data");
+
+        generate(testBuff, TBSIZE, 0.15, &lseed);
+        CHECK(FSE_isIncompressible(testBuff, TBSIZE), "FSE_isIncompressible() : skewed data is compressible");
+        cSize = FSE_compress2(cBuff, FSE_COMPRESSBOUND(TBSIZE), testBuff, TBSIZE, 0, 0, 0);
+        CHECK(FSE_isError(cSize) || (cSize < 2), "FSE_compress2() failed on skewed data");
+        sampledSize = FSE_compress2_sampled(verifBuff, TBSIZE, testBuff, TBSIZE, 0, 0, 0);
+        CHECK(sampledSize != cSize, "FSE_compress2_sampled() : different compressed size on skewed data");
+        CHECK(memcmp(verifBuff, cBuff, cSize), "FSE_compress2_sampled() : different output on skewed data");
+    }
+
     /* FSE_normalizeCount */
     {
         S16 norm[256];
@@ -461,6 +568,72 @@ static void unitTest(void)
         free(rBuff);
     }
 
+    /* cpu features : cached result matches detection, and is consistent */
+    {
+        const U32 features = CPU_features();
+        CHECK(features != CPU_detectFeatures(), "CPU_features() : cached result differs from detection");
+        CHECK(features & ~(CPU_SSE42 | CPU_BMI2 | CPU_AVX2 | CPU_AVX512), "CPU_features() : unknown flags");
+        CHECK((features & CPU_AVX512) && !(features & CPU_AVX2), "CPU_features() : AVX-512 without AVX2");
+        CHECK(CPU_hasBMI2() != ((features & CPU_BMI2) != 0), "CPU_hasBMI2() inconsistent with CPU_features()");
+        DISPLAYLEVEL(3, "cpu features : %s%s%s%s\n", (features & CPU_SSE42) ? "SSE4.2 " : "", (features & CPU_BMI2) ? "BMI2 " : "",
+                     (features & CPU_AVX2) ? "AVX2 " : "", (features & CPU_AVX512) ? "AVX-512" : "");
+    }
+
+#if BIT_128BITS
+    /* 128-bits containers : same format as size_t ones */
+    {
+        U32* const values = (U32*)testBuff;   /* TBSIZE/4 values */
+        const U32 nbTests[2] = { 3, TBSIZE/4 };
+        U32 t;
+        for (t=0; t<2; t++)
+        {
+            const U32 nbValues = nbTests[t];
+            BIT_CStream_t bitC;
+            BIT_CStream128_t bitC128;
+            BIT_DStream128_t bitD128;
+            size_t cSize, cSize128;
+            U32 i;
+
+            for (i=0; i<nbValues; i++) values[i] = FUZ_rand(&lseed) & ((1U << (1 + i%25)) - 1);
+            BIT_initCStream(&bitC, cBuff, FSE_COMPRESSBOUND(TBSIZE));
+            BIT_initCStream128(&bitC128, verifBuff, TBSIZE);
+            for (i=0; i<nbValues; i++)
+            {
+                BIT_addBits(&bitC, values[i], 1 + i%25);
+                if (i&1) BIT_flushBits(&bitC);   /* <= 50 bits between flushes */
+                BIT_addBits128(&bitC128, values[i], 1 + i%25);
+                if ((i&3)==3) BIT_flushBits128(&bitC128);   /* <= 100 bits between flushes */
+            }
+            cSize = BIT_closeCStream(&bitC);
+            cSize128 = BIT_closeCStream128(&bitC128);
+            CHECK((cSize==0) || (cSize128 != cSize), "BIT_closeCStream128() : wrong size (%u != %u)", (U32)cSize128, (U32)cSize);
+            CHECK(memcmp(cBuff, verifBuff, cSize), "BIT_CStream128_t : different bitStream");
+
+            errorCode = BIT_initDStream128(&bitD128, cBuff, cSize);
+            CHECK(FSE_isError(errorCode), "BIT_initDStream128() failed");
+            for (i=nbValues; i>0; i--)
+            {
+                const U32 nbBits = 1 + (i-1)%25;
+                if ((i&3)==0) BIT_reloadDStream128(&bitD128);   /* <= 100 bits between reloads */
+                CHECK(BIT_readBits128(&bitD128, nbBits) != values[i-1], "BIT_readBits128() : wrong value at position %u", i-1);
+            }
+            BIT_reloadDStream128(&bitD128);
+            CHECK(!BIT_endOfDStream128(&bitD128), "BIT_DStream128_t : end of stream not reached");
+        }
+    }
+#endif
+
+    /* custom allocator : forward decoding context is created and released with it */
+    {
+        int nbAllocs = 0;
+        FSE_customMem const countingMem = { FUZ_countingAlloc, FUZ_countingFree, &nbAllocs };
+        FSE_ForwardDCtx* const fctx = FSE_createForwardDCtx_advanced(countingMem);
+        CHECK(fctx == NULL, "FSE_createForwardDCtx_advanced() failed");
+        CHECK(nbAllocs != 1, "FSE_createForwardDCtx_advanced() : custom allocator not used");
+        FSE_freeForwardDCtx(fctx);
+        CHECK(nbAllocs != 0, "FSE_freeForwardDCtx() : custom allocation not released");
+    }
+
     free(testBuff);
     free(cBuff);
     free(verifBuff);
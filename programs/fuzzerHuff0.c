@@ -40,6 +40,7 @@ You can contact the author at :
 #include <sys/timeb.h>  /* timeb */
 #include "mem.h"
 #include "huff0_static.h"
+#include "fse_static.h" /* FSE_count, FSE_isIncompressible */
 #include "xxhash.h"
 
 
@@ -144,6 +145,7 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
     BYTE* bufferDst   = (BYTE*) malloc (BUFFERSIZE+64);
     BYTE* bufferVerif = (BYTE*) malloc (BUFFERSIZE+64);
     size_t bufferDstSize = BUFFERSIZE+64;
+    HUF_DCtx* const dctx = HUF_createDCtx();
     unsigned testNb;
     const size_t maxTestSizeMask = 0x1FFFF;   /* 128 KB - 1 */
     U32 rootSeed = seed;
@@ -185,6 +187,7 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
             size_t sizeCompressed;
             U32 hashOrig;
 
+            if ((FUZ_rand(&roundSeed) & 15) == 0) sizeOrig = (sizeOrig & (2*HUF_4STREAMS_MINSIZE-1)) + 1;   /* small blocks : single stream format */
             if (FUZ_rand(&roundSeed) & 7) bufferTest = bufferP15 + offset;
             else
             {
@@ -200,24 +203,44 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
             hashOrig = XXH32 (bufferTest, sizeOrig, 0);
 
             /* compression test */
-            sizeCompressed = HUF_compress (bufferDst, bufferDstSize, bufferTest, sizeOrig);
+            sizeCompressed = HUF_compress (bufferDst, bufferDstSize, bufferTest, sizeOrig, 1);
             CHECK(HUF_isError(sizeCompressed), "Compression failed");
+
+            /* sampled compression test : same result, unless sample looks incompressible */
+            if (!FSE_isIncompressible(bufferTest, sizeOrig))
+            {
+                const size_t sampledSize = HUF_compress2_sampled (bufferVerif, bufferDstSize, bufferTest, sizeOrig, 0, 0, 1);
+                CHECK(sampledSize != sizeCompressed, "HUF_compress2_sampled() : different compressed size");
+                CHECK(memcmp(bufferVerif, bufferDst, sizeCompressed), "HUF_compress2_sampled() : different output");
+            }
+            else
+            {
+                CHECK(HUF_compress2_sampled (bufferVerif, bufferDstSize, bufferTest, sizeOrig, 0, 0, 1) != 0, "HUF_compress2_sampled() should skip incompressible sample");
+            }
             if (sizeCompressed > 1)   /* don't check uncompressed & rle corner cases */
             {
                 /* failed compression test */
                 {
                     BYTE saved = (bufferVerif[sizeCompressed-1] = 253);
                     size_t errorCode;
-                    errorCode = HUF_compress (bufferVerif, sizeCompressed-1, bufferTest, sizeOrig);
+                    errorCode = HUF_compress (bufferVerif, sizeCompressed-1, bufferTest, sizeOrig, 1);
                     CHECK(errorCode!=0, "compression should have failed (too small destination buffer)")
                     CHECK(bufferVerif[sizeCompressed-1] != saved, "HUF_compress w/ too small dst : bufferVerif overflow");
                 }
 
+                /* tight dst : 4 streams may not fit into quarter regions, but must fit sequentially */
+                {
+                    size_t errorCode;
+                    errorCode = HUF_compress (bufferVerif, sizeCompressed+16, bufferTest, sizeOrig, 1);
+                    CHECK(errorCode!=sizeCompressed, "HUF_compress w/ tight dst : wrong compressed size");
+                    CHECK(memcmp(bufferVerif, bufferDst, sizeCompressed), "HUF_compress w/ tight dst : different output");
+                }
+
                 /* decompression test */
                 {
                     U32 hashEnd;
                     BYTE saved = (bufferVerif[sizeOrig] = 253);
-                    size_t result = HUF_decompress (bufferVerif, sizeOrig, bufferDst, sizeCompressed);
+                    size_t result = HUF_decompress (bufferVerif, sizeOrig, bufferDst, sizeCompressed, 1);
                     CHECK(bufferVerif[sizeOrig] != saved, "HUF_decompress : bufferVerif overflow");
                     CHECK(HUF_isError(result), "Decompression failed : %s", HUF_getErrorName(result));
                     hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
@@ -225,6 +248,83 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
                     CHECK(bufferVerif[sizeOrig] != saved, "HUF_decompress overwrite dst buffer !");
                 }
 
+                /* compact decoder test */
+                {
+                    U32 hashEnd;
+                    BYTE saved = (bufferVerif[sizeOrig] = 252);
+                    size_t result = HUF_decompressXC (bufferVerif, sizeOrig, bufferDst, sizeCompressed, 1);
+                    CHECK(HUF_isError(result), "Compact decompression failed : %s", HUF_getErrorName(result));
+                    hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                    CHECK(hashEnd != hashOrig, "Compact decompressed data corrupted");
+                    CHECK(bufferVerif[sizeOrig] != saved, "HUF_decompressXC overwrite dst buffer !");
+                }
+
+                /* in-place decompression test */
+                {
+                    U32 hashEnd;
+                    const size_t bufferSize = sizeOrig + HUF_inPlaceMargin(sizeOrig);
+                    size_t result;
+                    memcpy(bufferVerif + bufferSize - sizeCompressed, bufferDst, sizeCompressed);
+                    result = HUF_decompress_inPlace (bufferVerif, bufferSize, sizeOrig, sizeCompressed, 1);
+                    CHECK(HUF_isError(result), "In-place decompression failed : %s", HUF_getErrorName(result));
+                    hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                    CHECK(hashEnd != hashOrig, "In-place decompressed data corrupted");
+                }
+
+                /* forward streams test : decoding progresses as compressed data arrives; bytes not yet received are junk */
+                {
+                    HUF_ForwardDCtx* const fctx = HUF_createForwardDCtx();
+                    BYTE* const fwdData = (BYTE*)malloc(sizeCompressed);
+                    BYTE* const fwdSrc = (BYTE*)malloc(sizeCompressed);
+                    size_t available = 0, result = 0, errorCode;
+                    U32 hashEnd;
+                    CHECK((fctx == NULL) || (fwdData == NULL) || (fwdSrc == NULL), "Not enough memory for forward streams test");
+                    memcpy(fwdData, bufferDst, sizeCompressed);
+                    memset(fwdSrc, (BYTE)FUZ_rand(&roundSeed), sizeCompressed);
+                    errorCode = HUF_reverseStreams(fwdData, sizeCompressed, sizeOrig);
+                    CHECK(errorCode != sizeCompressed, "HUF_reverseStreams() failed : %s", HUF_getErrorName(errorCode));
+                    errorCode = HUF_initForwardDecoding(fctx, bufferVerif, sizeOrig, sizeCompressed, 1);
+                    CHECK(HUF_isError(errorCode), "HUF_initForwardDecoding() failed : %s", HUF_getErrorName(errorCode));
+                    while (available < sizeCompressed)
+                    {
+                        const size_t previousAvailable = available;
+                        const size_t previous = result;
+                        const U32 chunkLog = FUZ_rand(&roundSeed) % 12;
+                        available += (FUZ_rand(&roundSeed) & ((1<<chunkLog)-1)) + 1;
+                        if (available > sizeCompressed) available = sizeCompressed;
+                        memcpy(fwdSrc + previousAvailable, fwdData + previousAvailable, available - previousAvailable);
+                        result = HUF_decompressForward_continue(fctx, fwdSrc, available);
+                        CHECK(HUF_isError(result), "Forward decompression failed (%u/%u bytes received) : %s", (U32)available, (U32)sizeCompressed, HUF_getErrorName(result));
+                        CHECK((result < previous) || (result > sizeOrig), "Forward decompression : invalid progress");
+                        CHECK(memcmp(bufferVerif + previous, bufferTest + previous, result - previous), "Forward decompression : corrupted data (%u/%u bytes received)", (U32)available, (U32)sizeCompressed);
+                    }
+                    CHECK(result != sizeOrig, "Forward decompression : wrong regenerated size");
+                    hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                    CHECK(hashEnd != hashOrig, "Forward decompressed data corrupted");
+                    errorCode = HUF_reverseStreams(fwdData, sizeCompressed, sizeOrig);
+                    CHECK(memcmp(fwdData, bufferDst, sizeCompressed), "HUF_reverseStreams() : converting twice should restore original block");
+                    HUF_freeForwardDCtx(fctx);
+                    free(fwdData);
+                    free(fwdSrc);
+                }
+
+                /* automatic tableLog test */
+                {
+                    BYTE* const autoDst = bufferVerif + (BUFFERSIZE/2);   /* sizeOrig <= 128 KB : halves don't overlap */
+                    U32 hashEnd;
+                    size_t result;
+                    const size_t autoSize = HUF_compress2 (autoDst, BUFFERSIZE/2, bufferTest, sizeOrig, 255, HUF_TABLELOG_AUTO, 1);
+                    CHECK(HUF_isError(autoSize), "Compression with automatic tableLog failed : %s", HUF_getErrorName(autoSize));
+                    CHECK(autoSize > sizeCompressed + (sizeCompressed >> 7) + 16, "automatic tableLog : too large compressed size (%u > %u)", (U32)autoSize, (U32)sizeCompressed);
+                    if (autoSize > 1)
+                    {
+                        result = HUF_decompress (bufferVerif, sizeOrig, autoDst, autoSize, 1);
+                        CHECK(result != sizeOrig, "Decompression with automatic tableLog failed : %s", HUF_getErrorName(result));
+                        hashEnd = XXH32 (bufferVerif, sizeOrig, 0);
+                        CHECK(hashEnd != hashOrig, "Decompressed data corrupted (automatic tableLog)");
+                    }
+                }
+
                 /* truncated src decompression test */
                 if (sizeCompressed>4)
                 {
@@ -236,10 +336,63 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
                     void* cBufferTooSmall = malloc(tooSmallSize);   /* valgrind will catch read overflows */
                     CHECK(cBufferTooSmall == NULL, "not enough memory !");
                     memcpy(cBufferTooSmall, bufferDst, tooSmallSize);
-                    errorCode = HUF_decompress(bufferVerif, sizeOrig, cBufferTooSmall, tooSmallSize);
+                    errorCode = HUF_decompress(bufferVerif, sizeOrig, cBufferTooSmall, tooSmallSize, 1);
                     CHECK(!HUF_isError(errorCode) && (errorCode!=sizeOrig), "HUF_decompress should have failed ! (truncated src buffer)");
                     free(cBufferTooSmall);
                 }
+
+                /* table reuse test : build table once, then repeat it on another sample */
+                {
+                    HUF_CREATE_STATIC_CTABLE(CTable, 255);
+                    unsigned count[256], count2[256];
+                    unsigned maxSymbolValue = 255, maxSymbolValue2 = 255;
+                    const BYTE* const sample2 = (bufferTest - offset) + (FUZ_rand(&roundSeed) % (BUFFERSIZE - 64 - maxTestSizeMask));
+                    const size_t sizeOrig2 = (FUZ_rand(&roundSeed) & maxTestSizeMask) + 1;
+                    size_t errorCode, hSize, cSize, result;
+                    U32 tableLog;
+
+                    CHECK(dctx == NULL, "not enough memory !");
+                    FSE_count(count, &maxSymbolValue, bufferTest, sizeOrig);
+                    errorCode = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+                    CHECK(HUF_isError(errorCode), "HUF_buildCTable failed : %s", HUF_getErrorName(errorCode));
+                    tableLog = (U32)errorCode;
+                    errorCode = HUF_scrambleCTable(CTable, maxSymbolValue, 1);
+                    CHECK(HUF_isError(errorCode), "HUF_scrambleCTable failed : %s", HUF_getErrorName(errorCode));
+                    hSize = HUF_writeLayoutHeader(bufferVerif, bufferDstSize, sizeOrig);
+                    CHECK(HUF_isError(hSize), "HUF_writeLayoutHeader failed : %s", HUF_getErrorName(hSize));
+                    errorCode = HUF_writeCTable(bufferVerif+hSize, bufferDstSize-hSize, CTable, maxSymbolValue, tableLog, 1);
+                    CHECK(HUF_isError(errorCode), "HUF_writeCTable failed : %s", HUF_getErrorName(errorCode));
+                    hSize += errorCode;
+                    cSize = HUF_compress_usingCTable(bufferVerif+hSize, bufferDstSize-hSize, bufferTest, sizeOrig, CTable);
+                    CHECK(HUF_isError(cSize), "HUF_compress_usingCTable failed : %s", HUF_getErrorName(cSize));
+                    CHECK((hSize+cSize != sizeCompressed) || memcmp(bufferVerif, bufferDst, sizeCompressed), "HUF_compress_usingCTable : different from HUF_compress");   /* HUF_compress() may use the pair table */
+
+                    result = HUF_decompress_usingDCtx(dctx, bufferDst, sizeOrig, bufferVerif, sizeCompressed, 1);
+                    CHECK(result != sizeOrig, "HUF_decompress_usingDCtx failed : %s", HUF_getErrorName(result));
+                    CHECK(XXH32(bufferDst, sizeOrig, 0) != hashOrig, "HUF_decompress_usingDCtx : corrupted data");
+
+                    FSE_count(count2, &maxSymbolValue2, sample2, sizeOrig2);
+                    if ((maxSymbolValue2 <= maxSymbolValue) && HUF_validateCTable(CTable, count2, maxSymbolValue2))
+                    {
+                        hSize = HUF_writeLayoutHeader(bufferVerif, bufferDstSize, sizeOrig2);
+                        errorCode = HUF_writeRepeatHeader(bufferVerif+hSize, bufferDstSize-hSize);
+                        CHECK(errorCode != 1, "HUF_writeRepeatHeader failed");
+                        hSize += errorCode;
+                        cSize = HUF_compress_usingCTable(bufferVerif+hSize, bufferDstSize-hSize, sample2, sizeOrig2, CTable);
+                        CHECK(HUF_isError(cSize), "HUF_compress_usingCTable (repeat) failed : %s", HUF_getErrorName(cSize));
+                        if ((cSize != 0) && (hSize + cSize < sizeOrig2 - 1))
+                        {
+                            const BYTE saved = (bufferDst[sizeOrig2] = 253);
+                            CHECK(HUF_estimateCompressedSize(CTable, count2, maxSymbolValue2) > cSize, "HUF_estimateCompressedSize : over estimation");
+                            result = HUF_decompress_usingDCtx(dctx, bufferDst, sizeOrig2, bufferVerif, hSize+cSize, 1);
+                            CHECK(result != sizeOrig2, "HUF_decompress_usingDCtx (repeat) failed : %s", HUF_getErrorName(result));
+                            CHECK(memcmp(bufferDst, sample2, sizeOrig2), "HUF_decompress_usingDCtx (repeat) : corrupted data");
+                            CHECK(bufferDst[sizeOrig2] != saved, "HUF_decompress_usingDCtx (repeat) : bufferDst overflow");
+                            result = HUF_decompress(bufferDst, sizeOrig2, bufferVerif, hSize+cSize, 1);
+                            CHECK(!HUF_isError(result), "HUF_decompress should have failed (repeat block without context)");
+                        }
+                    }
+                }
             }
         }
 
@@ -250,7 +403,7 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
             BYTE saved = (bufferDst[maxDstSize] = 253);
             size_t result;
             DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);;
-            result = HUF_decompress (bufferDst, maxDstSize, bufferTest, sizeCompressed);
+            result = HUF_decompress (bufferDst, maxDstSize, bufferTest, sizeCompressed, 1);
             CHECK(!HUF_isError(result) && (result > maxDstSize), "Decompression overran output buffer");
             CHECK(bufferDst[maxDstSize] != saved, "HUF_decompress noise : bufferDst overflow");
         }
@@ -264,6 +417,7 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
     free (bufferP100);
     free (bufferDst);
     free (bufferVerif);
+    HUF_freeDCtx(dctx);
 }
 
 
@@ -271,6 +425,10 @@ static void FUZ_tests (U32 seed, U32 totalTest, U32 startTestNb)
 *  Unitary tests
 *****************************************************************/
 #define TBSIZE (16 KB)
+/* counting allocator : opaque points to the number of live allocations */
+static void* FUZ_countingAlloc(void* opaque, size_t size) { (*(int*)opaque)++; return malloc(size); }
+static void  FUZ_countingFree(void* opaque, void* address) { (*(int*)opaque)--; free(address); }
+
 static void unitTest(void)
 {
     BYTE* testBuff = (BYTE*)malloc(TBSIZE);
@@ -286,12 +444,425 @@ static void unitTest(void)
         return;
     }
 
-    /* Targeted test 1 */
+    /* block format : HUF_compress() selects 1, 4 or 8 streams, depending on size */
+    {
+        typedef size_t (*decoder_f)(void*, size_t, const void*, size_t, unsigned);
+        static const decoder_f decoders[3][3] = { { HUF_decompress1X2, HUF_decompress1X4, HUF_decompress1X6 },
+                                                  { HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6 },
+                                                  { HUF_decompress8X2, HUF_decompress8X4, HUF_decompress8X6 } };
+        static const decoder_f compactDecoders[3] = { HUF_decompress1XC, HUF_decompress4XC, HUF_decompress8XC };
+        static const U32 nbStreams[3] = { 1, 4, 8 };
+        const size_t testSizes[4] = { HUF_4STREAMS_MINSIZE - 1, HUF_4STREAMS_MINSIZE, HUF_8STREAMS_MINSIZE - 1, HUF_8STREAMS_MINSIZE };
+        U32 seed = 5, testNb = 0, i, t, d;
+        size_t cSize, result;
+
+        for (i=0; i<TBSIZE; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 10);
+        for (t=0; t<4; t++)
+        {
+            const size_t srcSize = testSizes[t];
+            const U32 format = (t+1) / 2;   /* 1, 4, 4, 8 streams */
+            cSize = HUF_compress(cBuff, HUF_COMPRESSBOUND(TBSIZE), testBuff, srcSize, 3);
+            CHECK(HUF_isError(cSize) || (cSize < 2), "HUF_compress() failed");
+            for (d=0; d<3; d++)
+            {
+                memset(verifBuff, 0, srcSize);
+                result = decoders[format][d](verifBuff, srcSize, cBuff, cSize, 3);
+                CHECK(result != srcSize, "HUF_decompress%uX%u() failed : %s", nbStreams[format], 2*d+2, HUF_getErrorName(result));
+                CHECK(memcmp(verifBuff, testBuff, srcSize), "HUF_decompress%uX%u() : corrupted data", nbStreams[format], 2*d+2);
+            }
+            memset(verifBuff, 0, srcSize);
+            result = compactDecoders[format](verifBuff, srcSize, cBuff, cSize, 3);
+            CHECK(result != srcSize, "HUF_decompress%uXC() failed : %s", nbStreams[format], HUF_getErrorName(result));
+            CHECK(memcmp(verifBuff, testBuff, srcSize), "HUF_decompress%uXC() : corrupted data", nbStreams[format]);
+        }
+    }
+
+    /* original 4-streams format, without layout byte : still decoded, whatever the block size */
+    {
+        typedef size_t (*decoder_f)(void*, size_t, const void*, size_t, unsigned);
+        static const decoder_f decoders[5] = { HUF_decompress, HUF_decompressXC, HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6 };
+        HUF_CREATE_STATIC_CTABLE(CTable, 255);
+        const size_t testSizes[4] = { HUF_4STREAMS_MINSIZE - 1, HUF_4STREAMS_MINSIZE, HUF_8STREAMS_MINSIZE, HUF_SMALLBLOCK_MAX };
+        const size_t bufferSize = HUF_SMALLBLOCK_MAX + HUF_INPLACE_MARGIN(HUF_SMALLBLOCK_MAX);
+        BYTE* const origBuff = (BYTE*)malloc(HUF_SMALLBLOCK_MAX);
+        BYTE* const origCBuff = (BYTE*)malloc(HUF_COMPRESSBOUND(HUF_SMALLBLOCK_MAX));
+        BYTE* const origVerif = (BYTE*)malloc(bufferSize);
+        HUF_DCtx* const dctx = HUF_createDCtx();
+        U32 seed = 19, testNb = 0, t, d;
+        size_t i, hSize, cSize, result;
+
+        CHECK((!origBuff) || (!origCBuff) || (!origVerif) || (!dctx), "Not enough memory for original format tests");
+        for (i=0; i<HUF_SMALLBLOCK_MAX; i++) origBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 10);
+        for (t=0; t<4; t++)
+        {
+            const size_t srcSize = testSizes[t];
+            unsigned count[256];
+            unsigned maxSymbolValue = 255;
+            size_t huffLog;
+
+            FSE_count(count, &maxSymbolValue, origBuff, srcSize);
+            huffLog = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+            CHECK(HUF_isError(huffLog), "HUF_buildCTable() failed");
+            hSize = HUF_writeCTable(origCBuff, HUF_COMPRESSBOUND(HUF_SMALLBLOCK_MAX), CTable, maxSymbolValue, (U32)huffLog, 0);
+            CHECK(HUF_isError(hSize), "HUF_writeCTable() failed");
+            cSize = HUF_compress4X_usingCTable(origCBuff+hSize, HUF_COMPRESSBOUND(HUF_SMALLBLOCK_MAX)-hSize, origBuff, srcSize, CTable);
+            CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress4X_usingCTable() failed");
+            cSize += hSize;
+            for (d=0; d<5; d++)
+            {
+                memset(origVerif, 0, srcSize);
+                result = decoders[d](origVerif, srcSize, origCBuff, cSize, 0);
+                CHECK(result != srcSize, "original format : decoder %u failed on %u bytes : %s", d, (U32)srcSize, HUF_getErrorName(result));
+                CHECK(memcmp(origVerif, origBuff, srcSize), "original format : decoder %u : corrupted data on %u bytes", d, (U32)srcSize);
+            }
+            result = HUF_decompress_usingDCtx(dctx, origVerif, srcSize, origCBuff, cSize, 0);
+            CHECK(result != srcSize, "original format : HUF_decompress_usingDCtx() failed on %u bytes", (U32)srcSize);
+            CHECK(memcmp(origVerif, origBuff, srcSize), "original format : HUF_decompress_usingDCtx() : corrupted data");
+            memcpy(origVerif + bufferSize - cSize, origCBuff, cSize);
+            result = HUF_decompress_inPlace(origVerif, bufferSize, srcSize, cSize, 0);
+            CHECK(result != srcSize, "original format : HUF_decompress_inPlace() failed on %u bytes", (U32)srcSize);
+            CHECK(memcmp(origVerif, origBuff, srcSize), "original format : HUF_decompress_inPlace() : corrupted data");
+            if (srcSize < HUF_4STREAMS_MINSIZE)
+            {
+                result = HUF_decompress1X2(origVerif, srcSize, origCBuff, cSize, 0);
+                CHECK(result == srcSize, "original format : HUF_decompress1X2() should not decode 4 streams");
+            }
+            if (srcSize >= HUF_8STREAMS_MINSIZE)
+            {
+                result = HUF_decompress8X2(origVerif, srcSize, origCBuff, cSize, 0);
+                CHECK(result == srcSize, "original format : HUF_decompress8X2() should not decode 4 streams");
+            }
+        }
+        result = HUF_compress4X_usingCTable(origCBuff, HUF_COMPRESSBOUND(HUF_SMALLBLOCK_MAX), origBuff, HUF_SMALLBLOCK_MAX + 1, CTable);
+        CHECK(!HUF_isError(result), "HUF_compress4X_usingCTable() should fail beyond HUF_SMALLBLOCK_MAX");
+        free(origBuff);
+        free(origCBuff);
+        free(origVerif);
+        HUF_freeDCtx(dctx);
+    }
+
+    /* skewed segments : low entropy data, but last segment is noise, into a dst of exactly HUF_compressBound() */
+    {
+        const size_t testSizes[3] = { HUF_8STREAMS_MINSIZE, 64 KB + 3, 200 KB };
+        const size_t guardSize = 64;
+        BYTE* const skewBuff = (BYTE*)malloc(200 KB);
+        BYTE* const skewCBuff = (BYTE*)malloc(HUF_compressBound(200 KB) + guardSize);
+        BYTE* const skewVerif = (BYTE*)malloc(200 KB);
+        U32 seed = 7, testNb = 0, t;
+        size_t i, cSize, result;
+
+        CHECK((!skewBuff) || (!skewCBuff) || (!skewVerif), "Not enough memory for skewed segments tests");
+        for (t=0; t<3; t++)
+        {
+            const size_t srcSize = testSizes[t];
+            const size_t dstSize = HUF_compressBound(srcSize);
+            for (i=0; i<srcSize; i++) skewBuff[i] = (BYTE)((FUZ_rand(&seed) & 1023) ? 0 : FUZ_rand(&seed));
+            generateNoise(skewBuff + srcSize - srcSize/8, srcSize/8, &seed);
+            memset(skewCBuff + dstSize, 0xA5, guardSize);
+            cSize = HUF_compress(skewCBuff, dstSize, skewBuff, srcSize, 0);
+            CHECK(HUF_isError(cSize), "HUF_compress() failed on skewed segments : %s", HUF_getErrorName(cSize));
+            for (i=0; i<guardSize; i++) CHECK(skewCBuff[dstSize+i] != 0xA5, "HUF_compress() w/ skewed segments : dst overflow");
+            CHECK(cSize < 2, "HUF_compress() should compress skewed segments");
+            result = HUF_decompress(skewVerif, srcSize, skewCBuff, cSize, 0);
+            CHECK(result != srcSize, "HUF_decompress() failed on skewed segments : %s", HUF_getErrorName(result));
+            CHECK(memcmp(skewVerif, skewBuff, srcSize), "HUF_decompress() : skewed segments corrupted");
+        }
+        free(skewBuff);
+        free(skewCBuff);
+        free(skewVerif);
+    }
+
+    /* large blocks : 32-bit jump table beyond HUF_SMALLBLOCK_MAX */
+    {
+        typedef size_t (*decoder_f)(void*, size_t, const void*, size_t, unsigned);
+        static const decoder_f decoders[3] = { HUF_decompress8X2, HUF_decompress8X4, HUF_decompress8X6 };
+        const size_t largeSize = 3 MB;
+        const size_t testSizes[3] = { HUF_SMALLBLOCK_MAX, HUF_SMALLBLOCK_MAX + 1, largeSize };
+        const size_t bufferSize = largeSize + HUF_INPLACE_MARGIN(largeSize);
+        BYTE* const largeBuff = (BYTE*)malloc(largeSize);
+        BYTE* const largeCBuff = (BYTE*)malloc(HUF_COMPRESSBOUND(largeSize));
+        BYTE* const largeVerif = (BYTE*)malloc(bufferSize);
+        HUF_DCtx* const dctx = HUF_createDCtx();
+        HUF_ForwardDCtx* const fctx = HUF_createForwardDCtx();
+        U32 seed = 11, testNb = 0, t, d;
+        size_t i, cSize, result;
+
+        CHECK((!largeBuff) || (!largeCBuff) || (!largeVerif) || (!dctx) || (!fctx), "Not enough memory for large block tests");
+        for (i=0; i<largeSize; i++) largeBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 10);
+        result = HUF_compress(largeCBuff, HUF_COMPRESSBOUND(largeSize), largeBuff, (size_t)HUF_BLOCKSIZE_MAX + 1, 0);
+        CHECK(!HUF_isError(result), "HUF_compress() should fail : srcSize > HUF_BLOCKSIZE_MAX");
+        for (t=0; t<3; t++)
+        {
+            const size_t srcSize = testSizes[t];
+            cSize = HUF_compress(largeCBuff, HUF_COMPRESSBOUND(largeSize), largeBuff, srcSize, 5);
+            CHECK(HUF_isError(cSize) || (cSize < 2), "HUF_compress() failed on %u bytes", (U32)srcSize);
+            result = HUF_decompress(largeVerif, srcSize, largeCBuff, cSize, 5);
+            CHECK(result != srcSize, "HUF_decompress() failed on %u bytes : %s", (U32)srcSize, HUF_getErrorName(result));
+            CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompress() : corrupted data on %u bytes", (U32)srcSize);
+            for (d=0; d<3; d++)
+            {
+                memset(largeVerif, 0, srcSize);
+                result = decoders[d](largeVerif, srcSize, largeCBuff, cSize, 5);
+                CHECK(result != srcSize, "HUF_decompress8X%u() failed on %u bytes", 2*d+2, (U32)srcSize);
+                CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompress8X%u() : corrupted data on %u bytes", 2*d+2, (U32)srcSize);
+            }
+            memset(largeVerif, 0, srcSize);
+            result = HUF_decompressXC(largeVerif, srcSize, largeCBuff, cSize, 5);
+            CHECK(result != srcSize, "HUF_decompressXC() failed on %u bytes", (U32)srcSize);
+            CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompressXC() : corrupted data on %u bytes", (U32)srcSize);
+            memset(largeVerif, 0, srcSize);
+            result = HUF_decompress_usingDCtx(dctx, largeVerif, srcSize, largeCBuff, cSize, 5);
+            CHECK(result != srcSize, "HUF_decompress_usingDCtx() failed on %u bytes", (U32)srcSize);
+            CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompress_usingDCtx() : corrupted data on %u bytes", (U32)srcSize);
+            {
+                const size_t inPlaceSize = srcSize + HUF_INPLACE_MARGIN(srcSize);
+                memcpy(largeVerif + inPlaceSize - cSize, largeCBuff, cSize);
+                result = HUF_decompress_inPlace(largeVerif, inPlaceSize, srcSize, cSize, 5);
+                CHECK(result != srcSize, "HUF_decompress_inPlace() failed on %u bytes : %s", (U32)srcSize, HUF_getErrorName(result));
+                CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompress_inPlace() : corrupted data on %u bytes", (U32)srcSize);
+            }
+            {
+                size_t available = 0;
+                memset(largeVerif, 0, srcSize);
+                result = HUF_reverseStreams(largeCBuff, cSize, srcSize);
+                CHECK(result != cSize, "HUF_reverseStreams() failed on %u bytes : %s", (U32)srcSize, HUF_getErrorName(result));
+                result = HUF_initForwardDecoding(fctx, largeVerif, srcSize, cSize, 5);
+                CHECK(HUF_isError(result), "HUF_initForwardDecoding() failed : %s", HUF_getErrorName(result));
+                while (available < cSize)
+                {
+                    available += 1000;
+                    if (available > cSize) available = cSize;
+                    result = HUF_decompressForward_continue(fctx, largeCBuff, available);
+                    CHECK(HUF_isError(result), "HUF_decompressForward_continue() failed on %u bytes : %s", (U32)srcSize, HUF_getErrorName(result));
+                }
+                CHECK(result != srcSize, "HUF_decompressForward_continue() : wrong regenerated size on %u bytes", (U32)srcSize);
+                CHECK(memcmp(largeVerif, largeBuff, srcSize), "HUF_decompressForward_continue() : corrupted data on %u bytes", (U32)srcSize);
+            }
+        }
+
+        HUF_freeDCtx(dctx);
+        HUF_freeForwardDCtx(fctx);
+        free(largeBuff);
+        free(largeCBuff);
+        free(largeVerif);
+    }
+
+    /* deep tree : skewed statistics of a block > HUF_SMALLBLOCK_MAX, unlimited depth far beyond 32 bits of cost */
+    {
+        HUF_CREATE_STATIC_CTABLE(CTable, 255);
+        unsigned count[40];   /* Fibonacci : total 267914295 bytes, unlimited tree 39 levels deep */
+        const size_t srcSize = 1 KB;
+        U32 seed = 0, testNb = 0, s;
+        size_t huffLog, hSize, cSize, result;
+
+        count[0] = 1; count[1] = 1;
+        for (s=2; s<40; s++) count[s] = count[s-1] + count[s-2];
+        huffLog = HUF_buildCTable(CTable, count, 39, 0);
+        CHECK(HUF_isError(huffLog), "HUF_buildCTable() failed on deep tree : %s", HUF_getErrorName(huffLog));
+        hSize = HUF_writeCTable(cBuff, HUF_COMPRESSBOUND(TBSIZE), CTable, 39, (U32)huffLog, 0);
+        CHECK(HUF_isError(hSize), "HUF_writeCTable() failed on deep tree : %s", HUF_getErrorName(hSize));
+        for (s=0; s<srcSize; s++) testBuff[s] = (BYTE)(s % 40);   /* every code, including longest ones */
+        cSize = HUF_compress4X_usingCTable(cBuff + hSize, HUF_COMPRESSBOUND(TBSIZE) - hSize, testBuff, srcSize, CTable);
+        CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress4X_usingCTable() failed on deep tree");
+        result = HUF_decompress4X2(verifBuff, srcSize, cBuff, hSize + cSize, 0);
+        CHECK(result != srcSize, "deep tree : limited code lengths are not a valid tree : %s", HUF_getErrorName(result));
+        CHECK(memcmp(verifBuff, testBuff, srcSize), "deep tree : corrupted data");
+    }
+
+    /* decoder selection : calibration & profile */
+    {
+        BYTE profile[HUF_DECODER_PROFILE_SIZE];
+        BYTE builtin[HUF_DECODER_PROFILE_SIZE];
+        HUF_DCtx* const dctx = HUF_createDCtx();
+        HUF_DCtx* const dctx2 = HUF_createDCtx();
+        U32 seed = 7, testNb = 0, i;
+        size_t cSize, result;
+        const size_t srcSize = 12 KB;
+
+        CHECK((!dctx) || (!dctx2), "Not enough memory for decoder selection tests");
+        result = HUF_saveDecoderProfile(dctx2, builtin, sizeof(builtin));
+        CHECK(result != sizeof(builtin), "HUF_saveDecoderProfile() failed on built-in timings");
+        result = HUF_calibrateDecoders(dctx);
+        CHECK(HUF_isError(result), "HUF_calibrateDecoders() failed : %s", HUF_getErrorName(result));
+        result = HUF_saveDecoderProfile(dctx, profile, sizeof(profile)-1);
+        CHECK(!HUF_isError(result), "HUF_saveDecoderProfile() should fail : dst too small");
+        result = HUF_saveDecoderProfile(dctx, profile, sizeof(profile));
+        CHECK(result != sizeof(profile), "HUF_saveDecoderProfile() failed");
+        result = HUF_loadDecoderProfile(dctx2, profile, sizeof(profile)-1);
+        CHECK(!HUF_isError(result), "HUF_loadDecoderProfile() should fail : profile truncated");
+        profile[1] ^= 1;
+        result = HUF_loadDecoderProfile(dctx2, profile, sizeof(profile));
+        CHECK(!HUF_isError(result), "HUF_loadDecoderProfile() should fail : bad magic");
+        profile[1] ^= 1;
+        result = HUF_loadDecoderProfile(dctx2, profile, sizeof(profile));
+        CHECK(result != sizeof(profile), "HUF_loadDecoderProfile() failed");
+
+        for (i=0; i<srcSize; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 11);
+        cSize = HUF_compress(cBuff, HUF_COMPRESSBOUND(TBSIZE), testBuff, srcSize, 0);
+        CHECK(HUF_isError(cSize) || (cSize < 2), "HUF_compress() failed");
+        result = HUF_decompress_usingDCtx(dctx2, verifBuff, srcSize, cBuff, cSize, 0);
+        CHECK(result != srcSize, "HUF_decompress_usingDCtx() with host profile failed");
+        CHECK(memcmp(verifBuff, testBuff, srcSize), "HUF_decompress_usingDCtx() with host profile : corrupted data");
+
+        /* HUF_decompress() and other DCtx keep built-in timings */
+        HUF_resetDecoderProfile(dctx);
+        result = HUF_saveDecoderProfile(dctx, profile, sizeof(profile));
+        CHECK((result != sizeof(profile)) || memcmp(profile, builtin, sizeof(profile)), "HUF_resetDecoderProfile() : built-in timings not restored");
+        result = HUF_decompress(verifBuff, srcSize, cBuff, cSize, 0);
+        CHECK(result != srcSize, "HUF_decompress() failed");
+        CHECK(memcmp(verifBuff, testBuff, srcSize), "HUF_decompress() : corrupted data");
+
+        HUF_freeDCtx(dctx);
+        HUF_freeDCtx(dctx2);
+    }
+
+    /* table reuse : corner cases */
+    {
+        HUF_CREATE_STATIC_CTABLE(CTable, 255);
+        HUF_DCtx* const dctx = HUF_createDCtx();
+        unsigned count[256];
+        unsigned maxSymbolValue = 255;
+        U32 seed = 9, testNb = 0, i;
+        const size_t srcSize = 4 KB;
+        size_t hSize, cSize, result;
+
+        CHECK(dctx == NULL, "HUF_createDCtx() failed");
+        for (i=0; i<srcSize; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 12);
+        FSE_count(count, &maxSymbolValue, testBuff, srcSize);
+        result = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+        CHECK(HUF_isError(result), "HUF_buildCTable() failed");
+        CHECK(!HUF_validateCTable(CTable, count, maxSymbolValue), "HUF_validateCTable() : table should be valid");
+        {
+            unsigned countLess[256];
+            memcpy(countLess, count, sizeof(countLess));
+            countLess[maxSymbolValue] = 0;
+            result = HUF_buildCTable(CTable, countLess, maxSymbolValue, 0);
+            CHECK(HUF_isError(result), "HUF_buildCTable() failed");
+            CHECK(HUF_validateCTable(CTable, count, maxSymbolValue), "HUF_validateCTable() : symbol without code not detected");
+            result = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+            CHECK(HUF_isError(result), "HUF_buildCTable() failed");
+        }
+
+        hSize = HUF_writeRepeatHeader(cBuff, 1);
+        cSize = HUF_compress_usingCTable(cBuff+hSize, HUF_COMPRESSBOUND(TBSIZE)-hSize, testBuff, srcSize, CTable);
+        CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress_usingCTable() failed");
+        result = HUF_decompress_usingDCtx(dctx, verifBuff, srcSize, cBuff, hSize+cSize, 0);
+        CHECK(!HUF_isError(result), "HUF_decompress_usingDCtx() should fail : repeat block without previous table");
+
+        /* raw block in between keeps previous table */
+        cSize = HUF_compress(cBuff, HUF_COMPRESSBOUND(TBSIZE), testBuff, srcSize, 0);
+        CHECK(HUF_isError(cSize) || (cSize < 2), "HUF_compress() failed");
+        result = HUF_decompress_usingDCtx(dctx, verifBuff, srcSize, cBuff, cSize, 0);
+        CHECK(result != srcSize, "HUF_decompress_usingDCtx() failed");
+        result = HUF_decompress_usingDCtx(dctx, verifBuff, 100, testBuff, 100, 0);
+        CHECK(result != 100, "HUF_decompress_usingDCtx() failed on raw block");
+        hSize = HUF_writeRepeatHeader(cBuff, 1);
+        cSize = HUF_compress_usingCTable(cBuff+hSize, HUF_COMPRESSBOUND(TBSIZE)-hSize, testBuff + 1 KB, srcSize - 1 KB, CTable);
+        CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress_usingCTable() failed");
+        result = HUF_decompress_usingDCtx(dctx, verifBuff, srcSize - 1 KB, cBuff, hSize+cSize, 0);
+        CHECK(result != srcSize - 1 KB, "HUF_decompress_usingDCtx() (repeat) failed : %s", HUF_getErrorName(result));
+        CHECK(memcmp(verifBuff, testBuff + 1 KB, srcSize - 1 KB), "HUF_decompress_usingDCtx() (repeat) : corrupted data");
+
+        HUF_freeDCtx(dctx);
+    }
+
+    /* decoding table cache : identical headers reuse the DCtx table */
+    {
+        HUF_CREATE_STATIC_CTABLE(CTable, 255);
+        HUF_DCtx* const dctx = HUF_createDCtx();
+        unsigned count[256];
+        unsigned maxSymbolValue = 255;
+        U32 seed = 13, testNb = 0, i, scrambler;
+        const size_t srcSize = 8 KB;
+        size_t huffLog, hSize, cSize, result;
+
+        CHECK(dctx == NULL, "HUF_createDCtx() failed");
+        for (i=0; i<srcSize; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 11);
+        FSE_count(count, &maxSymbolValue, testBuff, srcSize);
+        huffLog = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+        CHECK(HUF_isError(huffLog), "HUF_buildCTable() failed");
+        for (scrambler=0; scrambler<2; scrambler++)
+        for (i=0; i<4; i++)
+        {
+            /* same header, different block sizes => decoders selected for a fresh table may differ */
+            const size_t blockSize = srcSize >> i;
+            result = HUF_scrambleCTable(CTable, maxSymbolValue, scrambler);
+            CHECK(HUF_isError(result), "HUF_scrambleCTable() failed");
+            hSize = HUF_writeCTable(cBuff, HUF_COMPRESSBOUND(TBSIZE), CTable, maxSymbolValue, (U32)huffLog, scrambler);
+            CHECK(HUF_isError(hSize), "HUF_writeCTable() failed");
+            cSize = HUF_compress_usingCTable(cBuff+hSize, HUF_COMPRESSBOUND(TBSIZE)-hSize, testBuff + (srcSize - blockSize), blockSize, CTable);
+            CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress_usingCTable() failed");
+            memset(verifBuff, 0, blockSize);
+            result = HUF_decompress_usingDCtx(dctx, verifBuff, blockSize, cBuff, hSize+cSize, scrambler);
+            CHECK(result != blockSize, "HUF_decompress_usingDCtx() (cached table) failed : %s", HUF_getErrorName(result));
+            CHECK(memcmp(verifBuff, testBuff + (srcSize - blockSize), blockSize), "HUF_decompress_usingDCtx() (cached table) : corrupted data");
+        }
+
+        HUF_freeDCtx(dctx);
+    }
+
+    /* keyed codes : same lengths, different assignment, transparent to all decoders */
     {
+        typedef size_t (*decoder_f)(void*, size_t, const void*, size_t, unsigned);
+        static const decoder_f decoders[4] = { HUF_decompress4X2, HUF_decompress4X4, HUF_decompress4X6, HUF_decompress4XC };
+        HUF_CREATE_STATIC_CTABLE(CTable, 255);
+        HUF_CREATE_STATIC_CTABLE(CTableKeyed, 255);
+        unsigned count[256];
+        unsigned maxSymbolValue = 255;
+        U32 seed = 17, testNb = 0, i, d;
+        const size_t srcSize = 8 KB;
+        size_t huffLog, hSize, cSize, result;
+
+        for (i=0; i<srcSize; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 10);
+        FSE_count(count, &maxSymbolValue, testBuff, srcSize);
+        huffLog = HUF_buildCTable(CTable, count, maxSymbolValue, 0);
+        CHECK(HUF_isError(huffLog), "HUF_buildCTable() failed");
+        memcpy(CTableKeyed, CTable, sizeof(CTablehb));
+        result = HUF_scrambleCTable(CTableKeyed, maxSymbolValue, 0x5EED);
+        CHECK(HUF_isError(result), "HUF_scrambleCTable() failed");
+        CHECK(HUF_estimateCompressedSize(CTableKeyed, count, maxSymbolValue) != HUF_estimateCompressedSize(CTable, count, maxSymbolValue),
+              "HUF_scrambleCTable() : code lengths modified");
+        CHECK(!memcmp(CTableKeyed, CTable, sizeof(CTablehb)), "HUF_scrambleCTable() : codes unchanged");
+        hSize = HUF_writeCTable(cBuff, HUF_COMPRESSBOUND(TBSIZE), CTableKeyed, maxSymbolValue, (U32)huffLog, 0x5EED);
+        CHECK(HUF_isError(hSize), "HUF_writeCTable() failed");
+        cSize = HUF_compress_usingCTable(cBuff+hSize, HUF_COMPRESSBOUND(TBSIZE)-hSize, testBuff, srcSize, CTableKeyed);
+        CHECK(HUF_isError(cSize) || (cSize == 0), "HUF_compress_usingCTable() failed");
+        for (d=0; d<4; d++)
+        {
+            memset(verifBuff, 0, srcSize);
+            result = decoders[d](verifBuff, srcSize, cBuff, hSize+cSize, 0x5EED);
+            CHECK(result != srcSize, "keyed codes : decoder %u failed : %s", d, HUF_getErrorName(result));
+            CHECK(memcmp(verifBuff, testBuff, srcSize), "keyed codes : decoder %u : corrupted data", d);
+        }
+        result = HUF_scrambleCTable(CTableKeyed, maxSymbolValue, 0);
+        CHECK(HUF_isError(result), "HUF_scrambleCTable() failed");
+        CHECK(memcmp(CTableKeyed, CTable, sizeof(CTablehb)), "HUF_scrambleCTable() : scrambler 0 should restore canonical codes");
     }
 
-    /* Targeted test 2 */
+    /* custom allocator : contexts are created and released with it */
     {
+        int nbAllocs = 0;
+        FSE_customMem const countingMem = { FUZ_countingAlloc, FUZ_countingFree, &nbAllocs };
+        FSE_customMem const halfMem = { FUZ_countingAlloc, NULL, &nbAllocs };
+        HUF_DCtx* const dctx = HUF_createDCtx_advanced(countingMem);
+        HUF_ForwardDCtx* const fctx = HUF_createForwardDCtx_advanced(countingMem);
+        U32 seed = 23, testNb = 0, i;
+        const size_t srcSize = 8 KB;
+        size_t cSize, result;
+
+        CHECK((dctx == NULL) || (fctx == NULL), "HUF_create*DCtx_advanced() failed");
+        CHECK(nbAllocs != 2, "custom allocator : %i allocations instead of 2", nbAllocs);
+        CHECK(HUF_createDCtx_advanced(halfMem) != NULL, "HUF_createDCtx_advanced() should have failed : customFree missing");
+        CHECK(HUF_createForwardDCtx_advanced(halfMem) != NULL, "HUF_createForwardDCtx_advanced() should have failed : customFree missing");
+        for (i=0; i<srcSize; i++) testBuff[i] = (BYTE)(((FUZ_rand(&seed) & 255) * (FUZ_rand(&seed) & 255)) >> 10);
+        cSize = HUF_compress(cBuff, HUF_COMPRESSBOUND(TBSIZE), testBuff, srcSize, 0);
+        CHECK(HUF_isError(cSize) || (cSize < 2), "HUF_compress() failed");
+        result = HUF_decompress_usingDCtx(dctx, verifBuff, srcSize, cBuff, cSize, 0);
+        CHECK(result != srcSize, "HUF_decompress_usingDCtx() failed with custom allocator : %s", HUF_getErrorName(result));
+        CHECK(memcmp(verifBuff, testBuff, srcSize), "HUF_decompress_usingDCtx() : corrupted data");
+        HUF_freeDCtx(dctx);
+        HUF_freeForwardDCtx(fctx);
+        CHECK(nbAllocs != 0, "custom allocator : %i allocations not released", nbAllocs);
     }
 
     free(testBuff);
@@ -40,6 +40,7 @@
 #include <sys/timeb.h> /* timeb */
 #include "fse.h"       /* FSE_isError */
 #include "fseU16.h"
+#include "fseDist.h"
 #include "xxhash.h"
 
 
@@ -155,6 +156,8 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
     void* bufferDst  =        malloc (bufferDstSize);
     U16* bufferVerif = (U16*) malloc (bufferDstSize);
     unsigned testNb;
+    U16* bufferLarge = (U16*) malloc (bufferDstSize);
+    FSE_U16ctx* const ctx = FSE_createU16ctx(FSE_U16_SYMBOL_VALUE_LIMIT, 0);
     const size_t maxTestSizeMask = 0x1FFFF;
     U32 time = FUZ_GetMilliStart();
     U32 seed = startSeed;
@@ -173,7 +176,9 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
         U16* bufferTest;
         int tag=0;
         U32 roundSeed = seed ^ 0xEDA5B371;
+        unsigned scrambler;
         FUZ_rand(&seed);
+        scrambler = FUZ_rand(&roundSeed) & 255;
 
         DISPLAYLEVEL (4, "\r test %5u      ", testNb);
         if (FUZ_GetMilliSpan (time) > FUZ_UPDATERATE)
@@ -192,7 +197,7 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
 
             DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
             hashOrig = XXH64 (bufferTest, sizeOrig * sizeof(U16), 0);
-            sizeCompressed = FSE_compressU16 (bufferDst, bufferDstSize, bufferTest, sizeOrig, FSE_MAX_SYMBOL_VALUE, 12);
+            sizeCompressed = FSE_compressU16 (bufferDst, bufferDstSize, bufferTest, sizeOrig, FSE_MAX_SYMBOL_VALUE, 12, scrambler);
             CHECK(FSE_isError(sizeCompressed), "\r test %5u : FSE_compressU16 failed !", testNb);
             if (sizeCompressed > 1)   /* don't check uncompressed & rle corner cases */
             {
@@ -203,7 +208,7 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
 
                 /* basic decompression test : should work */
                 DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
-                result = FSE_decompressU16 (bufferVerif, sizeOrig, bufferDst, sizeCompressed);
+                result = FSE_decompressU16 (bufferVerif, sizeOrig, bufferDst, sizeCompressed, scrambler);
                 CHECK(bufferVerif[sizeOrig] != saved, "\r test %5u : FSE_decompressU16 overrun output buffer (write beyond specified end) !", testNb);
                 CHECK(FSE_isError(result), "\r test %5u : FSE_decompressU16 failed : %s ! (origSize = %u shorts, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
                 hashEnd = XXH64 (bufferVerif, result * sizeof(U16), 0);
@@ -211,7 +216,7 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
 
                 /* larger output buffer than necessary : should work */
                 DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
-                result = FSE_decompressU16 (bufferVerif, sizeOrig + (FUZ_rand(&roundSeed) & 31) + 1, bufferDst, sizeCompressed);
+                result = FSE_decompressU16 (bufferVerif, sizeOrig + (FUZ_rand(&roundSeed) & 31) + 1, bufferDst, sizeCompressed, scrambler);
                 CHECK(FSE_isError(result), "\r test %5u : FSE_decompressU16 failed : %s ! (origSize = %u shorts, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
                 hashEnd = XXH64 (bufferVerif, result * sizeof(U16), 0);
                 CHECK(hashEnd != hashOrig, "\r test %5u : Decompressed data corrupted !!", testNb);
@@ -222,14 +227,162 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
                 if (dstSize >= sizeOrig) dstSize = 1;
                 dstSize = sizeOrig - dstSize;
                 saved = (bufferVerif[dstSize] = 1024 + 250);
-                result = FSE_decompressU16 (bufferVerif, dstSize, bufferDst, sizeCompressed);
+                result = FSE_decompressU16 (bufferVerif, dstSize, bufferDst, sizeCompressed, scrambler);
                 CHECK(bufferVerif[dstSize] != saved, "\r test %5u : FSE_decompressU16 overrun output buffer (write beyond specified end) !", testNb);
                 CHECK(!FSE_isError(result), "\r test %5u : FSE_decompressU16 should have failed ! (origSize = %u shorts, dstSize = %u bytes)", testNb, (U32)sizeOrig, (U32)dstSize);
             }
         }
+
+        /* 4-states format */
+        {
+            size_t sizeOrig = (FUZ_rand (&roundSeed) & maxTestSizeMask) + 1;
+            size_t offset = (FUZ_rand(&roundSeed) % (BUFFERSIZE - 64 - maxTestSizeMask));
+            size_t sizeCompressed;
+            U64 hashOrig;
+            bufferTest = bufferP8 + offset;
+
+            DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+            hashOrig = XXH64 (bufferTest, sizeOrig * sizeof(U16), 0);
+            sizeCompressed = FSE_compressU16X4 (bufferDst, bufferDstSize, bufferTest, sizeOrig, FSE_MAX_SYMBOL_VALUE, 12, scrambler);
+            CHECK(FSE_isError(sizeCompressed), "\r test %5u : FSE_compressU16X4 failed !", testNb);
+            if (sizeCompressed > 1)   /* don't check uncompressed & rle corner cases */
+            {
+                U64 hashEnd;
+                U16 saved = (bufferVerif[sizeOrig] = 1024 + 250);
+                size_t dstSize;
+                size_t result;
+
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                result = FSE_decompressU16X4 (bufferVerif, sizeOrig, bufferDst, sizeCompressed, scrambler);
+                CHECK(bufferVerif[sizeOrig] != saved, "\r test %5u : FSE_decompressU16X4 overrun output buffer (write beyond specified end) !", testNb);
+                CHECK(FSE_isError(result), "\r test %5u : FSE_decompressU16X4 failed : %s ! (origSize = %u shorts, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
+                hashEnd = XXH64 (bufferVerif, result * sizeof(U16), 0);
+                CHECK(hashEnd != hashOrig, "\r test %5u : Decompressed data corrupted !!", testNb);
+
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                result = FSE_decompressU16X4 (bufferVerif, sizeOrig + (FUZ_rand(&roundSeed) & 31) + 1, bufferDst, sizeCompressed, scrambler);
+                CHECK(FSE_isError(result), "\r test %5u : FSE_decompressU16X4 failed : %s ! (origSize = %u shorts, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
+                hashEnd = XXH64 (bufferVerif, result * sizeof(U16), 0);
+                CHECK(hashEnd != hashOrig, "\r test %5u : Decompressed data corrupted !!", testNb);
+
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                dstSize = (FUZ_rand(&roundSeed) & 31) + 1;
+                if (dstSize >= sizeOrig) dstSize = 1;
+                dstSize = sizeOrig - dstSize;
+                saved = (bufferVerif[dstSize] = 1024 + 250);
+                result = FSE_decompressU16X4 (bufferVerif, dstSize, bufferDst, sizeCompressed, scrambler);
+                CHECK(bufferVerif[dstSize] != saved, "\r test %5u : FSE_decompressU16X4 overrun output buffer (write beyond specified end) !", testNb);
+                CHECK(!FSE_isError(result), "\r test %5u : FSE_decompressU16X4 should have failed ! (origSize = %u shorts, dstSize = %u bytes)", testNb, (U32)sizeOrig, (U32)dstSize);
+            }
+        }
+
+        /* large alphabet context : symbols spread over [0-4095], sparse or dense */
+        {
+            size_t sizeOrig = (FUZ_rand (&roundSeed) & maxTestSizeMask) + 1;
+            size_t offset = (FUZ_rand(&roundSeed) % (BUFFERSIZE - 64 - maxTestSizeMask));
+            const U32 noiseMask = (FUZ_rand(&roundSeed) & 1) ? 7 : 0;
+            const unsigned tableLog = 9 + (FUZ_rand(&roundSeed) % 6);
+            size_t sizeCompressed;
+            size_t i;
+            U64 hashOrig;
+            CHECK(ctx==NULL, "\r test %5u : FSE_createU16ctx failed !", testNb);
+            for (i=0; i<sizeOrig; i++)
+                bufferLarge[i] = (U16)(bufferP8[offset+i] * 14 + (FUZ_rand(&roundSeed) & noiseMask));
+
+            DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+            hashOrig = XXH64 (bufferLarge, sizeOrig * sizeof(U16), 0);
+            sizeCompressed = FSE_compressU16_usingCtx (ctx, bufferDst, bufferDstSize, bufferLarge, sizeOrig, tableLog, scrambler);
+            CHECK(FSE_isError(sizeCompressed), "\r test %5u : FSE_compressU16_usingCtx failed : %s !", testNb, FSE_getErrorName(sizeCompressed));
+            if (sizeCompressed > 1)   /* don't check uncompressed & rle corner cases */
+            {
+                U64 hashEnd;
+                U16 saved = (bufferVerif[sizeOrig] = 1024 + 250);
+                size_t dstSize;
+                size_t result;
+
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                result = FSE_decompressU16_usingCtx (ctx, bufferVerif, sizeOrig, bufferDst, sizeCompressed, scrambler);
+                CHECK(bufferVerif[sizeOrig] != saved, "\r test %5u : FSE_decompressU16_usingCtx overrun output buffer (write beyond specified end) !", testNb);
+                CHECK(FSE_isError(result), "\r test %5u : FSE_decompressU16_usingCtx failed : %s ! (origSize = %u shorts, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
+                hashEnd = XXH64 (bufferVerif, result * sizeof(U16), 0);
+                CHECK(hashEnd != hashOrig, "\r test %5u : Decompressed data corrupted !!", testNb);
+
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                dstSize = (FUZ_rand(&roundSeed) & 31) + 1;
+                if (dstSize >= sizeOrig) dstSize = 1;
+                dstSize = sizeOrig - dstSize;
+                saved = (bufferVerif[dstSize] = 1024 + 250);
+                result = FSE_decompressU16_usingCtx (ctx, bufferVerif, dstSize, bufferDst, sizeCompressed, scrambler);
+                CHECK(bufferVerif[dstSize] != saved, "\r test %5u : FSE_decompressU16_usingCtx overrun output buffer (write beyond specified end) !", testNb);
+                CHECK(!FSE_isError(result), "\r test %5u : FSE_decompressU16_usingCtx should have failed ! (origSize = %u shorts, dstSize = %u bytes)", testNb, (U32)sizeOrig, (U32)dstSize);
+            }
+        }
+
+        /* FSED : log-bucket integer coder, on U16 or U32 values */
+        {
+            size_t sizeOrig = (FUZ_rand (&roundSeed) & maxTestSizeMask) + 1;
+            size_t offset = (FUZ_rand(&roundSeed) % (BUFFERSIZE - 64 - maxTestSizeMask));
+            const U32 isU32 = FUZ_rand(&roundSeed) & 1;
+            const unsigned maxLN = isU32 ? FSED_LN_MAX_U32 : FSED_LN_MAX_U16;
+            const unsigned LN = (FUZ_rand(&roundSeed) & 1) ? FSED_LN_AUTO : FUZ_rand(&roundSeed) % (maxLN+1);
+            const U32 shift = FUZ_rand(&roundSeed) % (isU32 ? 23 : 8);
+            const unsigned tableLog = FUZ_rand(&roundSeed) % (FSED_MAX_TABLELOG+1);
+            U16* const src16 = bufferLarge;
+            U32* const src32 = (U32*)bufferLarge;
+            size_t sizeCompressed, result;
+            size_t i;
+            U64 hashOrig, hashEnd;
+
+            for (i=0; i<sizeOrig; i++)
+            {
+                const U32 v = (bufferP8[offset+i] << shift) + (FUZ_rand(&roundSeed) & ((1U<<shift)-1));
+                if (isU32) src32[i] = v; else src16[i] = (U16)v;
+            }
+
+            DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+            hashOrig = XXH64 (bufferLarge, sizeOrig * (isU32 ? 4 : 2), 0);
+            sizeCompressed = isU32 ? FSED_compressU32_advanced(bufferDst, bufferDstSize, src32, sizeOrig, tableLog, LN)
+                                   : FSED_compressU16_advanced(bufferDst, bufferDstSize, src16, sizeOrig, tableLog, LN);
+            CHECK(FSE_isError(sizeCompressed), "\r test %5u : FSED_compressU%u_advanced failed : %s !", testNb, isU32 ? 32 : 16, FSE_getErrorName(sizeCompressed));
+            CHECK(sizeCompressed > FSED_COMPRESSBOUND(sizeOrig, isU32 ? 4 : 2), "\r test %5u : FSED_compress result beyond bound !", testNb);
+
+            DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+            ((BYTE*)bufferVerif)[sizeOrig * (isU32 ? 4 : 2)] = 253;
+            result = isU32 ? FSED_decompressU32((U32*)bufferVerif, sizeOrig, bufferDst, sizeCompressed)
+                           : FSED_decompressU16(bufferVerif, sizeOrig, bufferDst, sizeCompressed);
+            CHECK(((BYTE*)bufferVerif)[sizeOrig * (isU32 ? 4 : 2)] != 253, "\r test %5u : FSED_decompress overrun output buffer !", testNb);
+            CHECK(result != sizeOrig, "\r test %5u : FSED_decompress failed : %s ! (origSize = %u values, cSize = %u bytes)", testNb, FSE_getErrorName(result), (U32)sizeOrig, (U32)sizeCompressed);
+            hashEnd = XXH64 (bufferVerif, sizeOrig * (isU32 ? 4 : 2), 0);
+            CHECK(hashEnd != hashOrig, "\r test %5u : FSED : Decompressed data corrupted !!", testNb);
+
+            /* output too small : must fail, without overrun */
+            if (sizeOrig > 1)
+            {
+                const size_t dstSize = sizeOrig - 1 - (FUZ_rand(&roundSeed) % (sizeOrig-1));
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                ((BYTE*)bufferVerif)[dstSize * (isU32 ? 4 : 2)] = 253;
+                result = isU32 ? FSED_decompressU32((U32*)bufferVerif, dstSize, bufferDst, sizeCompressed)
+                               : FSED_decompressU16(bufferVerif, dstSize, bufferDst, sizeCompressed);
+                CHECK(((BYTE*)bufferVerif)[dstSize * (isU32 ? 4 : 2)] != 253, "\r test %5u : FSED_decompress overrun output buffer !", testNb);
+                CHECK(!FSE_isError(result), "\r test %5u : FSED_decompress should have failed ! (origSize = %u values, dstSize = %u values)", testNb, (U32)sizeOrig, (U32)dstSize);
+            }
+
+            /* compression buffer too small : must fail or fall back, without overrun */
+            {
+                const size_t maxDstSize = FUZ_rand(&roundSeed) % (sizeCompressed+1);
+                DISPLAYLEVEL (4,"\b\b\b\b%3i ", tag++);
+                ((BYTE*)bufferDst)[maxDstSize] = 253;
+                result = isU32 ? FSED_compressU32_advanced(bufferDst, maxDstSize, src32, sizeOrig, tableLog, LN)
+                               : FSED_compressU16_advanced(bufferDst, maxDstSize, src16, sizeOrig, tableLog, LN);
+                CHECK(((BYTE*)bufferDst)[maxDstSize] != 253, "\r test %5u : FSED_compress overrun output buffer !", testNb);
+                CHECK(!FSE_isError(result) && (result > maxDstSize), "\r test %5u : FSED_compress result larger than buffer !", testNb);
+            }
+        }
     }
 
     /* clean */
+    FSE_freeU16ctx(ctx);
+    free (bufferLarge);
     free (bufferP8);
     free (bufferDst);
     free (bufferVerif);
@@ -240,9 +393,11 @@ static void FUZ_tests (const U32 startSeed, U32 totalTest, U32 startTestNb)
 *  Unitary tests
 *****************************************************************/
 
-extern size_t FSE_countU16(unsigned* count, unsigned* maxSymbolValuePtr, const unsigned short* source, size_t sourceSize);
-
 #define TBSIZE (16 KB)
+/* counting allocator : opaque points to the number of live allocations */
+static void* FUZ_countingAlloc(void* opaque, size_t size) { (*(int*)opaque)++; return malloc(size); }
+static void  FUZ_countingFree(void* opaque, void* address) { (*(int*)opaque)--; free(address); }
+
 static void unitTest(void)
 {
     U16  testBuffU16[TBSIZE];
@@ -267,6 +422,202 @@ static void unitTest(void)
         max = FSE_MAX_SYMBOL_VALUE-1;
         errorCode = FSE_countU16(table, &max, testBuffU16, TBSIZE);
         CHECK(!FSE_isError(errorCode), "FSE_countU16() should have failed : max too low");
+
+        for (i=0; i< TBSIZE; i++) testBuffU16[i] = (U16)((i * i) % 211);
+        max = FSE_MAX_SYMBOL_VALUE;
+        errorCode = FSE_countU16(table, &max, testBuffU16, TBSIZE-3);   /* odd size : tail path */
+        CHECK(FSE_isError(errorCode), "FSE_countU16() should have worked");
+        {
+            U32 naive[FSE_MAX_SYMBOL_VALUE+1] = { 0 };
+            for (i=0; i< TBSIZE-3; i++) naive[testBuffU16[i]]++;
+            for (i=0; i<=max; i++) CHECK(naive[i] != table[i], "FSE_countU16() : wrong count for symbol %u", i);
+        }
+
+        testBuffU16[TBSIZE/2] = 0x8000 | 5;   /* must be detected, even with a high bit set */
+        max = FSE_MAX_SYMBOL_VALUE;
+        errorCode = FSE_countU16(table, &max, testBuffU16, TBSIZE);
+        CHECK(!FSE_isError(errorCode), "FSE_countU16() should have failed : symbol too large");
+    }
+
+    /* table re-use : U16 advanced functions */
+    {
+        static U16 verifU16[TBSIZE];
+        static BYTE cBuff[2][TBSIZE * sizeof(U16) + 64];
+        size_t cSize[2];
+        unsigned count[FSE_MAX_SYMBOL_VALUE+1];
+        short norm[FSE_MAX_SYMBOL_VALUE+1];
+        unsigned max = FSE_MAX_SYMBOL_VALUE, tableLog = 11, fmt, b;
+        FSE_CTable* const ct = FSE_createCTable(tableLog, FSE_MAX_SYMBOL_VALUE);
+        FSE_DTable* const dt = FSE_createDTableU16(tableLog);
+        const unsigned scrambler = 7;
+        U32 i;
+
+        CHECK((ct==NULL) || (dt==NULL), "table allocation failed");
+        for (i=0; i<TBSIZE; i++) testBuffU16[i] = (U16)((i * i) % 211);
+        errorCode = FSE_countU16(count, &max, testBuffU16, TBSIZE);
+        CHECK(FSE_isError(errorCode), "FSE_countU16() failed");
+        errorCode = FSE_normalizeCount(norm, tableLog, count, TBSIZE, max);
+        CHECK(FSE_isError(errorCode), "FSE_normalizeCount() failed");
+        errorCode = FSE_buildCTableU16(ct, norm, max, tableLog, scrambler);
+        CHECK(FSE_isError(errorCode), "FSE_buildCTableU16() failed");
+        errorCode = FSE_buildDTableU16(dt, norm, max, tableLog, scrambler);
+        CHECK(FSE_isError(errorCode), "FSE_buildDTableU16() failed");
+
+        for (fmt=0; fmt<2; fmt++)
+        {
+            /* 2 blocks, same tables */
+            for (b=0; b<2; b++)
+            {
+                const U16* const src = testBuffU16 + b*(TBSIZE/2);
+                cSize[b] = fmt ? FSE_compressU16X4_usingCTable(cBuff[b], sizeof(cBuff[b]), src, TBSIZE/2, ct)
+                               : FSE_compressU16_usingCTable  (cBuff[b], sizeof(cBuff[b]), src, TBSIZE/2, ct);
+                CHECK(FSE_isError(cSize[b]) || (cSize[b]==0), "FSE_compressU16%s_usingCTable() failed", fmt ? "X4" : "");
+            }
+            for (b=0; b<2; b++)
+            {
+                errorCode = fmt ? FSE_decompressU16X4_usingDTable(verifU16, TBSIZE/2, cBuff[b], cSize[b], dt)
+                                : FSE_decompressU16_usingDTable  (verifU16, TBSIZE/2, cBuff[b], cSize[b], dt);
+                CHECK(errorCode != TBSIZE/2, "FSE_decompressU16%s_usingDTable() failed", fmt ? "X4" : "");
+                CHECK(memcmp(verifU16, testBuffU16 + b*(TBSIZE/2), (TBSIZE/2) * sizeof(U16)), "FSE_decompressU16%s_usingDTable() : corrupted data", fmt ? "X4" : "");
+            }
+        }
+
+        /* tiny skewed inputs : last symbols may not consume any bit */
+        for (i=2; i<64; i++)
+        {
+            U32 n, seed = i;
+            for (n=0; n<i; n++) testBuffU16[n] = (U16)((FUZ_rand(&seed) & 7) == 0);
+            testBuffU16[0] = 0; testBuffU16[1] = 1;
+            cSize[0] = FSE_compressU16(cBuff[0], sizeof(cBuff[0]), testBuffU16, i, 0, 0, scrambler);
+            CHECK(FSE_isError(cSize[0]), "FSE_compressU16() failed");
+            if (cSize[0] < 2) continue;
+            errorCode = FSE_decompressU16(verifU16, TBSIZE, cBuff[0], cSize[0], scrambler);
+            CHECK(errorCode != i, "FSE_decompressU16() : wrong size for tiny input (%u instead of %u)", (U32)errorCode, i);
+            CHECK(memcmp(verifU16, testBuffU16, i * sizeof(U16)), "FSE_decompressU16() : corrupted tiny input");
+        }
+
+        FSE_freeCTable(ct);
+        FSE_freeDTableU16(dt);
+    }
+
+    /* FSE_U16ctx */
+    {
+        static U16 verifU16[TBSIZE];
+        static BYTE cBuff[TBSIZE * sizeof(U16) + 64];
+        FSE_U16ctx* ctx;
+        size_t cSize;
+        U32 i, seed = 1;
+
+        CHECK(FSE_createU16ctx(FSE_U16_SYMBOL_VALUE_LIMIT+1, 0) != NULL, "FSE_createU16ctx() should have failed : maxSymbolValue too large");
+        CHECK(FSE_createU16ctx(FSE_U16_SYMBOL_VALUE_LIMIT, FSE_U16_TABLELOG_LIMIT+1) != NULL, "FSE_createU16ctx() should have failed : maxTableLog too large");
+
+        /* dense 4096-symbols alphabet, skewed */
+        for (i=0; i<TBSIZE; i++) testBuffU16[i] = (U16)((FUZ_rand(&seed) & 4095) >> (FUZ_rand(&seed) & 3));
+        ctx = FSE_createU16ctx(FSE_U16_SYMBOL_VALUE_LIMIT, 0);
+        CHECK(ctx==NULL, "FSE_createU16ctx() failed");
+        cSize = FSE_compressU16_usingCtx(ctx, cBuff, sizeof(cBuff), testBuffU16, TBSIZE, FSE_U16_TABLELOG_LIMIT, 1);
+        CHECK(FSE_isError(cSize) || (cSize < 2), "FSE_compressU16_usingCtx() should have compressed a dense large alphabet");
+        errorCode = FSE_decompressU16_usingCtx(ctx, verifU16, TBSIZE, cBuff, cSize, 1);
+        CHECK(errorCode != TBSIZE, "FSE_decompressU16_usingCtx() failed");
+        CHECK(memcmp(verifU16, testBuffU16, sizeof(verifU16)), "FSE_decompressU16_usingCtx() : corrupted data");
+        FSE_freeU16ctx(ctx);
+
+        /* within one-shot limits, context output is compatible with FSE_decompressU16X4() */
+        for (i=0; i<TBSIZE; i++) testBuffU16[i] = (U16)((i * i) % 211);
+        ctx = FSE_createU16ctx(FSE_MAX_SYMBOL_VALUE, 12);
+        CHECK(ctx==NULL, "FSE_createU16ctx() failed");
+        cSize = FSE_compressU16_usingCtx(ctx, cBuff, sizeof(cBuff), testBuffU16, TBSIZE, 12, 1);
+        CHECK(FSE_isError(cSize) || (cSize < 2), "FSE_compressU16_usingCtx() failed");
+        errorCode = FSE_decompressU16X4(verifU16, TBSIZE, cBuff, cSize, 1);
+        CHECK(errorCode != TBSIZE, "FSE_decompressU16X4() failed to decode FSE_compressU16_usingCtx() output");
+        CHECK(memcmp(verifU16, testBuffU16, sizeof(verifU16)), "FSE_decompressU16X4() : corrupted data");
+        FSE_freeU16ctx(ctx);
+
+        /* custom allocator : context is created and released with it */
+        {
+            int nbAllocs = 0;
+            FSE_customMem const countingMem = { FUZ_countingAlloc, FUZ_countingFree, &nbAllocs };
+            ctx = FSE_createU16ctx_advanced(FSE_U16_SYMBOL_VALUE_LIMIT, 0, countingMem);
+            CHECK(ctx==NULL, "FSE_createU16ctx_advanced() failed");
+            CHECK(nbAllocs != 1, "FSE_createU16ctx_advanced() : custom allocator not used");
+            cSize = FSE_compressU16_usingCtx(ctx, cBuff, sizeof(cBuff), testBuffU16, TBSIZE, 0, 1);
+            CHECK(FSE_isError(cSize) || (cSize < 2), "FSE_compressU16_usingCtx() failed with custom allocator");
+            errorCode = FSE_decompressU16_usingCtx(ctx, verifU16, TBSIZE, cBuff, cSize, 1);
+            CHECK(errorCode != TBSIZE, "FSE_decompressU16_usingCtx() failed with custom allocator");
+            CHECK(memcmp(verifU16, testBuffU16, sizeof(verifU16)), "FSE_decompressU16_usingCtx() : corrupted data");
+            FSE_freeU16ctx(ctx);
+            CHECK(nbAllocs != 0, "FSE_freeU16ctx() : custom allocation not released");
+        }
+    }
+
+    /* FSED */
+    {
+        static U32 testBuffU32[TBSIZE];
+        static U32 verifU32[TBSIZE];
+        static U16 verifU16[TBSIZE];
+        static BYTE cBuff[TBSIZE * sizeof(U32) + 64];
+        size_t cSize;
+        U32 i, seed = 3;
+
+        for (i=0; i<TBSIZE; i++) testBuffU32[i] = FUZ_rand(&seed) >> (FUZ_rand(&seed) & 31);
+        cSize = FSED_compressU32(cBuff, sizeof(cBuff), testBuffU32, TBSIZE, 0);
+        CHECK(FSE_isError(cSize) || (cSize >= FSED_COMPRESSBOUND(TBSIZE, 4)), "FSED_compressU32() should have compressed log-distributed values");
+        errorCode = FSED_decompressU32(verifU32, TBSIZE, cBuff, cSize);
+        CHECK(errorCode != TBSIZE, "FSED_decompressU32() failed");
+        CHECK(memcmp(verifU32, testBuffU32, sizeof(verifU32)), "FSED_decompressU32() : corrupted data");
+        errorCode = FSED_decompressU32(verifU32, TBSIZE, cBuff, cSize-1);
+        CHECK(!FSE_isError(errorCode), "FSED_decompressU32() should have failed : truncated input");
+
+        /* single bucket : only extra bits */
+        for (i=0; i<TBSIZE; i++) testBuffU16[i] = (U16)(0x4000 + (FUZ_rand(&seed) & 0x3FF));
+        cSize = FSED_compressU16_advanced(cBuff, sizeof(cBuff), testBuffU16, TBSIZE, 0, 4);
+        CHECK(FSE_isError(cSize) || (cSize >= FSED_COMPRESSBOUND(TBSIZE, 2)), "FSED_compressU16_advanced() failed on single bucket");
+        errorCode = FSED_decompressU16(verifU16, TBSIZE, cBuff, cSize);
+        CHECK(errorCode != TBSIZE, "FSED_decompressU16() failed on single bucket");
+        CHECK(memcmp(verifU16, testBuffU16, sizeof(verifU16)), "FSED_decompressU16() : corrupted single bucket");
+
+        /* all identical */
+        for (i=0; i<TBSIZE; i++) testBuffU16[i] = 5;
+        cSize = FSED_compressU16(cBuff, sizeof(cBuff), testBuffU16, TBSIZE, 0);
+        CHECK(cSize != 2, "FSED_compressU16() : identical values should cost 2 bytes");
+        errorCode = FSED_decompressU16(verifU16, TBSIZE, cBuff, cSize);
+        CHECK(errorCode != TBSIZE, "FSED_decompressU16() failed on identical values");
+        CHECK(memcmp(verifU16, testBuffU16, sizeof(verifU16)), "FSED_decompressU16() : corrupted identical values");
+
+        /* automatic LN : close to the best fixed LN */
+        {
+            U32 fmt;
+            for (fmt=0; fmt<2; fmt++)
+            {
+                size_t best = (size_t)-1;
+                U32 LN;
+                for (i=0; i<TBSIZE; i++)
+                    testBuffU32[i] = fmt ? (FUZ_rand(&seed) & 0xFFFFF) : (U32)(1000.0 / (1 + (FUZ_rand(&seed) & 1023)));
+                for (LN=0; LN<=FSED_LN_MAX_U32; LN++)
+                {
+                    cSize = FSED_compressU32_advanced(cBuff, sizeof(cBuff), testBuffU32, TBSIZE, 0, LN);
+                    CHECK(FSE_isError(cSize), "FSED_compressU32_advanced() failed");
+                    if (cSize < best) best = cSize;
+                }
+                cSize = FSED_compressU32_advanced(cBuff, sizeof(cBuff), testBuffU32, TBSIZE, 0, FSED_LN_AUTO);
+                CHECK(FSE_isError(cSize), "FSED_compressU32_advanced() failed with FSED_LN_AUTO");
+                CHECK(cSize > best + best/50, "FSED_LN_AUTO : %u bytes, while best LN gives %u bytes", (U32)cSize, (U32)best);
+                errorCode = FSED_decompressU32(verifU32, TBSIZE, cBuff, cSize);
+                CHECK(errorCode != TBSIZE, "FSED_decompressU32() failed");
+                CHECK(memcmp(verifU32, testBuffU32, sizeof(verifU32)), "FSED_decompressU32() : corrupted data");
+            }
+        }
+
+        /* parameters */
+        errorCode = FSED_compressU32_advanced(cBuff, sizeof(cBuff), testBuffU32, TBSIZE, 0, FSED_LN_MAX_U32+1);
+        CHECK(!FSE_isError(errorCode), "FSED_compressU32_advanced() should have failed : LN too large");
+        errorCode = FSED_compressU16(cBuff, sizeof(cBuff), testBuffU16, TBSIZE, FSED_MAX_TABLELOG+1);
+        CHECK(!FSE_isError(errorCode), "FSED_compressU16() should have failed : tableLog too large");
+        errorCode = FSED_compressU16(cBuff, 8, testBuffU16+1, 10, 0);
+        CHECK(!FSE_isError(errorCode) && (errorCode > 8), "FSED_compressU16() wrote beyond buffer");
+        cBuff[0] = 0xE2;   /* reserved bits set */
+        errorCode = FSED_decompressU16(verifU16, TBSIZE, cBuff, 64);
+        CHECK(!FSE_isError(errorCode), "FSED_decompressU16() should have failed : reserved header bits");
     }
 
     DISPLAY("Unit tests completed\n");
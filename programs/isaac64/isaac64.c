@@ -11,10 +11,6 @@ By Bob Jenkins, 1996.  Public Domain.
 #include "isaac64.h"
 #endif
 
-extern    ub8 randrsl[RANDSIZ], randcnt;
-static    ub8 mm[RANDSIZ];
-static    ub8 aa = 0, bb = 0, cc = 0;
-
 #define ind(mm,x)  (*(ub8 *)((ub1 *)(mm) + ((x) & ((RANDSIZ-1)<<3))))
 #define rngstep(mix,a,b,mm,m,m2,r,x) \
 { \
@@ -24,11 +20,12 @@ static    ub8 aa = 0, bb = 0, cc = 0;
 	*(r++) = b = ind(mm, y >> RANDSIZL) + x; \
 }
 
-void isaac64()
+void isaac64(randctx* ctx)
 {
 	register ub8 a, b, x, y, *m, *m2, *r, *mend;
-	m = mm; r = randrsl;
-	a = aa; b = bb + (++cc);
+	ub8* const mm = ctx->mm;
+	m = mm; r = ctx->randrsl;
+	a = ctx->aa; b = ctx->bb + (++ctx->cc);
 	for (m = mm, mend = m2 = m + (RANDSIZ / 2); m < mend;)
 	{
 		rngstep(~(a ^ (a << 21)), a, b, mm, m, m2, r, x);
@@ -43,7 +40,7 @@ void isaac64()
 		rngstep(a ^ (a << 12), a, b, mm, m, m2, r, x);
 		rngstep(a ^ (a >> 33), a, b, mm, m, m2, r, x);
 	}
-	bb = b; aa = a;
+	ctx->bb = b; ctx->aa = a;
 }
 
 #define mix(a,b,c,d,e,f,g,h) \
@@ -58,11 +55,13 @@ void isaac64()
 	h -= d; e ^= g << 14; g += h; \
 }
 
-void randinit(word flag)
+void randinit(randctx* ctx, word flag)
 {
 	word i;
 	ub8 a, b, c, d, e, f, g, h;
-	aa = bb = cc = (ub8)0;
+	ub8* const mm = ctx->mm;
+	ub8* const randrsl = ctx->randrsl;
+	ctx->aa = ctx->bb = ctx->cc = (ub8)0;
 	a = b = c = d = e = f = g = h = 0x9e3779b97f4a7c13LL;  /* the golden ratio */
 
 	for (i = 0; i < 4; ++i)                    /* scramble it */
@@ -94,19 +93,19 @@ void randinit(word flag)
 		}
 	}
 
-	isaac64();          /* fill in the first set of results */
-	randcnt = RANDSIZ;    /* prepare to use the first set of results */
+	isaac64(ctx);          /* fill in the first set of results */
+	ctx->randcnt = RANDSIZ;    /* prepare to use the first set of results */
 }
 
-ub8 getNumber64(){
-	randinit(TRUE);
-	isaac64();
-	return randrsl[0];
+ub8 getNumber64(randctx* ctx){
+	randinit(ctx, TRUE);
+	isaac64(ctx);
+	return ctx->randrsl[0];
 }
 
-ub8 getNumber64ForPassword(word word){
-	randinit(word);
-	isaac64();
-	return randrsl[0];
+ub8 getNumber64ForPassword(randctx* ctx, word word){
+	randinit(ctx, word);
+	isaac64(ctx);
+	return ctx->randrsl[0];
 }
 
@@ -14,29 +14,39 @@ Bob Jenkins, 1996, Public Domain
 #define RANDSIZL   (8)
 #define RANDSIZ    (1<<RANDSIZL)
 
-ub8 randrsl[RANDSIZ], randcnt;
+/*
+------------------------------------------------------------------------------
+Generator state. One context per thread : no state is shared between them.
+Zero-initialise a context before its first use.
+------------------------------------------------------------------------------
+*/
+typedef struct
+{
+	ub8 randrsl[RANDSIZ], randcnt;
+	ub8 mm[RANDSIZ];
+	ub8 aa, bb, cc;
+} randctx;
 
 /*
 ------------------------------------------------------------------------------
-If (flag==TRUE), then use the contents of randrsl[0..255] as the seed.
+If (flag==TRUE), then use the contents of r->randrsl[0..255] as the seed.
 ------------------------------------------------------------------------------
 */
-void randinit(/*_ word flag _*/);
-void randinit(word flag);
+void randinit(randctx* r, word flag);
 
-void isaac64();
+void isaac64(randctx* r);
 
-ub8 getNumber64();
-ub8 getNumber64ForPassword(word Word);
+ub8 getNumber64(randctx* r);
+ub8 getNumber64ForPassword(randctx* r, word Word);
 
 
 /*
 ------------------------------------------------------------------------------
-Call rand() to retrieve a single 64-bit random value
+Call rand(r) to retrieve a single 64-bit random value
 ------------------------------------------------------------------------------
 */
-#define rand() \
-	(!randcnt-- ? (isaac64(), randcnt = RANDSIZ - 1, randrsl[randcnt]) : \
-	randrsl[randcnt])
+#define rand(r) \
+	(!(r)->randcnt-- ? (isaac64(r), (r)->randcnt = RANDSIZ - 1, (r)->randrsl[(r)->randcnt]) : \
+	(r)->randrsl[(r)->randcnt])
 
 #endif  /* RAND */
@@ -41,6 +41,7 @@ You can contact the author at :
 #include <stdlib.h>
 #include "error.h"
 #include "zstd_static.h"
+#include "zstd_internal.h"   /* ZSTD_malloc, ZSTD_free, BLOCKSIZE, MIN */
 #include "zstd_buffered_static.h"
 
 
@@ -82,6 +83,7 @@ typedef enum { ZBUFFcs_init, ZBUFFcs_load, ZBUFFcs_flush } ZBUFF_cStage;
 /* *** Ressources *** */
 struct ZBUFF_CCtx_s {
 	ZSTD_CCtx* zc;
+	ZSTD_customMem customMem;
 	char* inBuff;
 	size_t inBuffSize;
 	size_t inToCompress;
@@ -95,30 +97,38 @@ struct ZBUFF_CCtx_s {
 	ZBUFF_cStage stage;
 };   /* typedef'd tp ZBUFF_CCtx within "zstd_buffered.h" */
 
-ZBUFF_CCtx* ZBUFF_createCCtx(void)
+ZBUFF_CCtx* ZBUFF_createCCtx_advanced(ZSTD_customMem customMem)
 {
-	ZBUFF_CCtx* zbc = (ZBUFF_CCtx*)malloc(sizeof(ZBUFF_CCtx));
+	ZBUFF_CCtx* zbc;
+	if (ZSTD_validateCustomMem(&customMem)) return NULL;
+	zbc = (ZBUFF_CCtx*)ZSTD_malloc(sizeof(ZBUFF_CCtx), customMem);
 	if (zbc == NULL) return NULL;
 	memset(zbc, 0, sizeof(*zbc));
-	zbc->zc = ZSTD_createCCtx();
+	zbc->customMem = customMem;
+	zbc->zc = ZSTD_createCCtx_advanced(customMem);
+	if (zbc->zc == NULL) { ZSTD_free(zbc, customMem); return NULL; }
 	return zbc;
 }
 
+ZBUFF_CCtx* ZBUFF_createCCtx(void)
+{
+	ZSTD_customMem const defaultMem = { NULL, NULL, NULL };
+	return ZBUFF_createCCtx_advanced(defaultMem);
+}
+
 size_t ZBUFF_freeCCtx(ZBUFF_CCtx* zbc)
 {
 	if (zbc == NULL) return 0;   /* support free on NULL */
 	ZSTD_freeCCtx(zbc->zc);
-	free(zbc->inBuff);
-	free(zbc->outBuff);
-	free(zbc);
+	ZSTD_free(zbc->inBuff, zbc->customMem);
+	ZSTD_free(zbc->outBuff, zbc->customMem);
+	ZSTD_free(zbc, zbc->customMem);
 	return 0;
 }
 
 
 /* *** Initialization *** */
 
-#define MIN(a,b)    ( ((a)<(b)) ? (a) : (b) )
-#define BLOCKSIZE   (128 * 1024)   /* a bit too "magic", should come from reference */
 size_t ZBUFF_compressInit_advanced(ZBUFF_CCtx* zbc, ZSTD_parameters params)
 {
 	size_t neededInBuffSize;
@@ -130,16 +140,16 @@ size_t ZBUFF_compressInit_advanced(ZBUFF_CCtx* zbc, ZSTD_parameters params)
 	if (zbc->inBuffSize < neededInBuffSize)
 	{
 		zbc->inBuffSize = neededInBuffSize;
-		free(zbc->inBuff);   /* should not be necessary */
-		zbc->inBuff = (char*)malloc(neededInBuffSize);
+		ZSTD_free(zbc->inBuff, zbc->customMem);   /* should not be necessary */
+		zbc->inBuff = (char*)ZSTD_malloc(neededInBuffSize, zbc->customMem);
 		if (zbc->inBuff == NULL) return 1;// ERROR(memory_allocation);
 	}
 	zbc->blockSize = MIN(BLOCKSIZE, zbc->inBuffSize);
 	if (zbc->outBuffSize < ZSTD_compressBound(zbc->blockSize) + 1)
 	{
 		zbc->outBuffSize = ZSTD_compressBound(zbc->blockSize) + 1;
-		free(zbc->outBuff);   /* should not be necessary */
-		zbc->outBuff = (char*)malloc(zbc->outBuffSize);
+		ZSTD_free(zbc->outBuff, zbc->customMem);   /* should not be necessary */
+		zbc->outBuff = (char*)ZSTD_malloc(zbc->outBuffSize, zbc->customMem);
 		if (zbc->outBuff == NULL) return 1;// ERROR(memory_allocation);
 	}
 
@@ -347,26 +357,37 @@ struct ZBUFF_DCtx_s {
 	size_t dictSize;
 	ZBUFF_dStage stage;
 	unsigned char headerBuffer[ZSTD_frameHeaderSize_max];
+	ZSTD_customMem customMem;
 };   /* typedef'd to ZBUFF_DCtx within "zstd_buffered.h" */
 
 
-ZBUFF_DCtx* ZBUFF_createDCtx(void)
+ZBUFF_DCtx* ZBUFF_createDCtx_advanced(ZSTD_customMem customMem)
 {
-	ZBUFF_DCtx* zbc = (ZBUFF_DCtx*)malloc(sizeof(ZBUFF_DCtx));
+	ZBUFF_DCtx* zbc;
+	if (ZSTD_validateCustomMem(&customMem)) return NULL;
+	zbc = (ZBUFF_DCtx*)ZSTD_malloc(sizeof(ZBUFF_DCtx), customMem);
 	if (zbc == NULL) return NULL;
 	memset(zbc, 0, sizeof(*zbc));
-	zbc->zc = ZSTD_createDCtx();
+	zbc->customMem = customMem;
+	zbc->zc = ZSTD_createDCtx_advanced(customMem);
+	if (zbc->zc == NULL) { ZSTD_free(zbc, customMem); return NULL; }
 	zbc->stage = ZBUFFds_init;
 	return zbc;
 }
 
+ZBUFF_DCtx* ZBUFF_createDCtx(void)
+{
+	ZSTD_customMem const defaultMem = { NULL, NULL, NULL };
+	return ZBUFF_createDCtx_advanced(defaultMem);
+}
+
 size_t ZBUFF_freeDCtx(ZBUFF_DCtx* zbc)
 {
 	if (zbc == NULL) return 0;   /* support free on null */
 	ZSTD_freeDCtx(zbc->zc);
-	free(zbc->inBuff);
-	free(zbc->outBuff);
-	free(zbc);
+	ZSTD_free(zbc->inBuff, zbc->customMem);
+	ZSTD_free(zbc->outBuff, zbc->customMem);
+	ZSTD_free(zbc, zbc->customMem);
 	return 0;
 }
 
@@ -453,16 +474,16 @@ size_t ZBUFF_decompressContinue(ZBUFF_DCtx* zbc, void* dst, size_t* maxDstSizePt
 									 size_t neededInSize = BLOCKSIZE;   /* a block is never > BLOCKSIZE */
 									 if (zbc->inBuffSize < neededInSize)
 									 {
-										 free(zbc->inBuff);
+										 ZSTD_free(zbc->inBuff, zbc->customMem);
 										 zbc->inBuffSize = neededInSize;
-										 zbc->inBuff = (char*)malloc(neededInSize);
+										 zbc->inBuff = (char*)ZSTD_malloc(neededInSize, zbc->customMem);
 										 if (zbc->inBuff == NULL) return 1;//ERROR(memory_allocation);
 									 }
 									 if (zbc->outBuffSize < neededOutSize)
 									 {
-										 free(zbc->outBuff);
+										 ZSTD_free(zbc->outBuff, zbc->customMem);
 										 zbc->outBuffSize = neededOutSize;
-										 zbc->outBuff = (char*)malloc(neededOutSize);
+										 zbc->outBuff = (char*)ZSTD_malloc(neededOutSize, zbc->customMem);
 										 if (zbc->outBuff == NULL) return 1;// ERROR(memory_allocation);
 									 }
 		}
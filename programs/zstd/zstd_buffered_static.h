@@ -54,6 +54,13 @@ extern "C" {
 	***************************************/
 	ZSTDLIB_API size_t ZBUFF_compressInit_advanced(ZBUFF_CCtx* cctx, ZSTD_parameters params);
 
+	/** ZBUFF_createCCtx_advanced, ZBUFF_createDCtx_advanced
+	*   Same as ZBUFF_createCCtx() / ZBUFF_createDCtx(), but all memory, including internal buffers
+	*   and the underlying ZSTD context, is obtained from customMem.
+	*   The matching ZBUFF_free*Ctx() releases it through the same allocator. */
+	ZSTDLIB_API ZBUFF_CCtx* ZBUFF_createCCtx_advanced(ZSTD_customMem customMem);
+	ZSTDLIB_API ZBUFF_DCtx* ZBUFF_createDCtx_advanced(ZSTD_customMem customMem);
+
 
 #if defined (__cplusplus)
 }
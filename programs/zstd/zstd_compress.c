@@ -113,6 +113,8 @@ struct ZSTD_CCtx_s
 	void* workSpace;
 	size_t workSpaceSize;
 	size_t blockSize;
+	unsigned scrambler;     /* literals scrambler, applied to Huff0 tables */
+	ZSTD_customMem customMem;
 
 	seqStore_t seqStore;    /* sequences storage ptrs */
 	U32* hashTable;
@@ -120,15 +122,30 @@ struct ZSTD_CCtx_s
 };
 
 
+ZSTD_CCtx* ZSTD_createCCtx_advanced(ZSTD_customMem customMem)
+{
+	ZSTD_CCtx* cctx;
+	if (ZSTD_validateCustomMem(&customMem)) return NULL;
+	cctx = (ZSTD_CCtx*)ZSTD_malloc(sizeof(ZSTD_CCtx), customMem);
+	if (cctx == NULL) return NULL;
+	memset(cctx, 0, sizeof(ZSTD_CCtx));
+	cctx->customMem = customMem;
+	return cctx;
+}
+
 ZSTD_CCtx* ZSTD_createCCtx(void)
 {
-	return (ZSTD_CCtx*)calloc(1, sizeof(ZSTD_CCtx));
+	ZSTD_customMem const defaultMem = { NULL, NULL, NULL };
+	return ZSTD_createCCtx_advanced(defaultMem);
 }
 
 size_t ZSTD_freeCCtx(ZSTD_CCtx* cctx)
 {
-	free(cctx->workSpace);
-	free(cctx);
+	ZSTD_customMem customMem;
+	if (cctx == NULL) return 0;   /* support free on NULL */
+	customMem = cctx->customMem;
+	ZSTD_free(cctx->workSpace, customMem);
+	ZSTD_free(cctx, customMem);
 	return 0;
 }
 
@@ -180,9 +197,9 @@ static size_t ZSTD_resetCCtx_advanced(ZSTD_CCtx* zc,
 		const size_t neededSpace = tableSpace + (3 * blockSize);
 		if (zc->workSpaceSize < neededSpace)
 		{
-			free(zc->workSpace);
+			ZSTD_free(zc->workSpace, zc->customMem);
 			zc->workSpaceSize = neededSpace;
-			zc->workSpace = malloc(neededSpace);
+			zc->workSpace = ZSTD_malloc(neededSpace, zc->customMem);
 			if (zc->workSpace == NULL) return 1;// ERROR(memory_allocation);
 		}
 		memset(zc->workSpace, 0, tableSpace);
@@ -277,10 +294,8 @@ static size_t ZSTD_compressRleLiteralsBlock(void* dst, size_t maxDstSize, const
 
 size_t ZSTD_minGain(size_t srcSize) { return (srcSize >> 6) + 1; }
 
-static unsigned scramblerValue = 0;
-
 static size_t ZSTD_compressLiterals(void* dst, size_t maxDstSize,
-	const void* src, size_t srcSize)
+	const void* src, size_t srcSize, unsigned scrambler)
 {
 	const size_t minGain = ZSTD_minGain(srcSize);
 	BYTE* const ostart = (BYTE*)dst;
@@ -289,7 +304,7 @@ static size_t ZSTD_compressLiterals(void* dst, size_t maxDstSize,
 
 	if (maxDstSize < litHeaderSize + 1) return ERROR(dstSize_tooSmall);   /* not enough space for compression */
 
-	hsize = HUF_compress(ostart + litHeaderSize, maxDstSize - litHeaderSize, src, srcSize, scramblerValue);
+	hsize = HUF_compress(ostart + litHeaderSize, maxDstSize - litHeaderSize, src, srcSize, scrambler);
 
 	if ((hsize == 0) || (hsize >= srcSize - minGain)) return ZSTD_noCompressLiterals(dst, maxDstSize, src, srcSize);
 	if (hsize == 1) return ZSTD_compressRleLiteralsBlock(dst, maxDstSize, src, srcSize);
@@ -312,7 +327,7 @@ static size_t ZSTD_compressLiterals(void* dst, size_t maxDstSize,
 
 size_t ZSTD_compressSequences(void* dst, size_t maxDstSize,
 	const seqStore_t* seqStorePtr,
-	size_t srcSize)
+	size_t srcSize, unsigned scrambler)
 {
 	U32 count[MaxSeq + 1];
 	S16 norm[MaxSeq + 1];
@@ -346,7 +361,7 @@ size_t ZSTD_compressSequences(void* dst, size_t maxDstSize,
 		if (litSize <= LITERAL_NOENTROPY)
 			cSize = ZSTD_noCompressLiterals(op, maxDstSize, op_lit_start, litSize);
 		else
-			cSize = ZSTD_compressLiterals(op, maxDstSize, op_lit_start, litSize);
+			cSize = ZSTD_compressLiterals(op, maxDstSize, op_lit_start, litSize, scrambler);
 		if (ZSTD_isError(cSize)) return cSize;
 		op += cSize;
 	}
@@ -848,7 +863,7 @@ const U32 mls)
 
 	/* Finale compression stage */
 	return ZSTD_compressSequences(dst, maxDstSize,
-		seqStorePtr, srcSize);
+		seqStorePtr, srcSize, zc->scrambler);
 }
 
 
@@ -991,7 +1006,7 @@ size_t ZSTD_compressBlock_fast_extDict_generic(ZSTD_CCtx* ctx,
 
 	/* Finale compression stage */
 	return ZSTD_compressSequences(dst, maxDstSize,
-		seqStorePtr, srcSize);
+		seqStorePtr, srcSize, ctx->scrambler);
 }
 
 
@@ -1687,7 +1702,7 @@ const U32 searchMethod, const U32 depth)
 
 	/* Final compression stage */
 	return ZSTD_compressSequences(dst, maxDstSize,
-		seqStorePtr, srcSize);
+		seqStorePtr, srcSize, ctx->scrambler);
 }
 
 size_t ZSTD_compressBlock_btlazy2(ZSTD_CCtx* ctx, void* dst, size_t maxDstSize, const void* src, size_t srcSize)
@@ -1906,7 +1921,7 @@ const U32 searchMethod, const U32 depth)
 
 	/* Final compression stage */
 	return ZSTD_compressSequences(dst, maxDstSize,
-		seqStorePtr, srcSize);
+		seqStorePtr, srcSize, ctx->scrambler);
 }
 
 size_t ZSTD_compressBlock_greedy_extDict(ZSTD_CCtx* ctx, void* dst, size_t maxDstSize, const void* src, size_t srcSize)
@@ -2007,7 +2022,7 @@ size_t ZSTD_compressContinue(ZSTD_CCtx* zc,
 	const void* src, size_t srcSize, unsigned scrambler)
 {
 	const BYTE* const ip = (const BYTE*)src;
-	//scramblerValue = scrambler; nie dziaa dekodowanie w ZSTD
+	//zc->scrambler = scrambler; nie dziaa dekodowanie w ZSTD
 	/* Check if blocks follow each other */
 	if (src != zc->nextSrc)
 	{
@@ -2201,8 +2216,9 @@ size_t ZSTD_compress(void* dst, size_t maxDstSize, const void* src, size_t srcSi
 	size_t result;
 	ZSTD_CCtx ctxBody;
 	memset(&ctxBody, 0, sizeof(ctxBody));
+	ZSTD_validateCustomMem(&ctxBody.customMem);   /* default allocator */
 	result = ZSTD_compressCCtx(&ctxBody, dst, maxDstSize, src, srcSize, compressionLevel);
-	free(ctxBody.workSpace);   /* can't free ctxBody, since it's on stack; free heap content */
+	ZSTD_free(ctxBody.workSpace, ctxBody.customMem);   /* can't free ctxBody, since it's on stack; free heap content */
 	return result;
 }
 
@@ -143,6 +143,8 @@ struct ZSTD_DCtx_s
 	size_t litSize;
 	BYTE litBuffer[BLOCKSIZE + 8 /* margin for wildcopy */];
 	BYTE headerBuffer[ZSTD_frameHeaderSize_max];
+	unsigned scrambler;     /* literals scrambler, must match the one used by the compressor */
+	ZSTD_customMem customMem;
 };  /* typedef'd to ZSTD_DCtx within "zstd_static.h" */
 
 size_t ZSTD_resetDCtx(ZSTD_DCtx* dctx)
@@ -153,20 +155,31 @@ size_t ZSTD_resetDCtx(ZSTD_DCtx* dctx)
 	dctx->base = NULL;
 	dctx->vBase = NULL;
 	dctx->dictEnd = NULL;
+	dctx->scrambler = 0;
 	return 0;
 }
 
-ZSTD_DCtx* ZSTD_createDCtx(void)
+ZSTD_DCtx* ZSTD_createDCtx_advanced(ZSTD_customMem customMem)
 {
-	ZSTD_DCtx* dctx = (ZSTD_DCtx*)malloc(sizeof(ZSTD_DCtx));
+	ZSTD_DCtx* dctx;
+	if (ZSTD_validateCustomMem(&customMem)) return NULL;
+	dctx = (ZSTD_DCtx*)ZSTD_malloc(sizeof(ZSTD_DCtx), customMem);
 	if (dctx == NULL) return NULL;
+	dctx->customMem = customMem;
 	ZSTD_resetDCtx(dctx);
 	return dctx;
 }
 
+ZSTD_DCtx* ZSTD_createDCtx(void)
+{
+	ZSTD_customMem const defaultMem = { NULL, NULL, NULL };
+	return ZSTD_createDCtx_advanced(defaultMem);
+}
+
 size_t ZSTD_freeDCtx(ZSTD_DCtx* dctx)
 {
-	free(dctx);
+	if (dctx == NULL) return 0;   /* support free on NULL */
+	ZSTD_free(dctx, dctx->customMem);
 	return 0;
 }
 
@@ -241,12 +254,10 @@ static size_t ZSTD_copyRawBlock(void* dst, size_t maxDstSize, const void* src, s
 	return srcSize;
 }
 
-static unsigned scramblerValue = 0;
-
 /** ZSTD_decompressLiterals
 @return : nb of bytes read from src, or an error code*/
 static size_t ZSTD_decompressLiterals(void* dst, size_t* maxDstSizePtr,
-	const void* src, size_t srcSize)
+	const void* src, size_t srcSize, unsigned scrambler)
 {
 	const BYTE* ip = (const BYTE*)src;
 
@@ -256,7 +267,7 @@ static size_t ZSTD_decompressLiterals(void* dst, size_t* maxDstSizePtr,
 	if (litSize > *maxDstSizePtr) return ERROR(corruption_detected);
 	if (litCSize + 5 > srcSize) return ERROR(corruption_detected);
 
-	if (HUF_isError(HUF_decompress(dst, litSize, ip + 5, litCSize, scramblerValue))) return ERROR(corruption_detected);
+	if (HUF_isError(HUF_decompress(dst, litSize, ip + 5, litCSize, scrambler))) return ERROR(corruption_detected);
 
 	*maxDstSizePtr = litSize;
 	return litCSize + 5;
@@ -279,7 +290,7 @@ size_t ZSTD_decodeLiteralsBlock(ZSTD_DCtx* dctx,
 	case 0:
 	{
 			  size_t litSize = BLOCKSIZE;
-			  const size_t readSize = ZSTD_decompressLiterals(dctx->litBuffer, &litSize, src, srcSize);
+			  const size_t readSize = ZSTD_decompressLiterals(dctx->litBuffer, &litSize, src, srcSize, dctx->scrambler);
 			  dctx->litPtr = dctx->litBuffer;
 			  dctx->litBufSize = BLOCKSIZE + 8;
 			  dctx->litSize = litSize;
@@ -788,7 +799,7 @@ size_t ZSTD_nextSrcSizeToDecompress(ZSTD_DCtx* dctx)
 
 size_t ZSTD_decompressContinue(ZSTD_DCtx* ctx, void* dst, size_t maxDstSize, const void* src, size_t srcSize, unsigned scrambler)
 {
-	//scramblerValue = scrambler; nie dziaa dekodowanie w ZSTD
+	//ctx->scrambler = scrambler; nie dziaa dekodowanie w ZSTD
 	/* Sanity check */
 	if (srcSize != ctx->expected) return ERROR(srcSize_wrong);
 	if (dst != ctx->previousDstEnd)   /* not contiguous */
@@ -40,8 +40,10 @@ extern "C" {
 	/* *************************************
 	*  Includes
 	***************************************/
+#include <stdlib.h>   /* malloc, free */
 #include "mem.h"
 #include "error.h"
+#include "zstd_static.h"   /* ZSTD_customMem */
 
 
 	/* *************************************
@@ -51,6 +53,38 @@ extern "C" {
 #define MAX(a,b) ((a)>(b) ? (a) : (b))
 
 
+	/* *************************************
+	*  Memory allocation
+	***************************************/
+	MEM_STATIC void* ZSTD_defaultAllocFunction(void* opaque, size_t size) { (void)opaque; return malloc(size); }
+	MEM_STATIC void  ZSTD_defaultFreeFunction(void* opaque, void* address) { (void)opaque; free(address); }
+
+	/** ZSTD_validateCustomMem
+	*   fills default allocator when none is provided.
+	*   @return : 0 if valid, 1 if only one of customAlloc / customFree is set */
+	MEM_STATIC unsigned ZSTD_validateCustomMem(ZSTD_customMem* customMem)
+	{
+		if ((customMem->customAlloc == NULL) && (customMem->customFree == NULL))
+		{
+			customMem->customAlloc = ZSTD_defaultAllocFunction;
+			customMem->customFree = ZSTD_defaultFreeFunction;
+			customMem->opaque = NULL;
+			return 0;
+		}
+		return (customMem->customAlloc == NULL) || (customMem->customFree == NULL);
+	}
+
+	MEM_STATIC void* ZSTD_malloc(size_t size, ZSTD_customMem customMem)
+	{
+		return customMem.customAlloc(customMem.opaque, size);
+	}
+
+	MEM_STATIC void ZSTD_free(void* ptr, ZSTD_customMem customMem)
+	{
+		if (ptr != NULL) customMem.customFree(customMem.opaque, ptr);
+	}
+
+
 	/* *************************************
 	*  Common constants
 	***************************************/
@@ -99,12 +133,12 @@ extern "C" {
 	/* ******************************************
 	*  Shared functions to include for inlining
 	********************************************/
-	static void ZSTD_copy8(void* dst, const void* src) { memcpy(dst, src, 8); }
+	MEM_STATIC void ZSTD_copy8(void* dst, const void* src) { memcpy(dst, src, 8); }
 
 #define COPY8(d,s) { ZSTD_copy8(d,s); d+=8; s+=8; }
 
 	/*! ZSTD_wildcopy : custom version of memcpy(), can copy up to 7-8 bytes too many */
-	static void ZSTD_wildcopy(void* dst, const void* src, size_t length)
+	MEM_STATIC void ZSTD_wildcopy(void* dst, const void* src, size_t length)
 	{
 		const BYTE* ip = (const BYTE*)src;
 		BYTE* op = (BYTE*)dst;
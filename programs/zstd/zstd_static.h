@@ -78,10 +78,23 @@ extern "C" {
 		ZSTD_strategy strategy;
 	} ZSTD_parameters;
 
+	/** Custom memory allocation
+	*   customAlloc() must return memory suitably aligned for any type, like malloc().
+	*   Set both functions to NULL to use the default malloc() / free(). */
+	typedef void* (*ZSTD_allocFunction) (void* opaque, size_t size);
+	typedef void  (*ZSTD_freeFunction) (void* opaque, void* address);
+	typedef struct { ZSTD_allocFunction customAlloc; ZSTD_freeFunction customFree; void* opaque; } ZSTD_customMem;
+
 
 	/* *************************************
 	*  Advanced functions
 	***************************************/
+	/** ZSTD_createCCtx_advanced
+	*   Same as ZSTD_createCCtx(), but all memory (context and work space) is obtained from customMem.
+	*   ZSTD_freeCCtx() releases it through the same allocator.
+	*   @return : NULL if allocation failed, or if only one of customAlloc / customFree is provided */
+	ZSTDLIB_API ZSTD_CCtx* ZSTD_createCCtx_advanced(ZSTD_customMem customMem);
+
 	/** ZSTD_getParams
 	*   return ZSTD_parameters structure for a selected compression level and srcSize.
 	*   srcSizeHint value is optional, select 0 if not known */
@@ -111,6 +124,7 @@ extern "C" {
 	/** Decompression context management */
 	typedef struct ZSTD_DCtx_s ZSTD_DCtx;
 	ZSTDLIB_API ZSTD_DCtx* ZSTD_createDCtx(void);
+	ZSTDLIB_API ZSTD_DCtx* ZSTD_createDCtx_advanced(ZSTD_customMem customMem);   /* see ZSTD_createCCtx_advanced() */
 	ZSTDLIB_API size_t     ZSTD_freeDCtx(ZSTD_DCtx* dctx);
 
 	/** ZSTD_decompressDCtx